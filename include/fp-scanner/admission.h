@@ -0,0 +1,115 @@
+//==============================================================================================================|
+// File Desc:
+//  Admission control for bulk transfers (the CMD_DATA downloads behind Read_Attendance_Record and the user
+//  reads). A transfer is let through only when there's room for it under the global and its subnet's
+//  concurrency limits and byte rate budgets; the rest wait their turn in order of arrival, so a site uplink
+//  carries a few transfers at full speed instead of every device at once timing out. Short commands never
+//  come through here. The driver waits for admission before it disables the device, so a queued device
+//  keeps serving its users.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "basics.h"
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define ADM_TIMEOUT_MS          60000       // default longest wait to be let in
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  Admission limits; a 0 means no limit. Byte rates are enforced as token buckets that hold up to one
+ *  second's worth; a transfer is charged its full size up front, thus a big one holds back those after it
+ *  until the bucket has paid for it.
+ */
+typedef struct Admission_Config_Struct
+{
+    u32 max_global{0};          // transfers running at once across the fleet
+    u32 max_per_subnet{0};      // transfers running at once within a subnet
+    u64 global_bps{0};          // bytes per second across the fleet
+    u64 subnet_bps{0};          // bytes per second within a subnet
+    u32 subnet_prefix{24};      // IPv4 prefix length that makes up a subnet
+    u32 timeout_ms{ADM_TIMEOUT_MS};     // longest a transfer waits to be let in; 0 waits for ever
+} Adm_Config;
+
+
+
+
+/**
+ * @brief
+ *  Admission counters
+ */
+typedef struct Admission_Stats_Struct
+{
+    u32 running{0};             // transfers let in and not yet done
+    u32 waiting{0};             // transfers waiting their turn
+    u64 admitted{0};            // transfers let in so far
+    u64 bytes{0};               // and their sizes added up
+    u64 timeouts{0};            // transfers that gave up waiting
+    u64 wait_ms{0};             // time spent waiting, added up
+} Adm_Stats;
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief
+ *  A scoped admission; waits to be let in when made and gives the slot back when it goes out of scope.
+ */
+class Adm_Ticket
+{
+public:
+
+    Adm_Ticket(const std::string &ip, const u32 bytes);
+    ~Adm_Ticket();
+
+    Adm_Ticket(const Adm_Ticket &) = delete;
+    Adm_Ticket &operator=(const Adm_Ticket &) = delete;
+
+    bool Is_Admitted() const;
+
+private:
+
+    std::string subnet;         // where we were let in
+    bool badmitted;             // true when let in
+};
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+void Adm_Configure(const Adm_Config &config);
+int Adm_Acquire(const std::string &ip, const u32 bytes, std::string &subnet);
+void Adm_Release(const std::string &subnet);
+void Adm_Get_Stats(Adm_Stats *pstats);
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,143 @@
+//==============================================================================================================|
+// File Desc:
+//  A compressed archive format for attendance history. Punches are written in blocks; within a block every
+//  field is a column of fixed width bit packed values, the times stored as deltas of deltas, users as codes
+//  into a dictionary that grows with the archive (a block carries the entries it first uses), devices as
+//  offsets from the block minimum and the verify fields in as few bits as they need. Each block header carries
+//  the block's time range, thus a reader after a time window skips whole blocks without decoding them, and a
+//  CRC over the block.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "punch.h"
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define ARC_FILE_MAGIC          0x5241525a  // "ZRAR" at the head of the file
+#define ARC_BLOCK_MAGIC         0x4b4c4241  // "ABLK" at the head of every block
+#define ARC_BLOCK_SIZE          8192        // punches per block by default
+#define ARC_MAX_BLOCK           65536       // most punches in a block
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  Archive counters
+ */
+typedef struct Arc_Stats_Struct
+{
+    u64 punches{0};             // punches written or read
+    u64 blocks{0};              // blocks written or decoded
+    u64 skipped{0};             // blocks skipped for being out of the time window
+    u64 bytes{0};               // archive bytes written or read
+    u64 users{0};               // dictionary entries
+} Arc_Stats;
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes an archive one block at a time; punches are buffered until a block is full. Blocks compress best
+ *  with punches in time order, but any order is kept as given.
+ */
+class Arc_Writer
+{
+public:
+
+    Arc_Writer();
+    ~Arc_Writer();
+
+    Arc_Writer(const Arc_Writer &) = delete;
+    Arc_Writer &operator=(const Arc_Writer &) = delete;
+
+    int Open(const std::string &path, const bool bappend=false, const u32 block_size=ARC_BLOCK_SIZE);
+    int Append(const Punch_Record &punch);
+    int Append(const std::vector<Punch_Record> &punches);
+    int Flush();
+    int Close();
+    Arc_Stats Get_Stats() const;
+
+private:
+
+    int fd;
+    u32 block_size;
+    std::vector<Punch_Record> pending;              // the block being filled
+    std::unordered_map<std::string, u32> dict;      // user id and serial : code
+    std::vector<u8> buf;                            // the block being encoded
+    Arc_Stats stats;
+
+    int Write_Block();
+};
+
+
+
+
+/**
+ * @brief
+ *  Reads an archive back one block at a time, in the order written.
+ */
+class Arc_Reader
+{
+public:
+
+    Arc_Reader();
+    ~Arc_Reader();
+
+    Arc_Reader(const Arc_Reader &) = delete;
+    Arc_Reader &operator=(const Arc_Reader &) = delete;
+
+    // a dictionary entry; kept whole so that decoding a user is a single copy
+    typedef struct Dict_Entry_Struct
+    {
+        char user_id[PUNCH_USER_ID_SIZE];
+        u16 serial;
+    } Dict_Entry;
+
+    int Open(const std::string &path);
+    int Read_Block(std::vector<Punch_Record> &punches, const u32 from_time=0, const u32 to_time=0xffffffff);
+    int Close();
+    u64 Offset() const;
+    const std::vector<Dict_Entry> &Dictionary() const;
+    Arc_Stats Get_Stats() const;
+
+private:
+
+    int fd;
+    u64 size;                               // the file size at open
+    u64 offset;                             // end of the last good block
+    std::vector<u8> buf;                    // the block being decoded
+    std::vector<Dict_Entry> dict;           // code : entry
+    Arc_Stats stats;
+
+    int Read_Dict(const u8 *p, const u32 count, const u32 bytes);
+};
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
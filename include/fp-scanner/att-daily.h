@@ -0,0 +1,168 @@
+//==============================================================================================================|
+// File Desc:
+//  Keeps per employee, per day attendance figures (first in, last out, time worked) current as punches stream
+//  in, thus a dashboard reads them off instead of rescanning the log after every sync. Each (user, day) keeps
+//  its punches in time order along with the running figures: a punch later than the day's last (the usual
+//  case) updates them in constant time, one that comes in late from a device that was offline is slotted in
+//  and the day is replayed, which costs the handful of punches a day has. Repeats of a punch already held
+//  are ignored, thus feeding the same download twice doesn't count twice.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef ATT_DAILY_H
+#define ATT_DAILY_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "punch.h"
+
+#include <mutex>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+// the verify states that end a stretch of work; the rest (check in, break in, overtime in, ...) start one
+#define ATT_STATE_CHECK_OUT     1
+#define ATT_STATE_BREAK_OUT     2
+#define ATT_STATE_OT_OUT        5
+
+#define ATT_DAILY_SCAN_DAYS     366         // most days Scan_User walks
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  How punches pair up into stretches of work
+ */
+enum Att_Pairing
+{
+    ATT_PAIR_STATE,             // by verify_state; an in while in, or an out while out, is left unpaired
+    ATT_PAIR_ALTERNATE          // in, out, in, out, ... whatever the state; for devices without a state key
+};
+
+
+/**
+ * @brief
+ *  The figures of a user's day; times are att_time, 0 when there's none.
+ */
+typedef struct Att_Day_Struct
+{
+    char user_id[PUNCH_USER_ID_SIZE];
+    u32 day;                    // calendar days since 2000-01-01 of the att_time, less the day start
+    u32 first_in;               // earliest in
+    u32 last_out;               // latest out
+    u32 worked;                 // seconds between paired ins and outs
+    u16 punches;                // distinct punches that day
+    bool bopen;                 // the last in is yet to be paired; still at work
+} Att_Day;
+
+
+/**
+ * @brief
+ *  Called with a day's figures every time they change; under the aggregator's lock.
+ */
+typedef void (*pfn_Att_Day_Changed)(const Att_Day &day, void *arg);
+
+
+/**
+ * @brief
+ *  Aggregator counters
+ */
+typedef struct Att_Daily_Stats_Struct
+{
+    u64 punches{0};             // punches taken in
+    u64 late{0};                // of those, the ones that came before a day's last and had it replayed
+    u64 repeats{0};             // ignored for being held already
+    u64 users{0};               // distinct user ids
+    u64 days{0};                // (user, day) held
+} Att_Daily_Stats;
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief
+ *  The aggregator; all members are safe to call from any thread. Days are cut at day_start seconds past
+ *  midnight, thus a night shift that ends by then counts to the day it started.
+ */
+class Att_Daily
+{
+public:
+
+    Att_Daily(const Att_Pairing pairing=ATT_PAIR_STATE, const u32 day_start=0);
+
+    Att_Daily(const Att_Daily &) = delete;
+    Att_Daily &operator=(const Att_Daily &) = delete;
+
+    void Add(const Punch_Record &punch);
+    void Add(const std::vector<Punch_Record> &punches);
+    static void On_Punches(const Punch_Record *ppunches, const size_t count, void *arg);
+    static void On_Events(const Event_Record *precs, const size_t count, void *arg);
+    void Set_Listener(pfn_Att_Day_Changed listener, void *arg);
+
+    int Get(const std::string &user_id, const u32 day, Att_Day &out);
+    size_t Scan_Day(const u32 day, std::vector<Att_Day> &out);
+    size_t Scan_User(const std::string &user_id, const u32 from_day, const u32 to_day, std::vector<Att_Day> &out);
+    u32 Day_Of(const u32 att_time) const;
+    static u32 Day_Number(const u32 yr, const u32 mon, const u32 day);
+    int Drop_Before(const u32 day);
+    Att_Daily_Stats Get_Stats();
+
+private:
+
+    // a punch as far as the figures go
+    typedef struct Mark_Struct
+    {
+        u32 att_time;
+        u8 verify_state;
+    } Mark;
+
+    // a user's day; marks in time order
+    typedef struct Day_State_Struct
+    {
+        std::vector<Mark> marks;
+        u32 first_in{0};
+        u32 last_out{0};
+        u32 worked{0};
+        u32 open_since{0};      // the in being paired
+        bool bopen{false};
+    } Day_State;
+
+    Att_Pairing pairing;
+    u32 day_start;
+    std::unordered_map<u64, Day_State> states;              // code << 32 | day : state
+    std::map<u32, std::vector<u32>> by_day;                 // day : user codes
+    std::unordered_map<std::string, u32> codes;             // user_id : code
+    std::vector<std::string> names;                         // code : user_id
+    pfn_Att_Day_Changed listener{nullptr};
+    void *listener_arg{nullptr};
+    Att_Daily_Stats stats;
+    std::mutex lock;                                        // guards the lot
+
+    void Put(const Punch_Record &punch);
+    void Step(Day_State &state, const Mark &mark) const;
+    void Fill(const u32 code, const u32 day, const Day_State &state, Att_Day &out) const;
+};
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,121 @@
+//==============================================================================================================|
+// File Desc:
+//  An in memory columnar store for attendance history. Punches are split by time into segments (a day each by
+//  default) and every segment keeps its columns sorted on att_time, thus a time range is found by binary
+//  search and scanned straight down the columns. User ids are dictionary coded once for the whole store and
+//  each segment keeps the rows of every user for lookups by user. Fed from downloads (Add_Entries) and the
+//  realtime event bus (On_Events).
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef ATT_STORE_H
+#define ATT_STORE_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "punch.h"
+
+#include <mutex>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define ATT_STORE_SPAN          86400       // att_time covered by a segment; a day
+#define ATT_STORE_INDEX_USERS   16          // queries for up to this many users go through the user index
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  Store counters
+ */
+typedef struct Att_Store_Stats_Struct
+{
+    u64 rows{0};                // punches held
+    u64 segments{0};            // time segments
+    u64 users{0};               // distinct user ids
+    u64 bytes{0};               // memory taken by the columns, roughly
+} Att_Store_Stats;
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief
+ *  The store; all members are safe to call from any thread. Time ranges are half open, [from_time, to_time).
+ */
+class Att_Store
+{
+public:
+
+    Att_Store(const u32 span=ATT_STORE_SPAN);
+
+    Att_Store(const Att_Store &) = delete;
+    Att_Store &operator=(const Att_Store &) = delete;
+
+    void Add(const Punch_Record &punch);
+    void Add(const std::vector<Punch_Record> &punches);
+    void Add_Entries(const int machine_num, const std::vector<Attendance_Entry> &entries);
+    static void On_Events(const Event_Record *precs, const size_t count, void *arg);
+
+    size_t Count(const u32 from_time, const u32 to_time);
+    size_t Scan(const u32 from_time, const u32 to_time, std::vector<Punch_Record> &out);
+    size_t Scan_Users(const std::vector<std::string> &user_ids, const u32 from_time, const u32 to_time,
+        std::vector<Punch_Record> &out);
+    size_t Scan_Machines(const std::vector<int> &machines, const u32 from_time, const u32 to_time,
+        std::vector<Punch_Record> &out);
+    int Drop_Before(const u32 att_time);
+    Att_Store_Stats Get_Stats();
+
+private:
+
+    // a time segment; the rows up to nsorted are in att_time order, those after were added since
+    typedef struct Segment_Struct
+    {
+        std::vector<u32> times;
+        std::vector<u32> users;                 // dictionary codes
+        std::vector<s32> machines;
+        std::vector<u16> serials;
+        std::vector<u8> verify_types;
+        std::vector<u8> verify_states;
+        size_t nsorted{0};
+        std::unordered_map<u32, std::vector<u32>> by_user;  // code : rows in time order
+        bool bindexed{false};
+    } Segment;
+
+    u32 span;
+    std::map<u32, Segment> segments;            // att_time / span : segment
+    std::unordered_map<std::string, u32> codes; // user_id : code
+    std::vector<std::string> names;             // code : user_id
+    u64 nrows{0};
+    std::mutex lock;                            // guards the lot
+
+    void Put(const Punch_Record &punch);
+    void Prepare(Segment &seg);
+    void Index(Segment &seg);
+    void Emit(const Segment &seg, const u32 row, Punch_Record &punch) const;
+    void Range(Segment &seg, const u32 from_time, const u32 to_time, size_t &lo, size_t &hi);
+};
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,55 @@
+//==============================================================================================================|
+// File Desc:
+//  contains declerations for class Maintenance_Session; a scoped hold on a device. The device is disabled once
+//  when the session is made and enabled back when it goes out of scope (error paths included). Everything run
+//  in between (Read_All_UserIDs, Read_Attendance_Record, Set_User_Info, the batch calls, ...) sees the hold and
+//  leaves the device state alone, so a nightly job toggles the terminal once instead of once per operation.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef DEVICE_SESSION_H
+#define DEVICE_SESSION_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "zkteco-driver.h"
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+class Maintenance_Session
+{
+public:
+
+    Maintenance_Session(const int machine_num);
+    ~Maintenance_Session();
+
+    Maintenance_Session(const Maintenance_Session &) = delete;
+    Maintenance_Session &operator=(const Maintenance_Session &) = delete;
+
+    bool Is_Held() const;
+    int Release();
+
+private:
+
+    int machine_num;                // the device we hold
+    bool bheld;                     // true while we hold it
+};
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
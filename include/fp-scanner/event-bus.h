@@ -0,0 +1,166 @@
+//==============================================================================================================|
+// File Desc:
+//  A realtime event bus; the receive path decodes every CMD_REG_EVENT packet into a fixed size Event_Record and
+//  publishes it to each subscriber's own ring buffer. The rings are multi producer (one Run_Select thread per
+//  device), single consumer (the subscriber's thread) and lock free; publishing costs no lock and no
+//  allocation. Subscribers get their events in batches on a thread of their own, so a slow one never holds
+//  up the receive path; when its ring is full new events for it are dropped and counted instead. While the
+//  journal is open (see journal.h) every event is appended to it before it's published; while the shared
+//  memory ring is (see shm-ring.h) it goes there too, for other processes.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "zkteco-driver.h"
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define EVENT_DATA_SIZE         40          // room for the decoded event in a record
+#define EVENT_MAX_SUBSCRIBERS   16          // subscribers at once
+#define EVENT_RING_SIZE         4096        // default ring capacity in records (a power of 2)
+#define EVENT_BATCH_SIZE        64          // most records handed to a subscriber in one call
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  A realtime event as handed to subscribers; 64 bytes, one cache line.
+ */
+typedef struct Event_Record_Struct
+{
+    u64 seq;                        // order of publication; the journal seq while the journal is open
+    u64 recv_us;                    // when the packet was framed (us, steady clock)
+    s32 machine_num;                // the device it came from
+    u16 event;                      // the EF_XXX code
+    u8 len;                         // bytes used in data
+    bool bdecoded;                  // data holds the layout for event, not the raw bytes
+    u8 data[EVENT_DATA_SIZE];       // the decoded event (see below), the raw bytes when it can't be decoded
+} Event_Record;
+
+
+
+
+/**
+ * @brief
+ *  The decoded events, one layout per EF_XXX code and found in Event_Record::data; what follows is as much of
+ *  each as has been deciphered. EF_FINGER carries nothing.
+ */
+#pragma pack(1)
+typedef struct Event_Attendance_Struct          // EF_ATTLOG
+{
+    char user_id[25];               // the user id; always nul terminated
+    u8 verify_type;                 // the verification mode
+    u8 status;                      // check in/out, overtime in/out, ...
+    u32 att_time;                   // encoded the device way (see Encode_Time)
+} Event_Att;
+
+
+typedef struct Event_Enroll_User_Struct         // EF_ENROLLUSER
+{
+    u16 result;                     // 0 when enrolled
+    u16 serial;                     // the user serial
+} Event_Enroll;
+
+
+typedef struct Event_Enroll_Finger_Struct       // EF_ENROLLFINGER
+{
+    u16 result;                     // 0 when enrolled
+    u16 size;                       // template size in bytes
+    u16 serial;                     // the user serial
+    u8 finger_index;                // which finger
+} Event_Enroll_Finger;
+
+
+typedef struct Event_Button_Struct              // EF_BUTTON
+{
+    u16 key;                        // the key code
+} Event_Button;
+
+
+typedef struct Event_Unlock_Struct              // EF_UNLOCK
+{
+    u32 serial;                     // the user that opened the door
+} Event_Unlock;
+
+
+typedef struct Event_Verify_Struct              // EF_VERIFY
+{
+    s32 serial;                     // the user verified or -1 when verification failed
+} Event_Verify;
+
+
+typedef struct Event_Score_Struct               // EF_FPFTR
+{
+    u8 score;                       // finger print quality
+} Event_Score;
+
+
+typedef struct Event_Alarm_Struct               // EF_ALARM
+{
+    u16 type;                       // the alarm type; door sensor, tamper, duress, ...
+    u16 serial;                     // the user involved if any
+    u32 verified;                   // the verification state
+} Event_Alarm;
+#pragma pack()
+
+
+
+
+/**
+ * @brief
+ *  Called on the subscriber's thread with a batch of events in order of publication.
+ */
+typedef void (*pfn_Event_Handler)(const Event_Record *precs, const size_t count, void *arg);
+
+
+
+
+/**
+ * @brief
+ *  Per subscriber counters
+ */
+typedef struct Event_Stats_Struct
+{
+    u64 delivered{0};               // events handed to the handler
+    u64 dropped{0};                 // events lost to a full ring
+    u64 batches{0};                 // handler calls
+} Event_Stats;
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+int Event_Subscribe(pfn_Event_Handler handler, void *arg, const Realtime_Mask mask=RT_ALL,
+    const u32 capacity=EVENT_RING_SIZE);
+int Event_Unsubscribe(const int id);
+int Event_Get_Stats(const int id, Event_Stats *pstats);
+void Event_Publish(const int machine_num, const u16 event, const u8 *pdata, const u32 len);
+Realtime_Mask Event_Wanted_Mask();
+s64 Event_Replay(const u64 from_seq, pfn_Event_Handler handler, void *arg);
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,206 @@
+//==============================================================================================================|
+// File Desc:
+//  Streaming exporters for attendance and users: CSV, JSON Lines, or a plain binary columnar layout. Rows are
+//  formatted by hand straight into a large buffer per output file (integers off a two digit table, dates
+//  worked out once per day) and written out a buffer at a time; nothing goes through iostreams. Output may be
+//  split by day and/or device into files of their own. Every file buffers on its own, and takes a descriptor
+//  only to write its buffer out; descriptors are kept open up to a limit and reopened for append after that,
+//  thus rows interleaved across hundreds of devices neither run out of descriptors nor cost a write each.
+//
+//  The columnar layout is for loading elsewhere, not for keeping (Arc_Writer is the compact one): a file
+//  header, then blocks, each a row count followed by every column in full, fixed width and little endian:
+//      header      u32 magic "ZCOL", u16 version, u16 kind (1 attendance, 2 users)
+//      attendance  u32 att_time, s32 machine_num, u16 serial, u8 verify_type, u8 verify_state,
+//                  char user_id[24]
+//      users       s32 machine_num, u16 serial, u8 privilege, u8 group, u32 card, char user_id[9],
+//                  char name[24]
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef EXPORTER_H
+#define EXPORTER_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "punch.h"
+
+#include <mutex>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define EXPORT_COL_MAGIC        0x4c4f435a  // "ZCOL"
+#define EXPORT_COL_VERSION      1
+#define EXPORT_COL_BLOCK        65536       // rows per columnar block
+
+#define EXPORT_BUFFER_SIZE      (256 << 10) // output buffered per file
+#define EXPORT_MAX_BUFFERED     512         // files holding a buffer at once
+#define EXPORT_MAX_OPEN         64          // files holding a descriptor at once
+
+// partitioning; or'ed together
+#define EXPORT_BY_DAY           0x01        // a file per day (attendance only)
+#define EXPORT_BY_DEVICE        0x02        // a file per device
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  Output formats
+ */
+enum Export_Format
+{
+    EXPORT_CSV,                 // a header line then a row per line; fields quoted only when they must be
+    EXPORT_JSONL,               // an object per line
+    EXPORT_COLUMNAR             // see above
+};
+
+
+/**
+ * @brief
+ *  Exporter settings
+ */
+typedef struct Export_Config_Struct
+{
+    std::string dir;                        // where the files go; must exist
+    Export_Format format{EXPORT_CSV};
+    u32 partition{0};                       // EXPORT_BY_* flags
+    u32 buffer_size{EXPORT_BUFFER_SIZE};
+    u32 max_buffered{EXPORT_MAX_BUFFERED};
+    u32 max_open{EXPORT_MAX_OPEN};
+} Export_Config;
+
+
+/**
+ * @brief
+ *  Exporter counters
+ */
+typedef struct Export_Stats_Struct
+{
+    u64 punches{0};             // attendance rows written
+    u64 users{0};               // user rows written
+    u64 bytes{0};               // bytes handed to the disk
+    u64 files{0};               // files written to
+    u64 evictions{0};           // buffers written out early for room
+    u64 reopens{0};             // files closed for room and opened again
+} Export_Stats;
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief
+ *  The exporter; all members are safe to call from any thread. Files are named attendance.csv, or with
+ *  partitioning attendance-2026-10-18-m3.csv and the like; users-m3.jsonl, users.col, ... Files already there
+ *  are appended to.
+ */
+class Exporter
+{
+public:
+
+    Exporter();
+    ~Exporter();
+
+    Exporter(const Exporter &) = delete;
+    Exporter &operator=(const Exporter &) = delete;
+
+    int Open(const Export_Config &config);
+    int Write(const Punch_Record *ppunches, const size_t count);
+    int Write_Users(const int machine_num, const std::vector<User_Entry> &users);
+    int Flush();
+    int Close();
+    static void On_Punches(const Punch_Record *ppunches, const size_t count, void *arg);
+    Export_Stats Get_Stats();
+
+private:
+
+    // a user row held for a columnar block
+    typedef struct User_Row_Struct
+    {
+        User_Entry entry;
+        s32 machine_num;
+    } User_Row;
+
+    struct Out_File_Struct;
+
+    // a file's place on one of the lists below
+    typedef struct Lru_Link_Struct
+    {
+        struct Out_File_Struct *pprev{nullptr};
+        struct Out_File_Struct *pnext{nullptr};
+    } Lru_Link;
+
+    // an output file
+    typedef struct Out_File_Struct
+    {
+        std::string path;
+        bool busers;                            // users, otherwise attendance
+        int fd{-1};                             // -1 until a write, and while closed for room
+        bool bopened{false};                    // had an fd before
+        std::unique_ptr<char[]> buf;            // config.buffer_size; null while given up for room
+        size_t used{0};
+        Lru_Link buf_link;                      // on buffered while it has a buffer
+        Lru_Link fd_link;                       // on opened while it has an fd
+        std::vector<Punch_Record> punches;      // the columnar block being filled
+        std::vector<User_Row> users;
+    } Out_File;
+
+    // files in the order they were last used, longest ago at the head; linked through their own Lru_Link
+    typedef struct Lru_List_Struct
+    {
+        Out_File *phead{nullptr};
+        Out_File *ptail{nullptr};
+        Lru_Link Out_File::*link;
+    } Lru_List;
+
+    Export_Config config;
+    bool bopen;
+    std::unordered_map<u64, std::unique_ptr<Out_File>> files;  // partition key : file
+    Out_File *plast;                        // the file written last; rows come in runs
+    u64 last_key;
+    Lru_List buffered;                      // files with a buffer, by last written to
+    Lru_List opened;                        // files with an fd, by last written out
+    std::vector<std::unique_ptr<char[]>> spare;    // buffers given up, for the next file to take
+    u32 nbuffered;                          // files with a buffer
+    u32 nopen;                              // files with an fd
+    u32 date_day;                           // the day date_text is for
+    char date_text[11];                     // "YYYY-MM-DD"
+    bool berror;                            // a write failed since Open
+    Export_Stats stats;
+    std::mutex lock;                        // guards the lot
+
+    Out_File *Get(const bool busers, const u32 day, const s32 machine_num);
+    static void Lru_Remove(Lru_List &list, Out_File &file);
+    static void Lru_Push(Lru_List &list, Out_File &file);
+    int Open_File(Out_File &file);
+    void Release(Out_File &file);
+    char *Reserve(Out_File &file, const size_t len);
+    void Put(Out_File &file, const void *p, const size_t len);
+    void Flush_Buffer(Out_File &file);
+    void Flush_Block(Out_File &file);
+    void Row(Out_File &file, const Punch_Record &punch);
+    void Row(Out_File &file, const User_Entry &user, const s32 machine_num);
+    char *Put_Time(char *p, const u32 att_time);
+};
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,105 @@
+//==============================================================================================================|
+// File Desc:
+//  A fleet fan out executor; runs one operation across a set of devices concurrently with no more than a given
+//  number in flight, so a fleet wide Get_Time or Restart_Device takes about as long as the slowest device
+//  instead of the sum of them all. Each device gets its own result and timing, and the caller may be told of
+//  each one as it completes.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef FAN_OUT_H
+#define FAN_OUT_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "zkteco-driver.h"
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define FAN_OUT_PARALLEL        32      // default devices worked on at once
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  An operation run on a single device; index is the device's position in the set given to Fan_Out (handy for
+ *  writing per device output without a lock). Returns 0 on success or -ve on fail, same as the driver calls.
+ */
+typedef int (*pfn_Fleet_Op)(const int machine_num, const size_t index, void *arg);
+
+
+
+
+/**
+ * @brief
+ *  What happened on a single device
+ */
+typedef struct Fan_Out_Result_Struct
+{
+    int machine_num{0};
+    int status{0};                  // what the operation returned
+    u64 elapsed_ms{0};              // time the operation took on the device
+    std::string err;                // the driver error when status is -ve
+} Fan_Out_Result;
+
+
+
+
+/**
+ * @brief
+ *  Told of each device as it completes; calls are never made at the same time, so no locking is needed.
+ */
+typedef void (*pfn_Fan_Out_Done)(const size_t index, const Fan_Out_Result &result, void *arg);
+
+
+
+
+/**
+ * @brief
+ *  Fan out options
+ */
+typedef struct Fan_Out_Options_Struct
+{
+    u32 max_parallel{FAN_OUT_PARALLEL};     // devices worked on at once
+    pfn_Fan_Out_Done done{nullptr};         // called as each device completes
+    void *done_arg{nullptr};                // passed to done
+} Fan_Out_Options;
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+int Fan_Out(const std::vector<int> &machines, pfn_Fleet_Op op, void *arg, std::vector<Fan_Out_Result> &results,
+    const Fan_Out_Options &opt=Fan_Out_Options());
+
+int Fleet_Get_Time(const std::vector<int> &machines, std::vector<u32> &times, std::vector<Fan_Out_Result> &results,
+    const Fan_Out_Options &opt=Fan_Out_Options());
+int Fleet_Set_Time(const std::vector<int> &machines, const u32 _time, std::vector<Fan_Out_Result> &results,
+    const Fan_Out_Options &opt=Fan_Out_Options());
+int Fleet_Read_Attendance(const std::vector<int> &machines, std::vector<std::vector<Attendance_Entry>> &entries,
+    std::vector<Fan_Out_Result> &results, const Fan_Out_Options &opt=Fan_Out_Options());
+int Fleet_Restart(const std::vector<int> &machines, std::vector<Fan_Out_Result> &results,
+    const Fan_Out_Options &opt=Fan_Out_Options());
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
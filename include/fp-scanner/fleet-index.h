@@ -0,0 +1,42 @@
+//==============================================================================================================|
+// File Desc:
+//  A fleet wide index of users; answers "which devices hold user X" without going to the devices. Every user id
+//  maps to a compact bitset of devices, fed from each device's user table (see user-cache.h which keeps this
+//  index up to date as it loads and as users get written or deleted).
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef FLEET_INDEX_H
+#define FLEET_INDEX_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "zkteco-driver.h"
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+int Fleet_Index_Update(const int machine_num, const std::vector<User_Entry> &users);
+void Fleet_Index_Add(const int machine_num, const char *user_id);
+void Fleet_Index_Remove(const int machine_num, const char *user_id);
+void Fleet_Index_Drop_Device(const int machine_num);
+int Fleet_Index_Lookup(const char *user_id, std::vector<int> &machines);
+int Fleet_Revoke_User(const char *user_id);
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,128 @@
+//==============================================================================================================|
+// File Desc:
+//  contains declerations for class Job_Pool; a thread pool for per device jobs that runs them in order of
+//  arrival. Jobs submitted from outside the pool go into a shared queue, those a job spawns onto its worker's
+//  own deque, thus spawning never contends on the shared lock. A worker takes from the shared queue first,
+//  then the oldest of its own, then steals the oldest off another worker; jobs stuck behind a long log download
+//  are taken up by whoever is idle. Spawned jobs don't jump ahead of devices not yet started: finishing a
+//  device's follow ups first halves the median device time on a skewed fleet but starts the slow downloads
+//  later, which costs the fleet round and its tail a quarter more (see src/bench/job-pool-bench.cpp). Workers
+//  are started as the load calls for them, up to the pool's size.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef JOB_POOL_H
+#define JOB_POOL_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "basics.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+// most workers in the shared pool; device jobs spend most of their time waiting on the wire, thus as many as
+//  the devices worked on at once by default (FAN_OUT_PARALLEL); they're only started when there's work for them
+#define JOB_POOL_WORKERS        32
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+typedef std::function<void()> Job;
+
+
+
+/**
+ * @brief
+ *  Pool counters
+ */
+typedef struct Job_Pool_Stats_Struct
+{
+    u64 executed{0};            // jobs run to completion
+    u64 stolen{0};              // of which were taken off another worker
+    u64 queued{0};              // jobs waiting right now
+    u64 started{0};             // workers started so far
+} Job_Pool_Stats;
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+class Job_Pool
+{
+public:
+
+    Job_Pool(const u32 nworkers);
+    ~Job_Pool();
+
+    Job_Pool(const Job_Pool &) = delete;
+    Job_Pool &operator=(const Job_Pool &) = delete;
+
+    void Submit(Job job);
+    bool Run_One();
+    void Help_Until(const std::function<bool()> &bdone);
+    void Wake();
+    bool In_Worker() const;
+    u32 Workers() const;
+    Job_Pool_Stats Get_Stats() const;
+
+private:
+
+    // a worker and its deque
+    typedef struct Worker_Struct
+    {
+        std::mutex lock;            // guards jobs
+        std::deque<Job> jobs;       // jobs it spawned; taken from the front, by it and by thieves
+        std::atomic<u64> executed{0};
+        std::atomic<u64> stolen{0};
+    } Worker;
+
+    std::vector<std::unique_ptr<Worker>> workers;   // one per worker that may be started
+    std::vector<std::thread> threads;               // the ones started; under idle_lock
+    std::deque<Job> shared;         // jobs from outside the pool, oldest first; under idle_lock
+    std::mutex idle_lock;           // sleeping workers wait on this
+    std::condition_variable idle_cv;
+    std::atomic<u64> queued{0};     // jobs in all deques
+    std::atomic<u32> started{0};    // threads.size(), for the thieves
+    std::atomic<u64> outside{0};    // jobs run by outsiders through Run_One
+    u32 idle{0};                    // workers asleep; under idle_lock
+    bool bstop{false};
+
+    bool Take(const u32 self, Job &job);
+    void Start_Worker();
+    void Run(const u32 self);
+};
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+Job_Pool &Default_Job_Pool();
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
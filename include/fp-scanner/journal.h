@@ -0,0 +1,115 @@
+//==============================================================================================================|
+// File Desc:
+//  An append only journal kept in fixed size segment files that are written through mmap; appending is a copy
+//  into the mapping under a short lock, the disk is brought up to date by a background thread according to the
+//  sync policy in effect. Every record carries its own CRC, thus a record torn by a crash is told apart from a
+//  good one and replay stops at the last good record. Used by the event bus to keep realtime events that have
+//  been received but not yet handed downstream (see Event_Replay).
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "basics.h"
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define JOURNAL_MAGIC           0x4c4e524a  // "JRNL" at the head of every segment
+#define JOURNAL_MAX_RECORD      65536       // largest record appended
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  When appended records are made durable. With JOURNAL_SYNC_ALWAYS an append returns only once the record is
+ *  on disk, but appends that come in while a flush is running share the next one (group commit), thus a burst
+ *  costs a flush per round rather than per record.
+ */
+enum Journal_Sync_Policy
+{
+    JOURNAL_SYNC_NONE,          // leave it to the kernel's write back
+    JOURNAL_SYNC_INTERVAL,      // flush every sync_interval_ms or sync_bytes, whichever comes first
+    JOURNAL_SYNC_ALWAYS         // appends wait on the flush that covers them
+};
+
+
+
+
+/**
+ * @brief
+ *  Journal configuration
+ */
+typedef struct Journal_Config_Struct
+{
+    std::string dir{"journal"};             // where the segment files live; must exist
+    u64 segment_size{64 << 20};             // bytes per segment file
+    Journal_Sync_Policy sync{JOURNAL_SYNC_INTERVAL};
+    u32 sync_interval_ms{10};               // longest a record stays unflushed (JOURNAL_SYNC_INTERVAL)
+    u32 sync_bytes{1 << 20};                // unflushed bytes that bring the flush forward
+} Journal_Config;
+
+
+
+
+/**
+ * @brief
+ *  Called by Journal_Replay for every good record in order; return non zero to stop the replay.
+ */
+typedef int (*pfn_Journal_Replay)(const u64 seq, const void *pdata, const u32 len, void *arg);
+
+
+
+
+/**
+ * @brief
+ *  Journal counters
+ */
+typedef struct Journal_Stats_Struct
+{
+    u64 appended{0};            // records appended since open
+    u64 bytes{0};               // and their sizes added up
+    u64 syncs{0};               // flushes to disk
+    u64 spare_waits{0};         // appends that had to wait on the flusher for the next segment
+    u64 segments{0};            // segment files on disk
+    u64 last_seq{0};            // the last record appended
+    u64 synced_seq{0};          // the last record known to be on disk
+} Journal_Stats;
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+int Journal_Open(const Journal_Config &config);
+int Journal_Close();
+bool Journal_Is_Open();
+s64 Journal_Append(const void *pdata, const u32 len);
+int Journal_Sync(const u64 seq);
+s64 Journal_Replay(const u64 from_seq, pfn_Journal_Replay replay, void *arg);
+int Journal_Trim(const u64 upto_seq);
+void Journal_Get_Stats(Journal_Stats *pstats);
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,147 @@
+//==============================================================================================================|
+// File Desc:
+//  A batched ODBC sink for attendance and users. Rows are gathered column by column into arrays and sent with
+//  one execute of a prepared statement per batch (SQL_ATTR_PARAMSET_SIZE), committed as a single transaction,
+//  thus the inserts per second go with the batch size rather than the round trips. A batch goes out once it's
+//  full or flush_ms after the last went, whichever comes first, on a thread of the sink's own; there are two
+//  batches, one filling while the other is written, and a caller only ever waits when both are taken.
+//
+//  Any ODBC data source does; e.g. SQL Server with "DRIVER={ODBC Driver 18 for SQL Server};SERVER=...;UID=...;
+//  PWD=...", or locally the SQLite ODBC driver with "DRIVER=SQLite3;Database=/tmp/att.db".
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef ODBC_SINK_H
+#define ODBC_SINK_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "punch.h"
+
+#include <mutex>
+#include <condition_variable>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define ODBC_BATCH_SIZE         1000        // rows per execute
+#define ODBC_FLUSH_MS           500         // most a row waits for its batch to fill
+
+// the statements; the parameters are bound in this order, thus a MERGE or a procedure call may take their place
+#define ODBC_ATT_INSERT         "INSERT INTO attendance (user_id, att_time, machine_num, verify_type, " \
+                                "verify_state) VALUES (?, ?, ?, ?, ?)"
+#define ODBC_USER_INSERT        "INSERT INTO users (user_id, name, serial, privilege, card_number, " \
+                                "group_number, machine_num) VALUES (?, ?, ?, ?, ?, ?, ?)"
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  Sink settings
+ */
+typedef struct Odbc_Sink_Config_Struct
+{
+    std::string connection;                 // an ODBC connection string
+    std::string att_insert{ODBC_ATT_INSERT};
+    std::string user_insert{ODBC_USER_INSERT};
+    u32 batch_size{ODBC_BATCH_SIZE};
+    u32 flush_ms{ODBC_FLUSH_MS};
+} Odbc_Sink_Config;
+
+
+/**
+ * @brief
+ *  Sink counters
+ */
+typedef struct Odbc_Sink_Stats_Struct
+{
+    u64 rows{0};                // attendance rows written
+    u64 users{0};               // user rows written
+    u64 batches{0};             // executes
+    u64 failed{0};              // rows the database turned down; not retried
+    u64 retries{0};             // batches sent again after the connection was lost
+    u64 dropped{0};             // rows given up on at Close with the database still out
+    u64 pending{0};             // rows waiting in the batches
+} Odbc_Sink_Stats;
+
+
+// the column arrays of a batch; ODBC types, thus kept out of here
+struct Odbc_Batch;
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief
+ *  The sink; all members are safe to call from any thread. A lost connection is made again before the next
+ *  try, and what wasn't committed of the batch that was cut off goes again; rows the database turns down (a
+ *  constraint, a bad value) are found by sending the batch again a row at a time, counted and let go.
+ */
+class Odbc_Sink
+{
+public:
+
+    Odbc_Sink();
+    ~Odbc_Sink();
+
+    Odbc_Sink(const Odbc_Sink &) = delete;
+    Odbc_Sink &operator=(const Odbc_Sink &) = delete;
+
+    int Open(const Odbc_Sink_Config &config);
+    int Close();
+    int Add(const Punch_Record &punch);
+    int Add(const Punch_Record *ppunches, const size_t count);
+    int Write_Users(const int machine_num, const std::vector<User_Entry> &users);
+    int Flush();
+    static void On_Punches(const Punch_Record *ppunches, const size_t count, void *arg);
+    static void On_Events(const Event_Record *precs, const size_t count, void *arg);
+    Odbc_Sink_Stats Get_Stats();
+
+private:
+
+    Odbc_Sink_Config config;
+    void *henv;                             // ODBC handles
+    void *hdbc;
+    void *hatt;                             // the prepared statements
+    void *huser;
+    std::unique_ptr<Odbc_Batch> pfilling;   // taking rows
+    std::unique_ptr<Odbc_Batch> pflushing;  // being written
+    std::thread flusher;
+    bool brunning;
+    bool bflush;                            // a Flush wants the filling batch out now
+    u64 added;                              // rows taken in
+    u64 settled;                            // rows written, turned down or dropped
+    Odbc_Sink_Stats stats;
+    std::mutex lock;                        // guards the batches and counters
+    std::condition_variable cv;             // wakes the flusher
+    std::condition_variable cv_space;       // wakes callers waiting on a batch or a Flush
+    std::mutex db_lock;                     // guards the handles
+
+    int Connect();
+    void Disconnect();
+    int Execute_Att(Odbc_Batch &batch);
+    void Flusher();
+};
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,85 @@
+//==============================================================================================================|
+// File Desc:
+//  A write behind outbox for device mutations. Set_User_Info/Delete_User/Enroll_User requests are appended to a
+//  local file (so they survive a crash) and return right away; a background thread applies them to the devices
+//  in batches, a job per device on the shared job pool, retrying with back off when a device is out of reach. Writes to the same user on the same device
+//  supersede one another while they wait, thus a burst of edits to one user costs the device a single write.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef OUTBOX_H
+#define OUTBOX_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "zkteco-driver.h"
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+// kinds of operations held in the outbox
+#define OUTBOX_SET_USER         1
+#define OUTBOX_DELETE_USER      2
+#define OUTBOX_ENROLL_USER      3
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  Called when an operation is given up on after max_attempts; the record is dropped from the outbox after.
+ */
+typedef void (*pfn_Outbox_Failed)(const int machine_num, const u8 op, const void *pdata, const std::string &err);
+
+
+
+
+/**
+ * @brief
+ *  Outbox configuration
+ */
+typedef struct Outbox_Config_Struct
+{
+    std::string path{"outbox.dat"};     // the outbox file
+    u32 batch_size{256};                // most operations applied per device per round
+    u32 flush_interval_ms{500};         // how long an operation sits before it's applied; edits coalesce in it
+    u32 retry_base_ms{1000};            // first back off after a failed round or a refusal
+    u32 retry_max_ms{60000};            // back off cap
+    u32 max_attempts{10};               // refusals by the device before an operation is dropped
+    u32 max_running{8};                 // devices applied to at once (on the shared job pool)
+    bool bsync{true};                   // fdatasync every append (false trades safety for speed)
+    pfn_Outbox_Failed failed{nullptr};  // told about dropped operations
+} Outbox_Config;
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+int Outbox_Open(const Outbox_Config &config);
+int Outbox_Close();
+int Outbox_Set_User(const int machine_num, const User_Entry &user);
+int Outbox_Delete_User(const int machine_num, const u16 serial);
+int Outbox_Enroll_User(const int machine_num, const Enroll_Data &enroll);
+u32 Outbox_Pending(const int machine_num=-1);
+int Outbox_Flush(const u32 timeout_ms);
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
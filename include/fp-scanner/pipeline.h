@@ -0,0 +1,152 @@
+//==============================================================================================================|
+// File Desc:
+//  A bounded pipeline between the receive path (downloads, the event bus) and the sinks (the database, the
+//  archive, the aggregates). Every sink gets a stage of its own: a queue in memory and a thread that feeds the
+//  sink from it, thus a stalled database holds up only its own stage. A queue that reaches its high watermark
+//  spills what comes after to disk segments rather than grow; once the sink catches up and the queue is down
+//  to its low watermark, the spill is read back in order, a watermark's worth at a time, until it's gone and
+//  the stage is back to memory alone. Memory stays capped however long a sink is out. Without a spill
+//  directory a full stage makes the caller wait instead. Spill left over from a stop (or a crash) is picked
+//  up on the next start.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "punch.h"
+
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define PIPE_HIGH_WATER         (64 << 10)      // punches in memory before a stage spills
+#define PIPE_LOW_WATER          (16 << 10)      // punches in memory before the spill is read back
+#define PIPE_BATCH_SIZE         4096            // most punches handed to a sink at once
+#define PIPE_SEGMENT_SIZE       (16 << 20)      // bytes in a spill segment
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  Stage settings
+ */
+typedef struct Pipe_Stage_Config_Struct
+{
+    u32 high_water{PIPE_HIGH_WATER};
+    u32 low_water{PIPE_LOW_WATER};
+    u32 batch_size{PIPE_BATCH_SIZE};
+    std::string spill_dir;                      // the stage spills under spill_dir/name; empty for no spill
+    u64 segment_size{PIPE_SEGMENT_SIZE};
+} Pipe_Stage_Config;
+
+
+/**
+ * @brief
+ *  Stage counters; depth and spilled are as of now, the rest totals.
+ */
+typedef struct Pipe_Stage_Stats_Struct
+{
+    std::string name;
+    u64 depth{0};               // punches queued in memory
+    u64 peak_depth{0};          // the most there ever were
+    u64 spilled{0};             // punches on disk, waiting to be read back
+    u64 spill_segments{0};      // segment files
+    bool bspilling{false};      // new punches are going to disk
+    u64 pushed{0};              // punches taken in
+    u64 delivered{0};           // punches handed to the sink
+    u64 spill_writes{0};        // punches written to disk
+    u64 spill_reads{0};         // punches read back
+    u64 waits{0};               // times a caller had to wait on a full stage
+} Pipe_Stage_Stats;
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief
+ *  The pipeline; stages are added before Start, Push and the handlers are safe from any thread. Each sink is
+ *  called from its stage's thread only, a batch at a time, in the order pushed.
+ */
+class Punch_Pipeline
+{
+public:
+
+    Punch_Pipeline();
+    ~Punch_Pipeline();
+
+    Punch_Pipeline(const Punch_Pipeline &) = delete;
+    Punch_Pipeline &operator=(const Punch_Pipeline &) = delete;
+
+    int Add_Stage(const std::string &name, pfn_Punch_Sink sink, void *arg,
+        const Pipe_Stage_Config &config=Pipe_Stage_Config());
+    int Start();
+    int Stop();
+    int Push(const Punch_Record *ppunches, const size_t count);
+    static void On_Punches(const Punch_Record *ppunches, const size_t count, void *arg);
+    static void On_Events(const Event_Record *precs, const size_t count, void *arg);
+    void Get_Stats(std::vector<Pipe_Stage_Stats> &out);
+
+private:
+
+    // a stage; the spill is a run of segment files, written at the back and read from the front
+    typedef struct Stage_Struct
+    {
+        Pipe_Stage_Config config;
+        std::string dir;                        // where the segments go
+        pfn_Punch_Sink sink;
+        void *arg;
+        std::deque<Punch_Record> queue;
+        std::deque<u64> segments;               // segment ids on disk, oldest first
+        u64 next_segment{0};                    // id of the next segment made
+        int write_fd{-1};                       // the last segment, open for append
+        u64 write_size{0};
+        int read_fd{-1};                        // the first segment, open for reading
+        u64 read_offset{0};
+        bool bspilling{false};
+        bool brunning{false};
+        std::thread worker;
+        Pipe_Stage_Stats stats;
+        std::mutex lock;                        // guards the lot
+        std::condition_variable cv;             // wakes the worker
+        std::condition_variable cv_space;       // wakes callers waiting on a full stage
+    } Stage;
+
+    std::vector<std::unique_ptr<Stage>> stages;
+    bool brunning;
+
+    static int Recover(Stage &stage);
+    static size_t Spill(Stage &stage, const Punch_Record *ppunches, const size_t count);
+    static size_t Unspill(Stage &stage, const size_t max);
+    static void Close_Spill(Stage &stage);
+    static void Put(Stage &stage, const Punch_Record *ppunches, size_t count);
+    static void Worker(Stage *pstage);
+};
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,146 @@
+//==============================================================================================================|
+// File Desc:
+//  Drops punches seen before, keyed on (device, user id, att_time, verify state); the same punch comes in from
+//  realtime events, from the next full download and again after a device is reset and downloaded anew. The
+//  last few days (going by the latest att_time seen) are held exactly, a hash set of key fingerprints per day;
+//  as a day falls out of the window its keys go into a Bloom filter. A punch older than the window the filter
+//  has never seen is new for sure; one it may have seen is a duplicate unless an optional confirm callback
+//  (say a database lookup) says otherwise, thus the only round trips are for the filter's maybes. Without the
+//  callback about bloom_fp of the new punches that old are dropped as well; they're counted apart and logged.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef PUNCH_DEDUP_H
+#define PUNCH_DEDUP_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "punch.h"
+
+#include <mutex>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define DEDUP_WINDOW_DAYS       7               // days held exactly
+#define DEDUP_BLOOM_ITEMS       (16 << 20)      // keys the filter is sized for
+#define DEDUP_BLOOM_FP          0.001           // the filter's false positive rate at that many keys
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  Asked about a punch older than the window the filter may have seen; returns true if it's been seen before
+ *  (stored), false to let it through.
+ */
+typedef bool (*pfn_Dedup_Confirm)(const Punch_Record &punch, void *arg);
+
+
+/**
+ * @brief
+ *  Dedup settings
+ */
+typedef struct Dedup_Config_Struct
+{
+    u32 window_days{DEDUP_WINDOW_DAYS};
+    u64 bloom_items{DEDUP_BLOOM_ITEMS};
+    double bloom_fp{DEDUP_BLOOM_FP};
+    pfn_Dedup_Confirm confirm{nullptr};     // nullptr takes the filter's maybes for duplicates, unchecked
+    void *confirm_arg{nullptr};
+} Dedup_Config;
+
+
+/**
+ * @brief
+ *  Dedup counters
+ */
+typedef struct Dedup_Stats_Struct
+{
+    u64 seen{0};                // punches checked
+    u64 passed{0};              // let through as new
+    u64 dropped{0};             // dropped from the window
+    u64 dropped_old{0};         // dropped on the confirm callback's word
+    u64 unconfirmed{0};         // dropped on the filter's word alone, for want of a callback; may have been new
+    u64 confirms{0};            // calls to the confirm callback
+    u64 window_keys{0};         // keys held exactly
+    u64 bloom_keys{0};          // keys gone into the filter
+    u64 bloom_bytes{0};         // size of the filter
+} Dedup_Stats;
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief
+ *  The dedup stage; all members are safe to call from any thread. Set_Sink makes it a link in a chain of
+ *  sinks: On_Punches and On_Events pass on only what's new.
+ */
+class Punch_Dedup
+{
+public:
+
+    Punch_Dedup(const Dedup_Config &config=Dedup_Config());
+
+    Punch_Dedup(const Punch_Dedup &) = delete;
+    Punch_Dedup &operator=(const Punch_Dedup &) = delete;
+
+    bool Insert(const Punch_Record &punch);
+    size_t Filter(std::vector<Punch_Record> &punches);
+    void Set_Sink(pfn_Punch_Sink sink, void *arg);
+    static void On_Punches(const Punch_Record *ppunches, const size_t count, void *arg);
+    static void On_Events(const Event_Record *precs, const size_t count, void *arg);
+    Dedup_Stats Get_Stats();
+
+private:
+
+    // a day's keys; open addressed fingerprints, 0 for an empty slot
+    typedef struct Day_Struct
+    {
+        u32 day;
+        std::vector<u64> slots;
+        size_t count{0};
+    } Day;
+
+    Dedup_Config config;
+    std::vector<Day> days;              // the window, in no particular order
+    u32 last_day{0};                    // the latest day seen; the window ends there
+    size_t hint{0};                     // the day looked up last
+    std::vector<u64> bloom;             // 512 bit blocks
+    u64 bloom_blocks{0};
+    u32 bloom_probes{0};                // bits set per key
+    pfn_Punch_Sink sink{nullptr};
+    void *sink_arg{nullptr};
+    std::vector<Punch_Record> batch;    // what's passed on from a call
+    Dedup_Stats stats;
+    std::mutex lock;                    // guards the lot
+
+    bool Check(const Punch_Record &punch);
+    void Advance(const u32 day);
+    bool Day_Insert(Day &d, const u64 key);
+    bool Bloom_Test(const u64 key) const;
+    void Bloom_Add(const u64 key);
+    void Pass_On();
+};
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
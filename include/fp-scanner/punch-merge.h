@@ -0,0 +1,153 @@
+//==============================================================================================================|
+// File Desc:
+//  Merges the attendance of many devices into one stream in time order. Each device (a source) hands over its
+//  punches already in time order, a radix sort on att_time takes care of that right after the download, and a
+//  heap over the sources' heads picks the next punch. Sources are fed and finished while the merge runs; the
+//  merge moves on as soon as every source that's still open has something to offer, and gives back what it's
+//  done with as it goes, thus nothing is ever copied into one big vector and sorted.
+//
+//  The merge can't hand out a single punch before every source has shown its first, and with the downloads
+//  run a few at a time the first device is long done before the last one starts; what the merge holds is thus
+//  capped rather than left to grow with the fleet. Runs are taken in pieces of MERGE_RUN_SIZE and once
+//  max_queued punches are held the rest of a source goes to a spill file of its own, read back a piece at a
+//  time as the merge gets to it. Held in memory is then at most max_queued punches plus a piece per source,
+//  along with the logs of the devices being downloaded right now (a device sends its log in one transfer).
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef PUNCH_MERGE_H
+#define PUNCH_MERGE_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "punch.h"
+#include "fan-out.h"
+
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define MERGE_BATCH_SIZE        4096        // punches handed to a sink at once
+#define MERGE_RUN_SIZE          4096        // punches in a piece of a run; spilled and read back in these
+#define MERGE_MAX_QUEUED        (256 << 10) // punches held in memory before the sources spill
+#define MERGE_SPILL_DIR         "/tmp"
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  Merge settings
+ */
+typedef struct Punch_Merge_Config_Struct
+{
+    u64 max_queued{MERGE_MAX_QUEUED};       // 0 for no cap
+    std::string spill_dir{MERGE_SPILL_DIR}; // empty to hold everything in memory
+} Punch_Merge_Config;
+
+
+/**
+ * @brief
+ *  Merge counters
+ */
+typedef struct Punch_Merge_Stats_Struct
+{
+    u64 queued{0};              // punches held in memory
+    u64 peak_queued{0};         // the most there ever were
+    u64 spilled{0};             // punches on disk, waiting to be read back
+    u64 spill_writes{0};        // punches written to disk
+    u64 spill_reads{0};         // punches read back
+} Punch_Merge_Stats;
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief
+ *  A k-way merge; Push and Finish may be called from any thread, Pop from one thread only. Punches with the
+ *  same att_time come out in source order.
+ */
+class Punch_Merge
+{
+public:
+
+    Punch_Merge(const u32 nsources, const Punch_Merge_Config &config=Punch_Merge_Config());
+    ~Punch_Merge();
+
+    Punch_Merge(const Punch_Merge &) = delete;
+    Punch_Merge &operator=(const Punch_Merge &) = delete;
+
+    int Push(const u32 source, std::vector<Punch_Record> &&run);
+    int Finish(const u32 source);
+    size_t Pop(Punch_Record *pout, const size_t max);
+    Punch_Merge_Stats Get_Stats();
+
+private:
+
+    // a source; its runs are consumed front to back, then the spill, which always comes after them
+    typedef struct Source_Struct
+    {
+        std::deque<std::vector<Punch_Record>> runs;
+        size_t pos{0};                  // next punch in runs.front()
+        int spill_fd{-1};               // unlinked on creation; gone with the close
+        u64 spill_head{0};              // punches read back
+        u64 spill_tail{0};              // punches written
+        bool bfinished{false};
+        bool bqueued{false};            // in the heap
+    } Source;
+
+    // a heap entry; the time of the source's next punch
+    typedef struct Head_Struct
+    {
+        u32 att_time;
+        u32 source;
+    } Head;
+
+    Punch_Merge_Config config;
+    std::vector<Source> sources;
+    std::vector<Head> heap;             // min heap on (att_time, source)
+    u32 nwaiting;                       // open sources with nothing to offer; the merge waits on them
+    std::mutex lock;                    // guards the lot
+    std::condition_variable cv;         // wakes Pop
+    bool bspill_failed;                 // the disk let us down; everything stays in memory from then on
+    Punch_Merge_Stats stats;
+
+    void Queue(const u32 source);
+    int Spill(Source &src, const Punch_Record *ppunches, const size_t count);
+    void Refill(Source &src, const bool ball=false);
+};
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+void Punch_Radix_Sort(std::vector<Punch_Record> &punches);
+int Fleet_Merge_Attendance(const std::vector<int> &machines, pfn_Punch_Sink sink, void *arg,
+    std::vector<Fan_Out_Result> &results, const Fan_Out_Options &opt=Fan_Out_Options(),
+    const Punch_Merge_Config &config=Punch_Merge_Config());
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,77 @@
+//==============================================================================================================|
+// File Desc:
+//  A punch is an attendance transaction in one shape no matter where it came from; a downloaded log entry
+//  (Attendance_Entry) or a realtime event (Event_Att). The stores, streams and sinks that work on attendance
+//  history all take punches.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef PUNCH_H
+#define PUNCH_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "event-bus.h"
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define PUNCH_USER_ID_SIZE      24          // room for the user id with its nul
+
+// the day an att_time falls on, counted the device way (31 day months); days sort like dates
+#define PUNCH_DAY(att_time)     ((att_time) / 86400)
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  An attendance transaction
+ */
+typedef struct Punch_Record_Struct
+{
+    u32 att_time;                       // encoded the device way (see Encode_Time); sorts as real time does
+    s32 machine_num;                    // the device punched at
+    u16 serial;                         // the user serial; 0 when not known (realtime events don't carry it)
+    u8 verify_type;                     // the verification mode
+    u8 verify_state;                    // check in/out, overtime in/out, ...
+    char user_id[PUNCH_USER_ID_SIZE];   // always nul terminated
+} Punch_Record;
+
+
+
+/**
+ * @brief
+ *  Takes a stream of punches a batch at a time.
+ */
+typedef void (*pfn_Punch_Sink)(const Punch_Record *ppunches, const size_t count, void *arg);
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+void Punch_From_Entry(const int machine_num, const Attendance_Entry &entry, Punch_Record &punch);
+bool Punch_From_Event(const Event_Record &rec, Punch_Record &punch);
+void Punch_From_Entries(const int machine_num, const std::vector<Attendance_Entry> &entries,
+    std::vector<Punch_Record> &punches);
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
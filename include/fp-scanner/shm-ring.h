@@ -0,0 +1,191 @@
+//==============================================================================================================|
+// File Desc:
+//  A ring of realtime events in shared memory, for other processes on the host (access control, display
+//  boards, the payroll bridge, ...). Event_Publish writes every event into the ring straight from the receive
+//  path, next to the journal and before the subscribers. The driver is the only writer and never waits on the
+//  readers: there's no read position in the ring at all. Every slot carries a sequence number that is odd
+//  while the slot is being written and even once it's done (a seqlock), so any number of readers can read a
+//  record in place, with no copy, and then check that it wasn't written over while they read. A reader that
+//  falls a lap behind finds out from the slot sequence, counts what it lost and moves up. Readers with
+//  nothing to read spin a little, then sleep on a futex in the ring that the driver wakes only when someone
+//  is sleeping on it. Readers map the ring read write for the futex words alone; they write nothing else.
+//
+//  The layout, for readers that don't use Shm_Reader: a Shm_Ring_Header then capacity Shm_Slot's. The event
+//  at position p is in slot p % capacity, and is there whole when the slot seq reads 2p + 2 both before and
+//  after reading it.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "event-bus.h"
+
+#include <atomic>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define SHM_RING_MAGIC          0x474e525a  // "ZRNG"
+#define SHM_RING_VERSION        1
+#define SHM_RING_NAME           "/zkteco-events"
+#define SHM_RING_SIZE           65536       // default capacity in events (a power of 2); 8MB
+#define SHM_RING_SPIN_US        50          // how long a reader spins before it sleeps
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  The head of the shared memory; the driver's counters and the readers' futex are kept on cache lines of
+ *  their own.
+ */
+typedef struct Shm_Ring_Header_Struct
+{
+    u32 magic;                              // set last, once the ring is ready
+    u32 version;
+    u32 capacity;                           // slots
+    u32 slot_size;                          // sizeof(Shm_Slot)
+    u32 producer_pid;
+    u32 bclosed;                            // the driver is done with this ring; attach anew
+    u8 pad1[40];
+
+    alignas(64) std::atomic<u64> head;      // every position below this one is written
+    u8 pad2[56];
+
+    alignas(64) std::atomic<u32> futex;     // bumped per event
+    std::atomic<u32> waiters;               // readers asleep on futex
+    u8 pad3[56];
+} Shm_Ring_Header;
+
+
+/**
+ * @brief
+ *  A slot; the record sits on a cache line of its own.
+ */
+typedef struct Shm_Slot_Struct
+{
+    alignas(64) std::atomic<u64> seq;       // 2p + 1 while position p is written, 2p + 2 once it is
+    u8 pad[56];
+    Event_Record rec;
+} Shm_Slot;
+
+
+
+
+/**
+ * @brief
+ *  Ring settings
+ */
+typedef struct Shm_Ring_Config_Struct
+{
+    std::string name{SHM_RING_NAME};        // the shm_open name
+    u32 capacity{SHM_RING_SIZE};            // rounded up to a power of 2
+    Realtime_Mask mask{RT_ALL};             // events put on the ring
+    u32 mode{0660};                         // who may attach; readers write the futex words, thus need rw
+} Shm_Ring_Config;
+
+
+
+
+/**
+ * @brief
+ *  Driver side counters
+ */
+typedef struct Shm_Ring_Stats_Struct
+{
+    u64 published{0};           // events put on the ring
+    u64 wakes{0};               // futex wakes made; only when readers were asleep
+} Shm_Ring_Stats;
+
+
+
+
+/**
+ * @brief
+ *  Reader side counters
+ */
+typedef struct Shm_Reader_Stats_Struct
+{
+    u64 read{0};                // events read whole
+    u64 lost{0};                // events written over before they were read
+    u64 overruns{0};            // times the reader was lapped
+    u64 sleeps{0};              // futex waits
+} Shm_Reader_Stats;
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+int Shm_Ring_Open(const Shm_Ring_Config &config);
+int Shm_Ring_Close();
+bool Shm_Ring_Is_Open();
+Realtime_Mask Shm_Ring_Mask();
+void Shm_Ring_Publish(const Event_Record &rec);
+void Shm_Ring_Get_Stats(Shm_Ring_Stats *pstats);
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief
+ *  A reader, in whatever process; one thread per reader. Poll hands out the next event in place, Confirm
+ *  tells if it held still while it was looked at and moves on. Read does the two with a copy and waits.
+ */
+class Shm_Reader
+{
+public:
+
+    Shm_Reader();
+    ~Shm_Reader();
+
+    Shm_Reader(const Shm_Reader &) = delete;
+    Shm_Reader &operator=(const Shm_Reader &) = delete;
+
+    int Attach(const std::string &name=SHM_RING_NAME, const bool boldest=false);
+    void Detach();
+    int Poll(const Event_Record *&prec);
+    bool Confirm();
+    int Wait(const u32 timeout_ms, const u32 spin_us=SHM_RING_SPIN_US);
+    int Read(Event_Record &rec, const u32 timeout_ms);
+    u64 Position() const { return next; }
+    Shm_Reader_Stats Get_Stats() const { return stats; }
+
+private:
+
+    Shm_Ring_Header *pring;
+    Shm_Slot *pslots;
+    size_t size;                            // bytes mapped
+    u64 mask;                               // capacity - 1
+    u64 next;                               // the position read next
+    u64 polled;                             // the slot seq Poll saw
+    Shm_Reader_Stats stats;
+
+    bool Ready() const;
+    void Skip();
+};
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,101 @@
+//==============================================================================================================|
+// File Desc:
+//  A status driven sync scheduler; instead of downloading every device on a fixed cadence it polls the cheap
+//  CMD_GET_FREE_SIZES (Get_Device_Status) counters and only triggers user or attendance syncs when those move.
+//  Polls are jittered across the fleet so that a few hundred devices don't all get hit on the same second.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef SYNC_SCHEDULER_H
+#define SYNC_SCHEDULER_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "zkteco-driver.h"
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+// kinds of syncs a device could be queued for; kept as bits since both can be pending at once
+#define SYNC_USERS          0x01
+#define SYNC_ATTENDANCE     0x02
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  A sync job handler; called from a job pool worker (see job-pool.h) with the status that triggered it. Returns
+ *  0 on success or -ve on fail (the device is simply polled again on its next turn).
+ */
+typedef int (*pfn_Sync_Job)(const int machine_num, const Machine_Status &stat, void *arg);
+
+
+
+
+/**
+ * @brief
+ *  Scheduler configuration; the poll interval is per device and jitter is a random extra wait of up to
+ *  jitter_ms added to each device's next poll.
+ */
+typedef struct Sync_Scheduler_Config
+{
+    u32 poll_interval_ms{60000};        // how often each device gets its status polled
+    u32 jitter_ms{5000};                // random spread added to each poll
+    pfn_Sync_Job user_sync{nullptr};    // called when user/fp counters move
+    pfn_Sync_Job att_sync{nullptr};     // called when attendance counter moves
+    u32 max_running{8};                 // syncs run at once (on the shared job pool)
+    u32 max_polling{16};                // status polls run at once (same pool)
+    void *arg{nullptr};                 // passed along to the handlers
+} Sched_Config, *Sched_Config_Ptr;
+
+
+
+
+/**
+ * @brief
+ *  Per device numbers exposed by the scheduler; lag is the age of the oldest job waiting (or running) on the
+ *  device, 0 when there is nothing queued.
+ */
+typedef struct Sync_Device_Stats
+{
+    u32 queue_depth{0};         // sync jobs waiting on the device
+    u64 lag_ms{0};              // how long the oldest of those has been waiting
+    u64 polls{0};               // status polls made
+    u64 user_syncs{0};          // user syncs run
+    u64 att_syncs{0};           // attendance syncs run
+    u64 errors{0};              // failed polls or syncs
+    Machine_Status last;        // the last status seen
+} Sched_Stats, *Sched_Stats_Ptr;
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+int Sched_Start(const Sched_Config &config);
+int Sched_Stop();
+int Sched_Add_Device(const int machine_num);
+int Sched_Remove_Device(const int machine_num);
+int Sched_Get_Stats(const int machine_num, Sched_Stats *pstats);
+u32 Sched_Queue_Depth();
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,49 @@
+//==============================================================================================================|
+// File Desc:
+//  A per device, in memory copy of the user table. Users are kept in a flat array with two open addressing
+//  indexes over it, one by serial number and one by user id; thus lookups are a couple of probes and never cause
+//  any traffic to the device. The cache is loaded once with Read_All_UserIDs, kept up to date by the driver's
+//  own Set_User_Info/Delete_User calls and marked stale whenever the device reports an enrollment in realtime.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef USER_CACHE_H
+#define USER_CACHE_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "zkteco-driver.h"
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+int Cache_Load_Users(const int machine_num, const bool bforce=false);
+int Cache_Find_Serial(const int machine_num, const u16 serial, User_Entry *puser);
+int Cache_Find_UserID(const int machine_num, const char *user_id, User_Entry *puser);
+int Cache_Get_Users(const int machine_num, std::vector<User_Entry> &users);
+bool Cache_Is_Valid(const int machine_num);
+
+
+// called by the driver to keep things coherent
+void Cache_Put_User(const int machine_num, const User_Entry &user);
+void Cache_Drop_User(const int machine_num, const u16 serial);
+void Cache_Invalidate(const int machine_num);
+void Cache_Clear(const int machine_num);
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,76 @@
+//==============================================================================================================|
+// File Desc:
+//  A diff and push user synchronization engine; takes the master user list (as HR sees it) and brings a set of
+//  devices in line with it. For each device the minimal diff against its cached user table (see user-cache.h)
+//  is computed and only the changed records get pushed, pipelined, within a single disable/refresh/enable
+//  bracket. Devices are worked on in parallel.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+#ifndef USER_SYNC_H
+#define USER_SYNC_H
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "zkteco-driver.h"
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  Knobs for a sync run
+ */
+typedef struct User_Sync_Options_Struct
+{
+    bool bdelete_extra{false};      // delete users the device has but the master list doesn't
+    u32 max_parallel{8};            // devices worked on at once
+} User_Sync_Options;
+
+
+
+
+/**
+ * @brief
+ *  What happened on a single device
+ */
+typedef struct User_Sync_Result_Struct
+{
+    int machine_num{0};
+    int status{0};                  // 0 on success, -ve on fail (see err)
+    u32 upserts{0};                 // users written
+    u32 deletes{0};                 // users deleted
+    u32 failed{0};                  // records the device refused
+    u64 elapsed_ms{0};              // time spent on the device
+    std::string err;
+} User_Sync_Result;
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+void Diff_Users(const std::vector<User_Entry> &master, const std::vector<User_Entry> &device,
+    std::vector<User_Entry> &upserts, std::vector<u16> &deletes, const bool bdelete_extra=false);
+int Sync_Device_Users(const int machine_num, const std::vector<User_Entry> &master, User_Sync_Result &result,
+    const User_Sync_Options &opt=User_Sync_Options());
+int Sync_Users(const std::vector<User_Entry> &master, const std::vector<int> &machines,
+    std::vector<User_Sync_Result> &results, const User_Sync_Options &opt=User_Sync_Options());
+
+
+#endif
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -30,6 +30,11 @@
 #include "basics.h"
 #include "client.h"
 
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_set>
+
 
 
 
@@ -49,6 +54,7 @@
 #define CMD_TEST_TMP        1009            // test if finger print exists
 #define CMD_REFRESHDATA     1013            // refresh the machine stored data
 #define CMD_REFRESHOPTION   1014            // refresh the configuration paramters
+#define CMD_CLEAR_ATTLOG    15              // clears all attendance records stored on the machine
 #define CMD_PREPARE_DATA    1500            // prepare for data transmission
 #define CMD_DATA            1501            // data packet
 #define CMD_FREE_DATA       1502            // release buffer used for data transmission
@@ -85,6 +91,20 @@
 #define CMD_ACK_UNKNOWN         65535 	        // Received unknown command. 	
 
 
+// realtime event codes; sent as the session_id of CMD_REG_EVENT packets, these also double as the bits
+//  of the registration mask passed on to Init_Realtime (see Realtime_Mask)
+#define EF_ATTLOG           1               // attendance transaction
+#define EF_FINGER           2               // a finger was placed on the sensor
+#define EF_ENROLLUSER       4               // a user got enrolled
+#define EF_ENROLLFINGER     8               // a finger got enrolled
+#define EF_BUTTON           16              // a button was pressed
+#define EF_UNLOCK           32              // door unlocked
+#define EF_VERIFY           128             // a user was verified
+#define EF_FPFTR            256             // finger print feature point
+#define EF_ALARM            512             // alarm signal
+
+
+
 // flags used during finger print enrollment
 #define INVALID_FINGERPRINT     0
 #define VALID_FINGERPRINT       1
@@ -114,12 +134,60 @@
 
 // upper limit on ZKT data sizes for our application
 #define ZKT_DATA_SIZE       2048        // a 2kb space for each packet! that's neat...
+#define ZKT_REPLY_TIMEOUT   3           // seconds to wait on a reply when the connection has no receive timeout
+
+
+
+// the most requests kept in flight at once during batched/pipelined writes
+#define PIPELINE_WINDOW     16
+
+
+
+// the rq key of a device's dedicated event connection (see Connect_Event_Channel); kept out of the way of the
+//  machine numbers proper, which are never negative
+#define EVENT_CHANNEL(machine_num)      (-(machine_num) - 1)
 
 
 
 //==============================================================================================================|
 // TYPES
 //==============================================================================================================|
+/**
+ * @brief 
+ *  The realtime events to register for (see Init_Realtime); a typed take on the EF_XXX bits so that a stray
+ *  number doesn't get passed on as a mask. Combine them with |.
+ */
+enum Realtime_Mask : u32
+{
+    RT_NONE = 0,
+    RT_ATTLOG = EF_ATTLOG,
+    RT_FINGER = EF_FINGER,
+    RT_ENROLLUSER = EF_ENROLLUSER,
+    RT_ENROLLFINGER = EF_ENROLLFINGER,
+    RT_BUTTON = EF_BUTTON,
+    RT_UNLOCK = EF_UNLOCK,
+    RT_VERIFY = EF_VERIFY,
+    RT_FPFTR = EF_FPFTR,
+    RT_ALARM = EF_ALARM,
+    RT_ALL = EF_ATTLOG | EF_FINGER | EF_ENROLLUSER | EF_ENROLLFINGER | EF_BUTTON | EF_UNLOCK | EF_VERIFY |
+        EF_FPFTR | EF_ALARM
+};
+
+
+inline constexpr Realtime_Mask operator|(const Realtime_Mask a, const Realtime_Mask b)
+{
+    return (Realtime_Mask)((u32)a | (u32)b);
+} // end operator|
+
+
+inline Realtime_Mask &operator|=(Realtime_Mask &a, const Realtime_Mask b)
+{
+    return a = a | b;
+} // end operator|=
+
+
+
+
 /**
  * @brief 
  *  All ZKT eco packets contain a payload structure which contains info on the type of request (command_id) which
@@ -217,16 +285,24 @@ typedef struct Enroll_Data_Format
 
 /**
  * @brief 
- *  Machine status info returned during calls to free sizes
+ *  Machine status info returned during calls to free sizes; the reply is a run of 32-bit counters of which
+ *  only the ones below are known to mean something.
  */
 #pragma pack(1)
 typedef struct Machine_Status_Info
 {
     u8 pad1[16];        // all zeros
     u32 user_count;     // number of users
-    u8 pad2[8];
+    u8 pad2[4];
     u32 fp_template;    // number of finger print templates on the machine
+    u8 pad3[4];
+    u32 att_count;      // number of attendance records
+    u8 pad4[12];
     u32 pwd_count;      // number of passwords
+    u8 pad5[4];
+    u32 fp_capacity;    // finger print templates the machine can hold
+    u32 user_capacity;  // users the machine can hold
+    u32 att_capacity;   // attendance records the machine can hold
 } Machine_Status, *Machine_Status_Ptr;
 
 
@@ -267,9 +343,24 @@ typedef struct Veryfiy_Info_Format
     u8 verification_mode;   // the mode of identification (see contants above)
     u8 pad[21]{0};          // padding
 } Verify_Info, *Verify_Info_Ptr;
+#pragma pack()      // back to the default; the wire formats end here and packing must not leak into includers
+
+
 
 
 
+/**
+ * @brief 
+ *  Wakes the callers waiting on a connection's replies (see Get_Response); held by pointer so that Driver_Info
+ *  stays copyable.
+ */
+typedef struct Reply_Signal_Struct
+{
+    std::condition_variable cv;         // signaled as a reply is filed and when the connection drops
+    std::atomic<u64> last_rx_ms{0};     // when bytes last came in (steady clock); a long transfer keeps waits alive
+} Reply_Signal;
+
+
 
 
 /**
@@ -282,16 +373,37 @@ typedef struct Veryfiy_Info_Format
 typedef struct Intaps_Driver_Info_Struct
 {
     Client cli;                                  // object is our client connection interface
-    std::unordered_map<u16, Zkt_Packet> que;     // a queue of responses mapped as reply_num : que
+    std::unordered_map<u16, std::deque<Zkt_Packet>> que;     // a queue of responses mapped as reply_num : que
+    std::unordered_set<u16> abandoned;  // reply numbers nobody waits on any more; their replies are dropped
     u16 session_id{0};          // the session id for this connection
     u16 reply_num{0};           // the current reply number
     bool bok{false};            // used during fetching as crude wait
-    bool bconnected{false};     // connection state
+    bool bconnected{false};     // connection state; cleared by Run_Select on its way out
+    std::thread *pselect{nullptr};  // the connection's Run_Select thread; joined by Disconnect_Net
+    std::shared_ptr<Reply_Signal> psignal{std::make_shared<Reply_Signal>()};
+    u64 users_hash{0};          // fingerprint of the user table as last downloaded
+    u32 hold_count{0};          // nested holds on the device; disabled while > 0; under pop_lock
+    std::shared_ptr<std::recursive_mutex> pop_lock{std::make_shared<std::recursive_mutex>()};   // see DEVICE_LOCK
+    std::string ip;             // the device address; bulk transfers are admitted per subnet
+    int owner{-1};              // for an event channel the device it serves; -1 otherwise
     std::string err;            // dumps error      
 } Driver_Info, *Driver_Info_Ptr;
 
 
 
+
+/**
+ * @brief 
+ *  Callback used during a committed attendance sync (see Read_Clear_Attendance). The function must store the
+ *  records durably (database, file, what have you) and report back the count and checksum (see Att_Checksum) of
+ *  what it has actually stored; the device log is only cleared when both of these agree with what was downloaded.
+ *  Returning a -ve value aborts the commit and leaves the device log untouched.
+ */
+typedef int (*pfn_Att_Commit)(const int machine_num, const std::vector<Attendance_Entry> &entry, 
+    u32 *pcount, u32 *pchecksum, void *arg);
+
+
+
 //==============================================================================================================|
 // GLOBALS
 //==============================================================================================================|
@@ -306,8 +418,11 @@ extern std::thread *ps_thread;
 //==============================================================================================================|
 // internals
 int Get_Response(const int machine_num, int reply_num, Zkt_Packet &zkt);
+Driver_Info &Dev(const int machine_num);
 void Process_Response(const int machine_num, Zkt_Packet_Ptr ppack);
 void Run_Select(const int machine_num);
+int Send_Pipelined(const int machine_num, const u16 cmd_id, const void *dat, const u32 dlen, const u32 count,
+    std::vector<int> &status, const u32 window=PIPELINE_WINDOW);
 std::string Whats_Last_Error(const int machine_num);
 
 
@@ -315,6 +430,9 @@ std::string Whats_Last_Error(const int machine_num);
 // terminal operations
 int Connect_Net(const int machine_num, const std::string &ip, const std::string &port, const int password=0);
 int Disconnect_Net(const int machine_num);
+int Connect_Event_Channel(const int machine_num, const std::string &ip, const std::string &port, 
+    const int password=0, const Realtime_Mask mask=RT_ATTLOG);
+int Disconnect_Event_Channel(const int machine_num);
 int Get_Device_Status(const int machine_num, Machine_Status *pstat);
 int Get_Time(const int machine_num, u32* ptime);
 int Refresh(const int machine_num, const u16 command_id=CMD_REFRESHDATA);
@@ -324,16 +442,27 @@ int Set_Time(const int machine_num, const u32 _time1);
 // data operations
 int Data_Ready(const int machine_num, const u32 dlen);
 int Read_All_UserIDs(const int machine_num, std::vector<User_Entry> &users);    
+int Read_Changed_UserIDs(const int machine_num, std::vector<User_Entry> &users, u64 &hash);
+u64 User_Table_Hash(const int machine_num);
 int Read_Attendance_Record(const int machine_num, std::vector<Attendance_Entry> &entry);
+int Read_Clear_Attendance(const int machine_num, std::vector<Attendance_Entry> &entry, pfn_Att_Commit commit, 
+    void *arg=nullptr);
+int Clear_Attendance_Log(const int machine_num);
 int Delete_User(const int machine_num, const u16 user_sn);
-int Init_Realtime(const int machine_num, const u32 options={1}); 
+int Init_Realtime(const int machine_num, const Realtime_Mask mask=RT_ATTLOG); 
 int Set_User_Info(const int machine_num, User_Entry_Ptr puser);
+int Set_User_Info_Batch(const int machine_num, const std::vector<User_Entry> &users, std::vector<int> &status,
+    const bool brefresh=true);
+int Delete_User_Batch(const int machine_num, const std::vector<u16> &serials, std::vector<int> &status,
+    const bool brefresh=true);
 
 
 // other operations
 int Enroll_User(const int machine_num, const Enroll_Data &enroll);
 int Enable_Device(const int machine_num);
 int Disable_Device(const int machine_num); 
+int Hold_Device(const int machine_num);
+int Release_Device(const int machine_num);
 int Clear_Admins(const int machine_num);
 int Enable_Clock(const int machine_num);
 int Start_Identify(const int machine_num);
@@ -347,6 +476,8 @@ int Read_Machine_Config(const int machine_num, const std::string &query, std::st
 inline u16 Checksum(Payload_Ptr ppload, u16 *data=nullptr, u32 data_len=0);
 inline u32 Commkey(const u16 session_id, const u32 password, const u8 ticks=50);
 inline bool Alphanumeric_Support(const std::string &str);
+u32 Att_Checksum(const Attendance_Entry *patt, const size_t count);
+u32 Encode_Time(const u32 yr, const u32 mon, const u32 day, const u32 hr, const u32 min, const u32 sec);
 void Print_User_Info(User_Entry &info);
 void Print_Att_Info(Attendance_Entry &info);
 
@@ -61,6 +61,7 @@ public:
     int Toggle_KeepAlive();
 
     int Get_Socket();
+    int Get_Recv_Timeout();
     
 private:
 
@@ -72,6 +73,7 @@ private:
 
     u32 delaytcp;                   // a false int that determines if tcp is delayed or not
     u32 keep_alive;                 // boolean used to determine if we need to keep an idle connection
+    int recv_timeout;               // seconds as last set by Set_Recv_Timeout; 0 for none
     
            
     // utilities
@@ -50,6 +50,8 @@ typedef struct APP_CONFIG_FILE
 int Read_Config(APP_CONFIG_PTR p_config);
 void Split_String(const std::string &str, const char tokken, std::vector<std::string> &dest);
 void Dump_Hex(const char *p_buf, const size_t len);
+u64 Hash_Block(const void *p_buf, const size_t len, const u64 seed=0);
+u32 Crc32(const void *p_buf, const size_t len, const u32 crc=0);
 
 int Mutex_Init(MUTEX *mutex);
 int Mutex_Lock(MUTEX *mutex);
@@ -0,0 +1,278 @@
+//==============================================================================================================|
+// File Desc:
+//  A benchmark of Job_Pool against a plain FIFO pool (one queue, one lock) on a skewed fleet, the way device
+//  syncs come in: most devices are done in a couple of milliseconds, a few grind through a long log download.
+//  Each device job waits out its transfer and then hands off the follow up work (parsing, storing, ...) as jobs
+//  of their own. The wire is simulated with sleeps, thus the numbers tell about scheduling alone.
+//
+//  Reported per pool are the time to get through the fleet and how long each device took from the start of
+//  the run to its last follow up job; the latter is what a device sync is felt as downstream.
+//
+//  usage: job-pool-bench [devices] [workers] [rounds]
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "job-pool.h"
+
+#include <chrono>
+#include <deque>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define BENCH_DEVICES           400         // the fleet
+#define BENCH_WORKERS           16          // threads in either pool
+#define BENCH_ROUNDS            5           // runs per pool; the best is reported
+#define BENCH_SLOW_EVERY        50          // one device in these is slow
+#define BENCH_SLOW_MS           200         // a long log download
+#define BENCH_FAST_MS           2           // a status check
+#define BENCH_FOLLOW_UPS        4           // jobs a device hands off once it's done on the wire
+#define BENCH_FOLLOW_UP_US      500         // each
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  What one run came to
+ */
+typedef struct Bench_Result_Struct
+{
+    double total_ms{0};         // the fleet, start to last job
+    double p50_ms{0};           // device completion; median
+    double p99_ms{0};
+    double max_ms{0};
+} Bench_Result;
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief
+ *  The pool Job_Pool is measured against; one queue for everyone, first in first out.
+ */
+class Fifo_Pool
+{
+public:
+
+    Fifo_Pool(const u32 nworkers)
+    {
+        for (u32 i = 0; i < nworkers; i++)
+            threads.emplace_back(&Fifo_Pool::Run, this);
+    } // end constructor
+
+    ~Fifo_Pool()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            bstop = true;
+        }
+
+        cv.notify_all();
+        for (auto &t : threads)
+            t.join();
+    } // end destructor
+
+    void Submit(Job job)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            jobs.push_back(std::move(job));
+        }
+
+        cv.notify_one();
+    } // end Submit
+
+private:
+
+    std::deque<Job> jobs;
+    std::vector<std::thread> threads;
+    std::mutex lock;
+    std::condition_variable cv;
+    bool bstop{false};
+
+    void Run()
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        for (;;)
+        {
+            cv.wait(guard, [this]() { return bstop || !jobs.empty(); });
+            if (jobs.empty())
+                return;
+
+            Job job = std::move(jobs.front());
+            jobs.pop_front();
+
+            guard.unlock();
+            job();
+            guard.lock();
+        } // end for
+    } // end Run
+};
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Milliseconds since start
+ */
+static double Ms_Since(const std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+} // end Ms_Since
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Runs the fleet through a pool once; submit hands a job to the pool, from outside or from a job.
+ *
+ * @param [ndevices] the fleet size
+ * @param [submit] submits a job
+ *
+ * @return Bench_Result
+ *  what it came to
+ */
+template <typename Submit_Fn>
+static Bench_Result Run_Fleet(const u32 ndevices, Submit_Fn submit)
+{
+    std::vector<double> done_ms(ndevices, 0);
+    std::vector<std::atomic<u32>> left(ndevices);
+    std::mutex lock;
+    std::condition_variable cv;
+    u32 devices_left = ndevices;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // a device is done once its last follow up is
+    auto finish = [&](const u32 dev) {
+        if (--left[dev])
+            return;
+
+        done_ms[dev] = Ms_Since(start);
+        std::lock_guard<std::mutex> guard(lock);
+        if (!--devices_left)
+            cv.notify_one();
+    };
+
+    for (u32 d = 0; d < ndevices; d++)
+    {
+        left[d] = BENCH_FOLLOW_UPS;
+        u32 wire_ms = d % BENCH_SLOW_EVERY ? BENCH_FAST_MS : BENCH_SLOW_MS;
+
+        submit([&, d, wire_ms]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(wire_ms));
+            for (u32 f = 0; f < BENCH_FOLLOW_UPS; f++)
+            {
+                submit([&, d]() {
+                    std::this_thread::sleep_for(std::chrono::microseconds(BENCH_FOLLOW_UP_US));
+                    finish(d);
+                });
+            } // end for
+        });
+    } // end for
+
+    std::unique_lock<std::mutex> guard(lock);
+    cv.wait(guard, [&]() { return !devices_left; });
+
+    Bench_Result r;
+    r.total_ms = Ms_Since(start);
+    std::sort(done_ms.begin(), done_ms.end());
+    r.p50_ms = done_ms[done_ms.size() / 2];
+    r.p99_ms = done_ms[std::min(done_ms.size() - 1, done_ms.size() * 99 / 100)];
+    r.max_ms = done_ms.back();
+
+    return r;
+} // end Run_Fleet
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Keeps the better of two runs; the one that got through the fleet sooner.
+ */
+static void Keep_Best(Bench_Result &best, const Bench_Result &r)
+{
+    if (!best.total_ms || r.total_ms < best.total_ms)
+        best = r;
+} // end Keep_Best
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Prints a line of the report
+ */
+static void Print_Result(const char *name, const Bench_Result &r)
+{
+    printf("%-12s %10.1f %10.1f %10.1f %10.1f\n", name, r.total_ms, r.p50_ms, r.p99_ms, r.max_ms);
+} // end Print_Result
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Entry point
+ */
+int main(int argc, char *argv[])
+{
+    u32 ndevices = argc > 1 ? (u32)atoi(argv[1]) : BENCH_DEVICES;
+    u32 nworkers = argc > 2 ? (u32)atoi(argv[2]) : BENCH_WORKERS;
+    u32 rounds = argc > 3 ? (u32)atoi(argv[3]) : BENCH_ROUNDS;
+    Bench_Result fifo, stealing;
+
+    if (!ndevices || !nworkers || !rounds)
+    {
+        fprintf(stderr, "usage: %s [devices] [workers] [rounds]\n", argv[0]);
+        return 1;
+    } // end if
+
+    printf("%u devices (1 in %u takes %u ms, the rest %u ms), %u follow ups of %u us each, %u workers\n",
+        ndevices, BENCH_SLOW_EVERY, BENCH_SLOW_MS, BENCH_FAST_MS, BENCH_FOLLOW_UPS, BENCH_FOLLOW_UP_US, nworkers);
+
+    for (u32 i = 0; i < rounds; i++)
+    {
+        {
+            Fifo_Pool pool(nworkers);
+            Keep_Best(fifo, Run_Fleet(ndevices, [&pool](Job job) { pool.Submit(std::move(job)); }));
+        }
+
+        {
+            Job_Pool pool(nworkers);
+            Keep_Best(stealing, Run_Fleet(ndevices, [&pool](Job job) { pool.Submit(std::move(job)); }));
+        }
+    } // end for
+
+    printf("\n%-12s %10s %10s %10s %10s\n", "pool", "fleet ms", "p50 ms", "p99 ms", "max ms");
+    Print_Result("fifo", fifo);
+    Print_Result("job-pool", stealing);
+
+    return 0;
+} // end main
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
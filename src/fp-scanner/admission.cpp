@@ -0,0 +1,377 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for admission control of bulk transfers. Waiters sit in a single queue in order of
+//  arrival; every time a slot frees up (or a bucket refills) the queue is walked from the front and whoever
+//  fits is let in. A waiter held back by the global limits stops the walk (nobody jumps the queue), one held
+//  back by its subnet only holds back those behind it from the same subnet.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "admission.h"
+
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <list>
+#include <set>
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  A byte rate budget; tokens go negative when a transfer is charged more than there is, and nobody else is
+ *  let in until the refill has paid it back.
+ */
+typedef struct Adm_Bucket_Info
+{
+    double tokens{0};           // bytes in the bucket
+    u64 last_ms{0};             // last refill
+} Adm_Bucket;
+
+
+
+/**
+ * @brief
+ *  Per subnet book keeping
+ */
+typedef struct Adm_Subnet_Info
+{
+    u32 running{0};             // transfers let in
+    Adm_Bucket bucket;
+} Adm_Subnet;
+
+
+
+/**
+ * @brief
+ *  A transfer waiting its turn
+ */
+typedef struct Adm_Waiter_Info
+{
+    std::string subnet;
+    u32 bytes{0};
+    bool badmitted{false};
+} Adm_Waiter;
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+static Adm_Config adm_cfg;                          // the limits in effect
+static std::unordered_map<std::string, Adm_Subnet> subnets;
+static Adm_Bucket global_bucket;
+static u32 global_running{0};
+static std::list<Adm_Waiter*> waiters;              // in order of arrival
+static std::mutex adm_lock;                         // guards all of the above
+static std::condition_variable adm_cv;              // wakes the waiters
+static Adm_Stats adm_stats;
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Milliseconds on the monotonic clock
+ */
+static u64 Now_Ms()
+{
+    return (u64)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+} // end Now_Ms
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Works out the subnet of an address; anything that's not a dotted IPv4 (a host name say) is a subnet of its
+ *  own.
+ */
+static std::string Subnet_Of(const std::string &ip)
+{
+    struct in_addr addr;
+    if (inet_pton(AF_INET, ip.c_str(), &addr) != 1)
+        return ip;
+
+    u32 prefix = adm_cfg.subnet_prefix > 32 ? 32 : adm_cfg.subnet_prefix;
+    u32 mask = prefix ? (0xffffffffU << (32 - prefix)) : 0;
+    addr.s_addr = htonl(ntohl(addr.s_addr) & mask);
+
+    char buf[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &addr, buf, sizeof(buf));
+    return std::string(buf) + "/" + std::to_string(prefix);
+} // end Subnet_Of
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Tops up a bucket for the time gone by and tells how long (ms) until it's out of debt; 0 when it is already
+ *  or when there's no budget at all.
+ */
+static u64 Refill(Adm_Bucket &bucket, const u64 bps, const u64 now)
+{
+    if (!bps)
+        return 0;
+
+    if (bucket.last_ms)
+    {
+        bucket.tokens += (double)bps * (double)(now - bucket.last_ms) / 1000.0;
+        if (bucket.tokens > (double)bps)
+            bucket.tokens = (double)bps;    // a second's worth at most
+    } // end if
+    else
+        bucket.tokens = (double)bps;
+
+    bucket.last_ms = now;
+    return bucket.tokens >= 0 ? 0 : (u64)(-bucket.tokens * 1000.0 / (double)bps) + 1;
+} // end Refill
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Walks the queue from the front and lets in whoever fits; caller must hold the lock.
+ *
+ * @return u64
+ *  ms until a bucket is out of debt, i.e. when it's worth walking again; 0 if no bucket is holding anyone back
+ */
+static u64 Grant()
+{
+    u64 now = Now_Ms();
+    u64 retry{0};
+    std::set<std::string> held;     // subnets that already have someone held back
+
+    for (auto pw : waiters)
+    {
+        if (pw->badmitted)
+            continue;
+
+        if (adm_cfg.max_global && global_running >= adm_cfg.max_global)
+            break;
+
+        u64 gwait = Refill(global_bucket, adm_cfg.global_bps, now);
+        if (gwait)
+        {
+            retry = gwait;
+            break;
+        } // end if
+
+        if (held.count(pw->subnet))
+            continue;
+
+        Adm_Subnet &sn = subnets[pw->subnet];
+        u64 swait = Refill(sn.bucket, adm_cfg.subnet_bps, now);
+        if ((adm_cfg.max_per_subnet && sn.running >= adm_cfg.max_per_subnet) || swait)
+        {
+            if (swait && (!retry || swait < retry))
+                retry = swait;
+            held.insert(pw->subnet);
+            continue;
+        } // end if
+
+        // in you go; pay up front
+        if (adm_cfg.global_bps)
+            global_bucket.tokens -= pw->bytes;
+        if (adm_cfg.subnet_bps)
+            sn.bucket.tokens -= pw->bytes;
+
+        ++global_running;
+        ++sn.running;
+        ++adm_stats.admitted;
+        adm_stats.bytes += pw->bytes;
+        pw->badmitted = true;
+    } // end for
+
+    return retry;
+} // end Grant
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Sets the limits; transfers already let in keep running, the waiting ones are measured against the new
+ *  limits straight away.
+ *
+ * @param [config] the new limits
+ */
+void Adm_Configure(const Adm_Config &config)
+{
+    std::lock_guard<std::mutex> guard(adm_lock);
+
+    // subnets are keyed by prefix; re-keying those in flight isn't worth it, so the prefix only changes
+    //  when nothing is let in
+    u32 prefix = adm_cfg.subnet_prefix;
+    adm_cfg = config;
+    if (global_running)
+        adm_cfg.subnet_prefix = prefix;
+
+    Grant();
+    adm_cv.notify_all();
+} // end Adm_Configure
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Waits to be let in for a transfer of the given size from the device at ip.
+ *
+ * @param [ip] the device address
+ * @param [bytes] the size of the transfer
+ * @param [subnet] gets the subnet to pass to Adm_Release
+ *
+ * @return int
+ *  0 when let in, -1 on time out
+ */
+int Adm_Acquire(const std::string &ip, const u32 bytes, std::string &subnet)
+{
+    std::unique_lock<std::mutex> lock(adm_lock);
+    u64 start = Now_Ms();
+    u64 deadline = adm_cfg.timeout_ms ? start + adm_cfg.timeout_ms : 0;
+
+    Adm_Waiter w;
+    w.subnet = subnet = Subnet_Of(ip);
+    w.bytes = bytes;
+    auto it = waiters.insert(waiters.end(), &w);
+    ++adm_stats.waiting;
+
+    for (;;)
+    {
+        u64 retry = Grant();
+        if (w.badmitted)
+            break;
+
+        u64 now = Now_Ms();
+        if (deadline && now >= deadline)
+            break;
+
+        // nobody signals a bucket refilling, so wake up for it
+        u64 wait = retry ? retry : 1000;
+        if (deadline && deadline - now < wait)
+            wait = deadline - now;
+
+        adm_cv.wait_for(lock, std::chrono::milliseconds(wait));
+    } // end for
+
+    waiters.erase(it);
+    --adm_stats.waiting;
+    adm_stats.wait_ms += Now_Ms() - start;
+
+    if (!w.badmitted)
+    {
+        ++adm_stats.timeouts;
+        return -1;
+    } // end if
+
+    // whoever's behind us might fit now as well
+    adm_cv.notify_all();
+    return 0;
+} // end Adm_Acquire
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Gives back a slot got from Adm_Acquire.
+ *
+ * @param [subnet] the subnet Adm_Acquire returned
+ */
+void Adm_Release(const std::string &subnet)
+{
+    std::lock_guard<std::mutex> guard(adm_lock);
+
+    auto it = subnets.find(subnet);
+    if (it != subnets.end() && it->second.running)
+    {
+        --it->second.running;
+        if (!it->second.running && !adm_cfg.subnet_bps)
+            subnets.erase(it);
+    } // end if
+
+    if (global_running)
+        --global_running;
+
+    adm_cv.notify_all();
+} // end Adm_Release
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the admission counters.
+ *
+ * @param [pstats] gets the counters
+ */
+void Adm_Get_Stats(Adm_Stats *pstats)
+{
+    std::lock_guard<std::mutex> guard(adm_lock);
+
+    if (!pstats)
+        return;
+
+    *pstats = adm_stats;
+    pstats->running = global_running;
+} // end Adm_Get_Stats
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief Construct a new Adm_Ticket object
+ *  waits to be let in; check Is_Admitted() to see if that went through.
+ *
+ * @param [ip] the device address
+ * @param [bytes] the size of the transfer
+ */
+Adm_Ticket::Adm_Ticket(const std::string &ip, const u32 bytes)
+    : badmitted{false}
+{
+    badmitted = (Adm_Acquire(ip, bytes, subnet) == 0);
+} // end constructor
+
+
+//==============================================================================================================|
+/**
+ * @brief Destroy the Adm_Ticket object
+ *  gives the slot back.
+ */
+Adm_Ticket::~Adm_Ticket()
+{
+    if (badmitted)
+        Adm_Release(subnet);
+} // end destructor
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  tells if the transfer was let in.
+ */
+bool Adm_Ticket::Is_Admitted() const
+{
+    return badmitted;
+} // end Is_Admitted
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
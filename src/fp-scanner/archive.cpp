@@ -0,0 +1,826 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for the attendance archive. A block is laid out as
+//
+//      Arc_Block_Header | new dictionary entries | time | user | device | verify type | verify state
+//
+//  where every column starts on a byte and holds count values (count - 1 for the time) of the width given in
+//  the header; a width of 0 means every value is the same and takes no room at all. Values are unpacked with
+//  one unaligned 64 bit load each, thus the reader keeps 8 zero bytes past the end of a block in memory.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "archive.h"
+#include "utils.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define ARC_VERSION         1
+#define ARC_PAD             8       // zeros kept past a block for the 64 bit loads
+
+// zig zag; small negatives to small positives
+#define ZIGZAG(x)           (((u64)(x) << 1) ^ (u64)((s64)(x) >> 63))
+#define UNZIGZAG(x)         ((s64)((x) >> 1) ^ -(s64)((x) & 1))
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+#pragma pack(1)
+typedef struct Arc_File_Header_Info
+{
+    u32 magic;                  // ARC_FILE_MAGIC
+    u32 version;
+} Arc_File_Header;
+
+
+
+typedef struct Arc_Block_Header_Info
+{
+    u32 magic;                  // ARC_BLOCK_MAGIC
+    u32 count;                  // punches in the block
+    u32 min_time;               // earliest att_time in the block
+    u32 max_time;               // latest
+    u32 first_time;             // att_time of the first punch; the rest are deltas of deltas
+    s32 machine_base;           // the smallest machine_num; the column holds offsets from it
+    u32 dict_count;             // dictionary entries first used in this block
+    u32 dict_bytes;             // and their size
+    u32 body_bytes;             // the columns
+    u32 crc;                    // over the dictionary entries and the columns
+    u8 w_time;                  // column widths in bits
+    u8 w_user;
+    u8 w_machine;
+    u8 w_verify_type;
+    u8 w_verify_state;
+    u8 reserved[3];
+} Arc_Block_Header;
+#pragma pack()
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Bits needed to hold v
+ */
+static inline u8 Width(const u64 v)
+{
+    return v ? (u8)(64 - __builtin_clzll(v)) : 0;
+} // end Width
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Bytes a column of n values w bits wide takes
+ */
+static inline size_t Column_Bytes(const u32 w, const size_t n)
+{
+    return ((u64)w * n + 7) / 8;
+} // end Column_Bytes
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Packs values of a fixed width onto the end of a buffer, 64 bits at a time.
+ */
+class Bit_Writer
+{
+public:
+
+    Bit_Writer(std::vector<u8> &out) : out{out}, acc{0}, nbits{0} { }
+
+    inline void Put(const u64 v, const u32 w)
+    {
+        if (!w)
+            return;
+
+        acc |= v << nbits;
+        if (nbits + w >= 64)
+        {
+            Emit(8);
+            acc = nbits ? v >> (64 - nbits) : 0;
+            nbits = nbits + w - 64;
+        } // end if
+        else
+            nbits += w;
+    } // end Put
+
+    inline void Finish()
+    {
+        Emit((nbits + 7) / 8);
+        acc = 0;
+        nbits = 0;
+    } // end Finish
+
+private:
+
+    std::vector<u8> &out;
+    u64 acc;                    // bits not yet written, low bits first
+    u32 nbits;
+
+    inline void Emit(const u32 bytes)
+    {
+        u64 le = RNTOHLL(acc);
+        const u8 *p = (const u8*)&le;
+        out.insert(out.end(), p, p + bytes);
+    } // end Emit
+};
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Unpacks the value of a w bit column at index i; mask is (1 << w) - 1. Reads up to 7 bytes past the value.
+ */
+static inline u64 Get(const u8 *pcol, const u64 i, const u32 w, const u64 mask)
+{
+    u64 bit = i * w;
+    u64 v;
+    iCpy(&v, pcol + (bit >> 3), sizeof(v));
+    return (RNTOHLL(v) >> (bit & 7)) & mask;
+} // end Get
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Reads exactly len bytes unless the file ends first.
+ *
+ * @return ssize_t
+ *  the bytes read or -1 on fail
+ */
+static ssize_t Read_Full(const int fd, void *pbuf, const size_t len)
+{
+    size_t done{0};
+    while (done < len)
+    {
+        ssize_t n = read(fd, (u8*)pbuf + done, len - done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            return -1;
+        if (n == 0)
+            break;
+        done += n;
+    } // end while
+
+    return (ssize_t)done;
+} // end Read_Full
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes all of len bytes.
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+static int Write_Full(const int fd, const void *pbuf, const size_t len)
+{
+    size_t done{0};
+    while (done < len)
+    {
+        ssize_t n = write(fd, (const u8*)pbuf + done, len - done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return -1;
+        done += n;
+    } // end while
+
+    return 0;
+} // end Write_Full
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The dictionary key of a punch; the user id and the serial it goes with.
+ */
+static inline std::string Dict_Key(const Punch_Record &punch)
+{
+    std::string key(punch.user_id, strnlen(punch.user_id, sizeof(punch.user_id)));
+    key.push_back('\0');
+    key.append((const char*)&punch.serial, sizeof(punch.serial));
+    return key;
+} // end Dict_Key
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief Construct a new Arc_Writer object
+ */
+Arc_Writer::Arc_Writer()
+    : fd{-1}, block_size{ARC_BLOCK_SIZE}
+{
+} // end constructor
+
+
+//==============================================================================================================|
+/**
+ * @brief Destroy the Arc_Writer object
+ *  writes out whatever is buffered.
+ */
+Arc_Writer::~Arc_Writer()
+{
+    Close();
+} // end destructor
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Opens an archive for writing. When appending to an existing one, the file is read through to pick up the
+ *  dictionary, and a block torn by a crash at the end is cut off.
+ *
+ * @param [path] the archive file
+ * @param [bappend] carry on an existing archive rather than start afresh
+ * @param [block_size] punches per block
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+int Arc_Writer::Open(const std::string &path, const bool bappend, const u32 block_size)
+{
+    if (fd >= 0 || !block_size || block_size > ARC_MAX_BLOCK)
+        return -1;
+
+    this->block_size = block_size;
+    pending.clear();
+    pending.reserve(block_size);
+    dict.clear();
+    stats = Arc_Stats();
+
+    struct stat st;
+    if (bappend && stat(path.c_str(), &st) == 0 && st.st_size > 0)
+    {
+        Arc_Reader reader;
+        std::vector<Punch_Record> punches;
+
+        if (reader.Open(path) < 0)
+            return -1;
+
+        while (reader.Read_Block(punches) > 0)
+            ;
+
+        // a bad block can only be the last one written before a crash; all after it goes
+        u64 good = reader.Offset();
+        auto &entries = reader.Dictionary();
+        reader.Close();
+
+        for (u32 code = 0; code < entries.size(); code++)
+        {
+            Punch_Record punch;
+            memset(&punch, 0, sizeof(punch));
+            iCpy(punch.user_id, entries[code].user_id, sizeof(punch.user_id));
+            punch.serial = entries[code].serial;
+            dict.emplace(Dict_Key(punch), code);
+        } // end for
+
+        fd = open(path.c_str(), O_WRONLY);
+        if (fd < 0 || ftruncate(fd, (off_t)good) != 0 || lseek(fd, 0, SEEK_END) < 0)
+        {
+            Close();
+            return -1;
+        } // end if
+    } // end if
+    else
+    {
+        fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            return -1;
+
+        Arc_File_Header hdr;
+        hdr.magic = ARC_FILE_MAGIC;
+        hdr.version = ARC_VERSION;
+        if (Write_Full(fd, &hdr, sizeof(hdr)) < 0)
+        {
+            Close();
+            return -1;
+        } // end if
+
+        stats.bytes += sizeof(hdr);
+    } // end else
+
+    stats.users = dict.size();
+    return 0;
+} // end Open
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Encodes the buffered punches as a block and writes it out. The users it's the first to use join the
+ *  dictionary only once it's written; a failed write is cut off the file again, thus the next block goes
+ *  where this one would have and carries the same new users, and the punches stay buffered.
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+int Arc_Writer::Write_Block()
+{
+    size_t n = pending.size();
+    if (!n)
+        return 0;
+
+    Arc_Block_Header hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = ARC_BLOCK_MAGIC;
+    hdr.count = (u32)n;
+    hdr.first_time = hdr.min_time = hdr.max_time = pending[0].att_time;
+    hdr.machine_base = pending[0].machine_num;
+
+    std::vector<u64> dods(n - 1);
+    std::vector<u32> codes(n);
+    std::unordered_map<std::string, u32> fresh;     // users new with this block : code
+    u64 max_dod{0}, max_code{0}, max_vt{0}, max_vs{0};
+    s64 prev_delta{0};
+
+    buf.assign(sizeof(hdr), 0);
+
+    // pass 1: dictionary codes, deltas of deltas and the ranges that size the columns
+    for (size_t i = 0; i < n; i++)
+    {
+        const Punch_Record &p = pending[i];
+
+        if (i)
+        {
+            s64 delta = (s64)p.att_time - (s64)pending[i - 1].att_time;
+            dods[i - 1] = ZIGZAG(delta - prev_delta);
+            prev_delta = delta;
+            max_dod |= dods[i - 1];
+        } // end if
+
+        hdr.min_time = std::min(hdr.min_time, p.att_time);
+        hdr.max_time = std::max(hdr.max_time, p.att_time);
+        hdr.machine_base = std::min(hdr.machine_base, p.machine_num);
+
+        std::string key = Dict_Key(p);
+        auto it = dict.find(key);
+        if (it == dict.end() && (it = fresh.find(key)) == fresh.end())
+        {
+            u32 code = (u32)(dict.size() + fresh.size());
+            it = fresh.emplace(key, code).first;
+
+            u8 len = (u8)strnlen(p.user_id, sizeof(p.user_id) - 1);
+            u16 serial = RHTONS(p.serial);
+            buf.insert(buf.end(), (const u8*)&serial, (const u8*)&serial + sizeof(serial));
+            buf.push_back(len);
+            buf.insert(buf.end(), (const u8*)p.user_id, (const u8*)p.user_id + len);
+            ++hdr.dict_count;
+        } // end if
+
+        codes[i] = it->second;
+        max_code |= codes[i];
+        max_vt |= p.verify_type;
+        max_vs |= p.verify_state;
+    } // end for
+
+    u64 max_machine{0};
+    for (auto &p : pending)
+        max_machine |= (u64)((s64)p.machine_num - hdr.machine_base);
+
+    hdr.dict_bytes = (u32)(buf.size() - sizeof(hdr));
+    hdr.w_time = Width(max_dod);
+    hdr.w_user = Width(max_code);
+    hdr.w_machine = Width(max_machine);
+    hdr.w_verify_type = Width(max_vt);
+    hdr.w_verify_state = Width(max_vs);
+
+    // pass 2: the columns
+    Bit_Writer bits(buf);
+    for (size_t i = 0; i + 1 < n; i++)
+        bits.Put(dods[i], hdr.w_time);
+    bits.Finish();
+
+    for (size_t i = 0; i < n; i++)
+        bits.Put(codes[i], hdr.w_user);
+    bits.Finish();
+
+    for (size_t i = 0; i < n; i++)
+        bits.Put((u64)((s64)pending[i].machine_num - hdr.machine_base), hdr.w_machine);
+    bits.Finish();
+
+    for (size_t i = 0; i < n; i++)
+        bits.Put(pending[i].verify_type, hdr.w_verify_type);
+    bits.Finish();
+
+    for (size_t i = 0; i < n; i++)
+        bits.Put(pending[i].verify_state, hdr.w_verify_state);
+    bits.Finish();
+
+    hdr.body_bytes = (u32)(buf.size() - sizeof(hdr) - hdr.dict_bytes);
+    hdr.crc = Crc32(buf.data() + sizeof(hdr), buf.size() - sizeof(hdr));
+    iCpy(buf.data(), &hdr, sizeof(hdr));
+
+    off_t start = lseek(fd, 0, SEEK_CUR);
+    if (start < 0)
+        return -1;
+
+    if (Write_Full(fd, buf.data(), buf.size()) < 0)
+    {
+        // a torn block would stop a reader short of every block after it
+        if (ftruncate(fd, start) < 0 || lseek(fd, start, SEEK_SET) < 0)
+        {
+            close(fd);
+            fd = -1;        // can't tell what's on the disk any more; no more blocks go after it
+        } // end if
+
+        return -1;
+    } // end if
+
+    dict.insert(fresh.begin(), fresh.end());
+    stats.punches += n;
+    ++stats.blocks;
+    stats.bytes += buf.size();
+    stats.users = dict.size();
+    pending.clear();
+
+    return 0;
+} // end Write_Block
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Adds a punch; a block is written out each time one fills up.
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+int Arc_Writer::Append(const Punch_Record &punch)
+{
+    if (fd < 0)
+        return -1;
+
+    pending.push_back(punch);
+    return pending.size() >= block_size ? Write_Block() : 0;
+} // end Append
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Adds a batch of punches.
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+int Arc_Writer::Append(const std::vector<Punch_Record> &punches)
+{
+    for (auto &punch : punches)
+    {
+        if (Append(punch) < 0)
+            return -1;
+    } // end for
+
+    return 0;
+} // end Append
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes out the buffered punches as a (short) block and syncs the file.
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+int Arc_Writer::Flush()
+{
+    if (fd < 0 || Write_Block() < 0)
+        return -1;
+
+    return fdatasync(fd);
+} // end Flush
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Flushes and closes the archive.
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+int Arc_Writer::Close()
+{
+    if (fd < 0)
+        return -1;
+
+    int r = Flush();
+    close(fd);
+    fd = -1;
+    pending.clear();
+
+    return r;
+} // end Close
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the writer counters.
+ */
+Arc_Stats Arc_Writer::Get_Stats() const
+{
+    return stats;
+} // end Get_Stats
+
+
+//==============================================================================================================|
+/**
+ * @brief Construct a new Arc_Reader object
+ */
+Arc_Reader::Arc_Reader()
+    : fd{-1}, size{0}, offset{0}
+{
+} // end constructor
+
+
+//==============================================================================================================|
+/**
+ * @brief Destroy the Arc_Reader object
+ */
+Arc_Reader::~Arc_Reader()
+{
+    Close();
+} // end destructor
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Opens an archive for reading.
+ *
+ * @param [path] the archive file
+ *
+ * @return int
+ *  0 on success, -1 on fail (no such file or not an archive)
+ */
+int Arc_Reader::Open(const std::string &path)
+{
+    if (fd >= 0)
+        return -1;
+
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    struct stat st;
+    Arc_File_Header hdr;
+    if (fstat(fd, &st) != 0 || Read_Full(fd, &hdr, sizeof(hdr)) != sizeof(hdr) || hdr.magic != ARC_FILE_MAGIC ||
+        hdr.version != ARC_VERSION)
+    {
+        Close();
+        return -1;
+    } // end if
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    size = (u64)st.st_size;
+    offset = sizeof(hdr);
+    dict.clear();
+    stats = Arc_Stats();
+    stats.bytes = sizeof(hdr);
+
+    return 0;
+} // end Open
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Takes in the dictionary entries of a block.
+ *
+ * @return int
+ *  0 on success, -1 when they don't add up
+ */
+int Arc_Reader::Read_Dict(const u8 *p, const u32 count, const u32 bytes)
+{
+    const u8 *end = p + bytes;
+
+    for (u32 i = 0; i < count; i++)
+    {
+        if (p + 3 > end || p + 3 + p[2] > end || p[2] >= PUNCH_USER_ID_SIZE)
+            return -1;
+
+        Dict_Entry entry;
+        memset(&entry, 0, sizeof(entry));
+        u16 serial;
+        iCpy(&serial, p, sizeof(serial));
+        entry.serial = RNTOHS(serial);
+        iCpy(entry.user_id, p + 3, p[2]);
+        dict.push_back(entry);
+
+        p += 3 + p[2];
+    } // end for
+
+    stats.users = dict.size();
+    return p == end ? 0 : -1;
+} // end Read_Dict
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Reads the next block that has punches in [from_time, to_time); blocks wholly outside are skipped over
+ *  without reading their columns (only their dictionary entries are taken in, and they go unchecked).
+ *
+ * @param [punches] gets the punches of the block, replacing what was there; those outside the window are
+ *  included, it's the block that's picked by time
+ * @param [from_time] window start
+ * @param [to_time] window end, not included
+ *
+ * @return int
+ *  the number of punches read, 0 at the end of the archive, -1 on a bad or torn block (Offset() tells where
+ *  the good part ends)
+ */
+int Arc_Reader::Read_Block(std::vector<Punch_Record> &punches, const u32 from_time, const u32 to_time)
+{
+    punches.clear();
+    if (fd < 0)
+        return -1;
+
+    for (;;)
+    {
+        Arc_Block_Header hdr;
+        ssize_t got = Read_Full(fd, &hdr, sizeof(hdr));
+        if (got == 0)
+            return 0;
+
+        if (got != sizeof(hdr) || hdr.magic != ARC_BLOCK_MAGIC || !hdr.count || hdr.count > ARC_MAX_BLOCK ||
+            offset + sizeof(hdr) + (u64)hdr.dict_bytes + hdr.body_bytes > size)
+            return -1;
+
+        size_t col_bytes = Column_Bytes(hdr.w_time, hdr.count - 1) + Column_Bytes(hdr.w_user, hdr.count) +
+            Column_Bytes(hdr.w_machine, hdr.count) + Column_Bytes(hdr.w_verify_type, hdr.count) +
+            Column_Bytes(hdr.w_verify_state, hdr.count);
+        if (col_bytes != hdr.body_bytes || hdr.w_time > 40 || hdr.w_user > 32 || hdr.w_machine > 33 ||
+            hdr.w_verify_type > 8 || hdr.w_verify_state > 8)
+            return -1;
+
+        bool bwanted = hdr.max_time >= from_time && hdr.min_time < to_time;
+        size_t want = hdr.dict_bytes + (bwanted ? hdr.body_bytes : 0);
+
+        buf.resize(want + ARC_PAD);
+        if (Read_Full(fd, buf.data(), want) != (ssize_t)want)
+            return -1;
+        memset(buf.data() + want, 0, ARC_PAD);
+
+        if (!bwanted)
+        {
+            if (Read_Dict(buf.data(), hdr.dict_count, hdr.dict_bytes) < 0 ||
+                lseek(fd, hdr.body_bytes, SEEK_CUR) < 0)
+                return -1;
+
+            offset += sizeof(hdr) + hdr.dict_bytes + hdr.body_bytes;
+            stats.bytes += sizeof(hdr) + hdr.dict_bytes + hdr.body_bytes;
+            ++stats.skipped;
+            continue;
+        } // end if
+
+        if (Crc32(buf.data(), want) != hdr.crc || Read_Dict(buf.data(), hdr.dict_count, hdr.dict_bytes) < 0)
+            return -1;
+
+        // the columns, one pass each
+        u32 n = hdr.count;
+        const u8 *pcol = buf.data() + hdr.dict_bytes;
+        punches.resize(n);
+        Punch_Record *pout = punches.data();
+
+        u64 mask = hdr.w_time ? (~0ULL >> (64 - hdr.w_time)) : 0;
+        s64 t = hdr.first_time, delta{0};
+        pout[0].att_time = hdr.first_time;
+        for (u32 i = 1; i < n; i++)
+        {
+            u64 zz = Get(pcol, i - 1, hdr.w_time, mask);
+            delta += UNZIGZAG(zz);
+            t += delta;
+            pout[i].att_time = (u32)t;
+        } // end for
+        pcol += Column_Bytes(hdr.w_time, n - 1);
+
+        mask = hdr.w_user ? (~0ULL >> (64 - hdr.w_user)) : 0;
+        const Dict_Entry *pdict = dict.data();
+        u64 ncodes = dict.size();
+        for (u32 i = 0; i < n; i++)
+        {
+            u64 code = Get(pcol, i, hdr.w_user, mask);
+            if (code >= ncodes)
+                return -1;
+
+            iCpy(pout[i].user_id, pdict[code].user_id, sizeof(pout[i].user_id));
+            pout[i].serial = pdict[code].serial;
+        } // end for
+        pcol += Column_Bytes(hdr.w_user, n);
+
+        mask = hdr.w_machine ? (~0ULL >> (64 - hdr.w_machine)) : 0;
+        for (u32 i = 0; i < n; i++)
+            pout[i].machine_num = (s32)((s64)hdr.machine_base + (s64)Get(pcol, i, hdr.w_machine, mask));
+        pcol += Column_Bytes(hdr.w_machine, n);
+
+        mask = hdr.w_verify_type ? (~0ULL >> (64 - hdr.w_verify_type)) : 0;
+        for (u32 i = 0; i < n; i++)
+            pout[i].verify_type = (u8)Get(pcol, i, hdr.w_verify_type, mask);
+        pcol += Column_Bytes(hdr.w_verify_type, n);
+
+        mask = hdr.w_verify_state ? (~0ULL >> (64 - hdr.w_verify_state)) : 0;
+        for (u32 i = 0; i < n; i++)
+            pout[i].verify_state = (u8)Get(pcol, i, hdr.w_verify_state, mask);
+
+        offset += sizeof(hdr) + want;
+        stats.bytes += sizeof(hdr) + want;
+        stats.punches += n;
+        ++stats.blocks;
+
+        return (int)n;
+    } // end for
+} // end Read_Block
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Closes the archive.
+ *
+ * @return int
+ *  0 on success, -1 if not open
+ */
+int Arc_Reader::Close()
+{
+    if (fd < 0)
+        return -1;
+
+    close(fd);
+    fd = -1;
+    return 0;
+} // end Close
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Where the last block read (or skipped) ends; after a bad block, where the good part of the archive ends.
+ */
+u64 Arc_Reader::Offset() const
+{
+    return offset;
+} // end Offset
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The dictionary as taken in so far.
+ */
+const std::vector<Arc_Reader::Dict_Entry> &Arc_Reader::Dictionary() const
+{
+    return dict;
+} // end Dictionary
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the reader counters.
+ */
+Arc_Stats Arc_Reader::Get_Stats() const
+{
+    return stats;
+} // end Get_Stats
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
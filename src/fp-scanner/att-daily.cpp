@@ -0,0 +1,464 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for the daily aggregator. The figures of a day are what a walk over its punches in
+//  time order gives (Step); a punch on the end is one more step, a late one has the walk done over. Days and
+//  durations are worked out on the calendar (Real_Secs), not on the device's 31 day months, thus a shift over
+//  the end of a short month stays in one day and is timed right.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "att-daily.h"
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define DAY_KEY(code, day)      (((u64)(code) << 32) | (day))
+#define ATT_DAILY_MARKS         8           // room for a typical day's punches up front
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Days from the 1st of January 2000 to a date on the (proleptic) Gregorian calendar.
+ */
+static u32 Civil_Days(const u32 yr, const u32 mon, const u32 day)
+{
+    // years start in March, thus the leap day comes last
+    u32 y = mon <= 2 ? yr - 1 : yr;
+    u32 era = y / 400;
+    u32 yoe = y - era * 400;
+    u32 doy = (153 * (mon > 2 ? mon - 3 : mon + 9) + 2) / 5 + day - 1;
+    u32 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + doe - 730425;      // 730425 days from 0000-03-01 to 2000-01-01
+} // end Civil_Days
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Seconds since 2000-01-01 00:00 of an att_time, which the device counts in 31 day months.
+ */
+static u64 Real_Secs(const u32 att_time)
+{
+    u32 days = att_time / 86400;
+    u32 day = days % 31 + 1;
+    u32 mon = (days / 31) % 12 + 1;
+    u32 yr = days / (31 * 12) + 2000;
+
+    return (u64)Civil_Days(yr, mon, day) * 86400 + att_time % 86400;
+} // end Real_Secs
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief Construct a new Att_Daily object
+ *
+ * @param [pairing] how punches pair up
+ * @param [day_start] seconds past midnight a day starts at; less than a day
+ */
+Att_Daily::Att_Daily(const Att_Pairing pairing, const u32 day_start)
+    : pairing{pairing}, day_start{day_start % 86400}
+{
+} // end constructor
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Takes in a punch; caller holds the lock.
+ */
+void Att_Daily::Put(const Punch_Record &punch)
+{
+    std::string key(punch.user_id, strnlen(punch.user_id, sizeof(punch.user_id)));
+    auto it = codes.find(key);
+    u32 code;
+
+    if (it == codes.end())
+    {
+        code = (u32)names.size();
+        codes.emplace(key, code);
+        names.push_back(key);
+    } // end if
+    else
+        code = it->second;
+
+    u32 day = Day_Of(punch.att_time);
+    auto ins = states.emplace(DAY_KEY(code, day), Day_State());
+    Day_State &state = ins.first->second;
+
+    if (ins.second)
+    {
+        state.marks.reserve(ATT_DAILY_MARKS);
+        by_day[day].push_back(code);
+    } // end if
+
+    Mark mark;
+    mark.att_time = punch.att_time;
+    mark.verify_state = punch.verify_state;
+
+    if (state.marks.empty() || mark.att_time > state.marks.back().att_time)
+    {
+        state.marks.push_back(mark);
+        Step(state, mark);
+    } // end if
+    else
+    {
+        auto pos = std::upper_bound(state.marks.begin(), state.marks.end(), mark.att_time,
+            [](const u32 t, const Mark &m) { return t < m.att_time; });
+
+        for (auto p = pos; p != state.marks.begin() && (p - 1)->att_time == mark.att_time; --p)
+        {
+            if ((p - 1)->verify_state == mark.verify_state)
+            {
+                ++stats.repeats;
+                return;
+            } // end if
+        } // end for
+
+        state.marks.insert(pos, mark);
+
+        // walk the day over
+        state.first_in = state.last_out = state.worked = state.open_since = 0;
+        state.bopen = false;
+        for (const Mark &m : state.marks)
+            Step(state, m);
+
+        ++stats.late;
+    } // end else
+
+    ++stats.punches;
+    if (listener)
+    {
+        Att_Day out;
+        Fill(code, day, state, out);
+        listener(out, listener_arg);
+    } // end if
+} // end Put
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Moves a day's figures on by a punch; punches come in time order.
+ */
+void Att_Daily::Step(Day_State &state, const Mark &mark) const
+{
+    bool bin = pairing == ATT_PAIR_ALTERNATE ? !state.bopen :
+        mark.verify_state != ATT_STATE_CHECK_OUT && mark.verify_state != ATT_STATE_BREAK_OUT &&
+        mark.verify_state != ATT_STATE_OT_OUT;
+
+    if (bin)
+    {
+        if (!state.bopen)
+        {
+            state.bopen = true;
+            state.open_since = mark.att_time;
+        } // end if
+
+        if (!state.first_in)
+            state.first_in = mark.att_time;
+    } // end if
+    else
+    {
+        if (state.bopen)
+        {
+            state.worked += (u32)(Real_Secs(mark.att_time) - Real_Secs(state.open_since));
+            state.bopen = false;
+        } // end if
+
+        state.last_out = mark.att_time;
+    } // end else
+} // end Step
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Copies a day's figures out.
+ */
+void Att_Daily::Fill(const u32 code, const u32 day, const Day_State &state, Att_Day &out) const
+{
+    const std::string &name = names[code];
+    size_t len = std::min(name.size(), sizeof(out.user_id) - 1);
+
+    iCpy(out.user_id, name.data(), len);
+    out.user_id[len] = 0;
+    out.day = day;
+    out.first_in = state.first_in;
+    out.last_out = state.last_out;
+    out.worked = state.worked;
+    out.punches = (u16)std::min(state.marks.size(), (size_t)0xffff);
+    out.bopen = state.bopen;
+} // end Fill
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Takes in a punch.
+ *
+ * @param [punch] the punch
+ */
+void Att_Daily::Add(const Punch_Record &punch)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    Put(punch);
+} // end Add
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Takes in a batch of punches, in any order.
+ *
+ * @param [punches] the punches
+ */
+void Att_Daily::Add(const std::vector<Punch_Record> &punches)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    for (const Punch_Record &punch : punches)
+        Put(punch);
+} // end Add
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  A pfn_Punch_Sink; arg is the Att_Daily. Fits behind Punch_Dedup or Fleet_Merge_Attendance.
+ */
+void Att_Daily::On_Punches(const Punch_Record *ppunches, const size_t count, void *arg)
+{
+    Att_Daily *pdaily = (Att_Daily*)arg;
+    std::lock_guard<std::mutex> guard(pdaily->lock);
+
+    for (size_t i = 0; i < count; i++)
+        pdaily->Put(ppunches[i]);
+} // end On_Punches
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Event bus handler; arg is the Att_Daily. Subscribe with RT_ATTLOG.
+ */
+void Att_Daily::On_Events(const Event_Record *precs, const size_t count, void *arg)
+{
+    Att_Daily *pdaily = (Att_Daily*)arg;
+    std::lock_guard<std::mutex> guard(pdaily->lock);
+    Punch_Record punch;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (Punch_From_Event(precs[i], punch))
+            pdaily->Put(punch);
+    } // end for
+} // end On_Events
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Sets who's told of every change to a day's figures, say a dashboard feed.
+ *
+ * @param [listener] the callback; nullptr for none
+ * @param [arg] passed to listener
+ */
+void Att_Daily::Set_Listener(pfn_Att_Day_Changed listener, void *arg)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    this->listener = listener;
+    listener_arg = arg;
+} // end Set_Listener
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the figures of a user's day.
+ *
+ * @param [user_id] the user
+ * @param [day] the day (see Day_Of)
+ * @param [out] gets the figures
+ *
+ * @return int
+ *  0 on success, -1 if the user has no punches that day
+ */
+int Att_Daily::Get(const std::string &user_id, const u32 day, Att_Day &out)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto it = codes.find(user_id);
+    if (it == codes.end())
+        return -1;
+
+    auto st = states.find(DAY_KEY(it->second, day));
+    if (st == states.end())
+        return -1;
+
+    Fill(it->second, day, st->second, out);
+    return 0;
+} // end Get
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the figures of everyone with punches on a day.
+ *
+ * @param [day] the day
+ * @param [out] gets the figures, appended
+ *
+ * @return size_t
+ *  the number of users
+ */
+size_t Att_Daily::Scan_Day(const u32 day, std::vector<Att_Day> &out)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto it = by_day.find(day);
+    if (it == by_day.end())
+        return 0;
+
+    size_t first = out.size();
+    out.resize(first + it->second.size());
+    for (size_t i = 0; i < it->second.size(); i++)
+    {
+        u32 code = it->second[i];
+        Fill(code, day, states[DAY_KEY(code, day)], out[first + i]);
+    } // end for
+
+    return it->second.size();
+} // end Scan_Day
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the figures of a user's days in a range, in day order; days without punches are left out.
+ *
+ * @param [user_id] the user
+ * @param [from_day] range start
+ * @param [to_day] range end, not included; at most ATT_DAILY_SCAN_DAYS after from_day
+ * @param [out] gets the figures, appended
+ *
+ * @return size_t
+ *  the number of days
+ */
+size_t Att_Daily::Scan_User(const std::string &user_id, const u32 from_day, const u32 to_day,
+    std::vector<Att_Day> &out)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    size_t n{0};
+
+    auto it = codes.find(user_id);
+    if (it == codes.end() || from_day >= to_day)
+        return 0;
+
+    u32 end = to_day - from_day > ATT_DAILY_SCAN_DAYS ? from_day + ATT_DAILY_SCAN_DAYS : to_day;
+    for (u32 day = from_day; day < end; day++)
+    {
+        auto st = states.find(DAY_KEY(it->second, day));
+        if (st == states.end())
+            continue;
+
+        out.emplace_back();
+        Fill(it->second, day, st->second, out.back());
+        ++n;
+    } // end for
+
+    return n;
+} // end Scan_User
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The day an att_time counts to; days since 2000-01-01 on the calendar, less the day start.
+ */
+u32 Att_Daily::Day_Of(const u32 att_time) const
+{
+    u64 secs = Real_Secs(att_time);
+    return secs < day_start ? 0 : (u32)((secs - day_start) / 86400);
+} // end Day_Of
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The day of a date, as Day_Of counts them; a day that starts at day_start on the date.
+ */
+u32 Att_Daily::Day_Number(const u32 yr, const u32 mon, const u32 day)
+{
+    return Civil_Days(yr, mon, day);
+} // end Day_Number
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Forgets the days before one; a punch for them that comes in later starts the day afresh.
+ *
+ * @param [day] the first day kept
+ *
+ * @return int
+ *  the number of (user, day) dropped
+ */
+int Att_Daily::Drop_Before(const u32 day)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    int dropped{0};
+
+    for (auto it = by_day.begin(); it != by_day.end() && it->first < day; )
+    {
+        for (u32 code : it->second)
+            states.erase(DAY_KEY(code, it->first));
+
+        dropped += (int)it->second.size();
+        it = by_day.erase(it);
+    } // end for
+
+    return dropped;
+} // end Drop_Before
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the aggregator counters.
+ */
+Att_Daily_Stats Att_Daily::Get_Stats()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    Att_Daily_Stats out = stats;
+
+    out.users = names.size();
+    out.days = states.size();
+    return out;
+} // end Get_Stats
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
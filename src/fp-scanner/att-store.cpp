@@ -0,0 +1,546 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for the columnar attendance store. Punches that come in time order (the usual case
+//  for a single device) are appended to the sorted part of their segment as is; those that don't pile up after
+//  it and are sorted and merged in by the next query that touches the segment. Scans pick the row range by
+//  binary search on the time column and filter it with branch free loops over the user or device column.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "att-store.h"
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Reorders a column by a permutation; dest[i] = src[perm[i]].
+ */
+template<typename T>
+static void Gather(std::vector<T> &col, const std::vector<u32> &perm)
+{
+    std::vector<T> out(col.size());
+    for (size_t i = 0; i < perm.size(); i++)
+        out[i] = col[perm[i]];
+
+    col.swap(out);
+} // end Gather
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief Construct a new Att_Store object
+ *
+ * @param [span] the att_time a segment covers; a day by default
+ */
+Att_Store::Att_Store(const u32 span)
+    : span{span ? span : ATT_STORE_SPAN}
+{
+} // end constructor
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Adds a punch to its segment; caller holds the lock.
+ */
+void Att_Store::Put(const Punch_Record &punch)
+{
+    std::string key(punch.user_id, strnlen(punch.user_id, sizeof(punch.user_id)));
+    auto it = codes.find(key);
+    u32 code;
+
+    if (it == codes.end())
+    {
+        code = (u32)names.size();
+        codes.emplace(key, code);
+        names.push_back(key);
+    } // end if
+    else
+        code = it->second;
+
+    Segment &seg = segments[punch.att_time / span];
+    size_t row = seg.times.size();
+    bool bin_order = (seg.nsorted == row) && (!row || seg.times.back() <= punch.att_time);
+
+    seg.times.push_back(punch.att_time);
+    seg.users.push_back(code);
+    seg.machines.push_back(punch.machine_num);
+    seg.serials.push_back(punch.serial);
+    seg.verify_types.push_back(punch.verify_type);
+    seg.verify_states.push_back(punch.verify_state);
+    ++nrows;
+
+    if (bin_order)
+    {
+        seg.nsorted = row + 1;
+        if (seg.bindexed)
+            seg.by_user[code].push_back((u32)row);
+    } // end if
+} // end Put
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Sorts the rows added out of order and merges them in with the rest; caller holds the lock. Punches with
+ *  the same att_time keep the order they were added in.
+ */
+void Att_Store::Prepare(Segment &seg)
+{
+    size_t n = seg.times.size();
+    if (seg.nsorted == n)
+        return;
+
+    const std::vector<u32> &times = seg.times;
+    auto by_time = [&times](const u32 a, const u32 b) { return times[a] < times[b]; };
+
+    std::vector<u32> tail(n - seg.nsorted);
+    for (size_t i = 0; i < tail.size(); i++)
+        tail[i] = (u32)(seg.nsorted + i);
+    std::stable_sort(tail.begin(), tail.end(), by_time);
+
+    std::vector<u32> perm(n);
+    size_t a{0}, b{0}, k{0};
+    while (a < seg.nsorted && b < tail.size())
+        perm[k++] = times[tail[b]] < times[a] ? tail[b++] : (u32)a++;
+    while (a < seg.nsorted)
+        perm[k++] = (u32)a++;
+    while (b < tail.size())
+        perm[k++] = tail[b++];
+
+    Gather(seg.times, perm);
+    Gather(seg.users, perm);
+    Gather(seg.machines, perm);
+    Gather(seg.serials, perm);
+    Gather(seg.verify_types, perm);
+    Gather(seg.verify_states, perm);
+
+    seg.nsorted = n;
+    seg.bindexed = false;
+} // end Prepare
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Brings the user index of a segment up to date; caller holds the lock.
+ */
+void Att_Store::Index(Segment &seg)
+{
+    Prepare(seg);
+    if (seg.bindexed)
+        return;
+
+    seg.by_user.clear();
+    for (size_t i = 0; i < seg.users.size(); i++)
+        seg.by_user[seg.users[i]].push_back((u32)i);
+
+    seg.bindexed = true;
+} // end Index
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Finds the rows of a segment in [from_time, to_time); caller holds the lock.
+ */
+void Att_Store::Range(Segment &seg, const u32 from_time, const u32 to_time, size_t &lo, size_t &hi)
+{
+    Prepare(seg);
+    lo = std::lower_bound(seg.times.begin(), seg.times.end(), from_time) - seg.times.begin();
+    hi = std::lower_bound(seg.times.begin() + lo, seg.times.end(), to_time) - seg.times.begin();
+} // end Range
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Puts a row back together as a punch.
+ */
+void Att_Store::Emit(const Segment &seg, const u32 row, Punch_Record &punch) const
+{
+    const std::string &name = names[seg.users[row]];
+
+    memset(punch.user_id, 0, sizeof(punch.user_id));
+    iCpy(punch.user_id, name.data(), name.size());
+    punch.att_time = seg.times[row];
+    punch.machine_num = seg.machines[row];
+    punch.serial = seg.serials[row];
+    punch.verify_type = seg.verify_types[row];
+    punch.verify_state = seg.verify_states[row];
+} // end Emit
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Adds a punch.
+ */
+void Att_Store::Add(const Punch_Record &punch)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    Put(punch);
+} // end Add
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Adds a batch of punches.
+ */
+void Att_Store::Add(const std::vector<Punch_Record> &punches)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    for (auto &punch : punches)
+        Put(punch);
+} // end Add
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Adds a device's downloaded log.
+ *
+ * @param [machine_num] the device the log came from
+ * @param [entries] what Read_Attendance_Record returned
+ */
+void Att_Store::Add_Entries(const int machine_num, const std::vector<Attendance_Entry> &entries)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    Punch_Record punch;
+
+    for (auto &entry : entries)
+    {
+        Punch_From_Entry(machine_num, entry, punch);
+        Put(punch);
+    } // end for
+} // end Add_Entries
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  An event bus subscriber (see Event_Subscribe) that adds the realtime attendance transactions to the store
+ *  given as arg; subscribe with RT_ATTLOG.
+ */
+void Att_Store::On_Events(const Event_Record *precs, const size_t count, void *arg)
+{
+    Att_Store *pstore = (Att_Store*)arg;
+    std::lock_guard<std::mutex> guard(pstore->lock);
+    Punch_Record punch;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (Punch_From_Event(precs[i], punch))
+            pstore->Put(punch);
+    } // end for
+} // end On_Events
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Counts the punches in a time range; binary searches only.
+ *
+ * @param [from_time] range start (att_time)
+ * @param [to_time] range end, not included
+ *
+ * @return size_t
+ *  the number of punches
+ */
+size_t Att_Store::Count(const u32 from_time, const u32 to_time)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    size_t total{0};
+
+    if (from_time >= to_time)
+        return 0;
+
+    for (auto it = segments.lower_bound(from_time / span); it != segments.end() && it->first <= (to_time - 1) / span;
+        ++it)
+    {
+        size_t lo, hi;
+        Range(it->second, from_time, to_time, lo, hi);
+        total += hi - lo;
+    } // end for
+
+    return total;
+} // end Count
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the punches in a time range in time order.
+ *
+ * @param [from_time] range start (att_time)
+ * @param [to_time] range end, not included
+ * @param [out] gets the punches; appended to
+ *
+ * @return size_t
+ *  the number of punches found
+ */
+size_t Att_Store::Scan(const u32 from_time, const u32 to_time, std::vector<Punch_Record> &out)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    size_t base = out.size();
+
+    if (from_time >= to_time)
+        return 0;
+
+    for (auto it = segments.lower_bound(from_time / span); it != segments.end() && it->first <= (to_time - 1) / span;
+        ++it)
+    {
+        size_t lo, hi;
+        Range(it->second, from_time, to_time, lo, hi);
+
+        size_t k = out.size();
+        out.resize(k + (hi - lo));
+        for (size_t r = lo; r < hi; r++)
+            Emit(it->second, (u32)r, out[k++]);
+    } // end for
+
+    return out.size() - base;
+} // end Scan
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the punches of a set of users (a department say) in a time range, in time order. A handful of users
+ *  are looked up through the user index, more than that are picked out in one pass down the user column.
+ *
+ * @param [user_ids] the users wanted
+ * @param [from_time] range start (att_time)
+ * @param [to_time] range end, not included
+ * @param [out] gets the punches; appended to
+ *
+ * @return size_t
+ *  the number of punches found
+ */
+size_t Att_Store::Scan_Users(const std::vector<std::string> &user_ids, const u32 from_time, const u32 to_time,
+    std::vector<Punch_Record> &out)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    size_t base = out.size();
+
+    std::vector<u32> wanted;
+    for (auto &id : user_ids)
+    {
+        auto it = codes.find(id);
+        if (it != codes.end())
+            wanted.push_back(it->second);
+    } // end for
+
+    if (wanted.empty() || from_time >= to_time)
+        return 0;
+
+    std::sort(wanted.begin(), wanted.end());
+    wanted.erase(std::unique(wanted.begin(), wanted.end()), wanted.end());
+
+    std::vector<u8> bwant;
+    if (wanted.size() > ATT_STORE_INDEX_USERS)
+    {
+        bwant.assign(names.size(), 0);
+        for (u32 code : wanted)
+            bwant[code] = 1;
+    } // end if
+
+    std::vector<u32> sel;
+    for (auto it = segments.lower_bound(from_time / span); it != segments.end() && it->first <= (to_time - 1) / span;
+        ++it)
+    {
+        Segment &seg = it->second;
+        size_t lo, hi, n{0};
+
+        if (bwant.empty())
+        {
+            Index(seg);
+            sel.clear();
+            for (u32 code : wanted)
+            {
+                auto pit = seg.by_user.find(code);
+                if (pit == seg.by_user.end())
+                    continue;
+
+                // the rows of a user are in time order, thus so are their times
+                const std::vector<u32> &rows = pit->second;
+                auto first = std::lower_bound(rows.begin(), rows.end(), from_time,
+                    [&seg](const u32 row, const u32 t) { return seg.times[row] < t; });
+                auto last = std::lower_bound(first, rows.end(), to_time,
+                    [&seg](const u32 row, const u32 t) { return seg.times[row] < t; });
+                sel.insert(sel.end(), first, last);
+            } // end for
+
+            std::sort(sel.begin(), sel.end());      // rows in time order
+            n = sel.size();
+        } // end if
+        else
+        {
+            Range(seg, from_time, to_time, lo, hi);
+            sel.resize(hi - lo);
+
+            const u32 *pusers = seg.users.data();
+            const u8 *pwant = bwant.data();
+            u32 *psel = sel.data();
+            for (size_t r = lo; r < hi; r++)
+            {
+                psel[n] = (u32)r;
+                n += pwant[pusers[r]];
+            } // end for
+        } // end else
+
+        size_t k = out.size();
+        out.resize(k + n);
+        for (size_t i = 0; i < n; i++)
+            Emit(seg, sel[i], out[k++]);
+    } // end for
+
+    return out.size() - base;
+} // end Scan_Users
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the punches taken at a set of devices in a time range, in time order.
+ *
+ * @param [machines] the devices wanted
+ * @param [from_time] range start (att_time)
+ * @param [to_time] range end, not included
+ * @param [out] gets the punches; appended to
+ *
+ * @return size_t
+ *  the number of punches found
+ */
+size_t Att_Store::Scan_Machines(const std::vector<int> &machines, const u32 from_time, const u32 to_time,
+    std::vector<Punch_Record> &out)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    size_t base = out.size();
+
+    if (machines.empty() || from_time >= to_time)
+        return 0;
+
+    std::vector<s32> wanted(machines.begin(), machines.end());
+    std::sort(wanted.begin(), wanted.end());
+
+    std::vector<u32> sel;
+    for (auto it = segments.lower_bound(from_time / span); it != segments.end() && it->first <= (to_time - 1) / span;
+        ++it)
+    {
+        Segment &seg = it->second;
+        size_t lo, hi, n{0};
+
+        Range(seg, from_time, to_time, lo, hi);
+        sel.resize(hi - lo);
+
+        const s32 *pmachines = seg.machines.data();
+        u32 *psel = sel.data();
+        if (wanted.size() == 1)
+        {
+            s32 m = wanted[0];
+            for (size_t r = lo; r < hi; r++)
+            {
+                psel[n] = (u32)r;
+                n += (pmachines[r] == m);
+            } // end for
+        } // end if
+        else
+        {
+            for (size_t r = lo; r < hi; r++)
+            {
+                psel[n] = (u32)r;
+                n += std::binary_search(wanted.begin(), wanted.end(), pmachines[r]);
+            } // end for
+        } // end else
+
+        size_t k = out.size();
+        out.resize(k + n);
+        for (size_t i = 0; i < n; i++)
+            Emit(seg, sel[i], out[k++]);
+    } // end for
+
+    return out.size() - base;
+} // end Scan_Machines
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Drops the segments that end before att_time; for keeping only so much history in memory.
+ *
+ * @param [att_time] the oldest time to keep
+ *
+ * @return int
+ *  the number of segments dropped
+ */
+int Att_Store::Drop_Before(const u32 att_time)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    int dropped{0};
+
+    for (auto it = segments.begin(); it != segments.end() && ((u64)it->first + 1) * span <= att_time; )
+    {
+        nrows -= it->second.times.size();
+        it = segments.erase(it);
+        ++dropped;
+    } // end for
+
+    return dropped;
+} // end Drop_Before
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the store counters.
+ */
+Att_Store_Stats Att_Store::Get_Stats()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    Att_Store_Stats stats;
+
+    stats.rows = nrows;
+    stats.segments = segments.size();
+    stats.users = names.size();
+
+    for (auto &it : segments)
+    {
+        const Segment &seg = it.second;
+        stats.bytes += seg.times.capacity() * sizeof(u32) + seg.users.capacity() * sizeof(u32) +
+            seg.machines.capacity() * sizeof(s32) + seg.serials.capacity() * sizeof(u16) +
+            seg.verify_types.capacity() + seg.verify_states.capacity();
+        for (auto &rows : seg.by_user)
+            stats.bytes += rows.second.capacity() * sizeof(u32);
+    } // end for
+
+    for (auto &name : names)
+        stats.bytes += name.capacity();
+
+    return stats;
+} // end Get_Stats
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
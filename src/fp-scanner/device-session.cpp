@@ -0,0 +1,86 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for class Maintenance_Session.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "device-session.h"
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief Construct a new Maintenance_Session object
+ *  takes hold of (disables) the device; check Is_Held() to see if that went through.
+ *
+ * @param [machine_num] the machine identifier
+ */
+Maintenance_Session::Maintenance_Session(const int machine_num)
+    : machine_num{machine_num}, bheld{false}
+{
+    bheld = (Hold_Device(machine_num) == 0);
+} // end constructor
+
+
+//==============================================================================================================|
+/**
+ * @brief Destroy the Maintenance_Session object
+ *  gives the device back to its users unless already done so.
+ */
+Maintenance_Session::~Maintenance_Session()
+{
+    Release();
+} // end destructor
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  tells if the device is held by this session.
+ *
+ * @return bool
+ *  true if held
+ */
+bool Maintenance_Session::Is_Held() const
+{
+    return bheld;
+} // end Is_Held
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Lets go of the device before the session goes out of scope; useful when the caller wants to know if the
+ *  enable went through.
+ *
+ * @return int
+ *  0 on success alas -ve on fail
+ */
+int Maintenance_Session::Release()
+{
+    if (!bheld)
+        return 0;
+
+    bheld = false;
+    return Release_Device(machine_num);
+} // end Release
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,683 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for the realtime event bus. Each subscriber owns a bounded ring of slots that carry
+//  their own sequence number (the well known bounded MPMC queue of D. Vyukov, used here with one consumer);
+//  producers claim a slot with a single compare and swap on the head and publish it by bumping the slot
+//  sequence. The consumer only sleeps when its ring runs dry and producers only touch its lock to wake it from
+//  there, so a busy subscriber is never signaled per event.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "event-bus.h"
+#include "journal.h"
+#include "shm-ring.h"
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define CACHE_LINE          64
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  A ring slot; seq tells who may touch it next. seq == pos means free for the producer at pos, seq == pos + 1
+ *  means filled and waiting on the consumer.
+ */
+typedef struct Event_Slot_Info
+{
+    std::atomic<u64> seq;
+    Event_Record rec;
+} Event_Slot;
+
+
+
+/**
+ * @brief
+ *  A subscriber and its ring; head is shared by the producers, tail belongs to the consumer alone, thus the
+ *  two are kept on cache lines of their own.
+ */
+typedef struct Event_Subscriber_Info
+{
+    std::atomic<u64> head{0};               // next slot to claim
+    u8 pad1[CACHE_LINE - sizeof(std::atomic<u64>)];
+    u64 tail{0};                            // next slot to consume
+    u8 pad2[CACHE_LINE - sizeof(u64)];
+
+    Event_Slot *pslots{nullptr};
+    u64 mask{0};                            // capacity - 1
+    pfn_Event_Handler handler{nullptr};
+    void *arg{nullptr};
+    Realtime_Mask filter{RT_NONE};          // events wanted
+
+    std::atomic<bool> bsleeping{false};     // consumer is (about to be) waiting on cv
+    bool bstop{false};                      // guarded by lock
+    std::mutex lock;
+    std::condition_variable cv;
+    std::thread *pthread{nullptr};
+
+    std::atomic<u64> delivered{0};
+    std::atomic<u64> dropped{0};
+    std::atomic<u64> batches{0};
+} Event_Sub;
+
+
+
+/**
+ * @brief
+ *  The event layouts as they come off the wire (the attendance one is Att_Realtime_Log)
+ */
+#pragma pack(1)
+typedef struct Wire_Enroll_Info
+{
+    u16 result;
+    u16 serial;
+} Wire_Enroll;
+
+
+typedef struct Wire_Enroll_Finger_Info
+{
+    u16 result;
+    u16 size;
+    u16 serial;
+    u8 finger_index;
+} Wire_Enroll_Finger;
+
+
+typedef struct Wire_Button_Info
+{
+    u16 key;
+} Wire_Button;
+
+
+typedef struct Wire_Unlock_Info
+{
+    u32 serial;
+} Wire_Unlock;
+
+
+typedef struct Wire_Verify_Info
+{
+    u32 serial;
+} Wire_Verify;
+
+
+typedef struct Wire_Score_Info
+{
+    u8 score;
+} Wire_Score;
+
+
+typedef struct Wire_Alarm_Info
+{
+    u16 type;
+    u16 serial;
+    u32 verified;
+} Wire_Alarm;
+#pragma pack()
+
+
+
+/**
+ * @brief
+ *  Decodes a packet into the record; returns false when it can't.
+ */
+typedef bool (*pfn_Decoder)(Event_Record &rec, const u8 *pdata, const u32 len);
+
+
+
+//==============================================================================================================|
+// PROTOTYPES
+//==============================================================================================================|
+static void Convert_Att(const Att_Realtime_Log &wire, Event_Att &att);
+static void Convert_Enroll(const Wire_Enroll &wire, Event_Enroll &enroll);
+static void Convert_Enroll_Finger(const Wire_Enroll_Finger &wire, Event_Enroll_Finger &enroll);
+static void Convert_Button(const Wire_Button &wire, Event_Button &button);
+static void Convert_Unlock(const Wire_Unlock &wire, Event_Unlock &unlock);
+static void Convert_Verify(const Wire_Verify &wire, Event_Verify &verify);
+static void Convert_Score(const Wire_Score &wire, Event_Score &score);
+static void Convert_Alarm(const Wire_Alarm &wire, Event_Alarm &alarm);
+
+template<typename W, typename D, void (*Convert)(const W&, D&)>
+static bool Decode_As(Event_Record &rec, const u8 *pdata, const u32 len);
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+// the table below is indexed by the bit each EF_XXX code sets
+static_assert(EF_ATTLOG == 1 << 0 && EF_FINGER == 1 << 1 && EF_ENROLLUSER == 1 << 2 && EF_ENROLLFINGER == 1 << 3 &&
+    EF_BUTTON == 1 << 4 && EF_UNLOCK == 1 << 5 && EF_VERIFY == 1 << 7 && EF_FPFTR == 1 << 8 && EF_ALARM == 1 << 9,
+    "the event dispatch table is out of step with the EF_XXX codes");
+static_assert(sizeof(Event_Record) == 64, "an event record should fill a cache line");
+
+static const pfn_Decoder decoders[16] =
+{
+    Decode_As<Att_Realtime_Log, Event_Att, Convert_Att>,                            // EF_ATTLOG
+    nullptr,                                                                        // EF_FINGER; no data
+    Decode_As<Wire_Enroll, Event_Enroll, Convert_Enroll>,                           // EF_ENROLLUSER
+    Decode_As<Wire_Enroll_Finger, Event_Enroll_Finger, Convert_Enroll_Finger>,      // EF_ENROLLFINGER
+    Decode_As<Wire_Button, Event_Button, Convert_Button>,                           // EF_BUTTON
+    Decode_As<Wire_Unlock, Event_Unlock, Convert_Unlock>,                           // EF_UNLOCK
+    nullptr,
+    Decode_As<Wire_Verify, Event_Verify, Convert_Verify>,                           // EF_VERIFY
+    Decode_As<Wire_Score, Event_Score, Convert_Score>,                              // EF_FPFTR
+    Decode_As<Wire_Alarm, Event_Alarm, Convert_Alarm>,                              // EF_ALARM
+};
+
+static std::atomic<Event_Sub*> subs[EVENT_MAX_SUBSCRIBERS];     // the subscribers by id
+static std::atomic<u32> publishing{0};          // publishers walking subs right now
+static std::atomic<u64> bus_seq{0};             // order of publication
+static std::mutex sub_lock;                     // guards subscribing and unsubscribing only
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Converts an event from the way it comes off the wire into its decoded layout (see event-bus.h).
+ */
+static void Convert_Att(const Att_Realtime_Log &wire, Event_Att &att)
+{
+    // the user id runs into the unused bytes on devices with wider pins
+    iCpy(att.user_id, wire.user_id, sizeof(att.user_id) - 1);
+    att.user_id[sizeof(att.user_id) - 1] = '\0';
+    att.verify_type = wire.verifyType;
+    att.status = wire.status;
+
+    const u8 *t = (const u8*)wire.att_time;
+    att.att_time = Encode_Time(t[0] + 2000, t[1], t[2], t[3], t[4], t[5]);
+} // end Convert_Att
+
+
+static void Convert_Enroll(const Wire_Enroll &wire, Event_Enroll &enroll)
+{
+    enroll.result = RNTOHS(wire.result);
+    enroll.serial = RNTOHS(wire.serial);
+} // end Convert_Enroll
+
+
+static void Convert_Enroll_Finger(const Wire_Enroll_Finger &wire, Event_Enroll_Finger &enroll)
+{
+    enroll.result = RNTOHS(wire.result);
+    enroll.size = RNTOHS(wire.size);
+    enroll.serial = RNTOHS(wire.serial);
+    enroll.finger_index = wire.finger_index;
+} // end Convert_Enroll_Finger
+
+
+static void Convert_Button(const Wire_Button &wire, Event_Button &button)
+{
+    button.key = RNTOHS(wire.key);
+} // end Convert_Button
+
+
+static void Convert_Unlock(const Wire_Unlock &wire, Event_Unlock &unlock)
+{
+    unlock.serial = RNTOHL(wire.serial);
+} // end Convert_Unlock
+
+
+static void Convert_Verify(const Wire_Verify &wire, Event_Verify &verify)
+{
+    // a failed verification comes through as all ones
+    verify.serial = (s32)RNTOHL(wire.serial);
+} // end Convert_Verify
+
+
+static void Convert_Score(const Wire_Score &wire, Event_Score &score)
+{
+    score.score = wire.score;
+} // end Convert_Score
+
+
+static void Convert_Alarm(const Wire_Alarm &wire, Event_Alarm &alarm)
+{
+    alarm.type = RNTOHS(wire.type);
+    alarm.serial = RNTOHS(wire.serial);
+    alarm.verified = RNTOHL(wire.verified);
+} // end Convert_Alarm
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The decoder for one event layout; instantiated per entry of the dispatch table below, so that the sizes
+ *  are checked at compile time and every decoder is a straight copy with no branching on the event.
+ *
+ * @return bool
+ *  false when the packet is too short for the layout
+ */
+template<typename W, typename D, void (*Convert)(const W&, D&)>
+static bool Decode_As(Event_Record &rec, const u8 *pdata, const u32 len)
+{
+    static_assert(sizeof(D) <= EVENT_DATA_SIZE, "decoded event won't fit a record");
+
+    if (len < sizeof(W))
+        return false;
+
+    W wire;
+    iCpy(&wire, pdata, sizeof(W));        // packet data carries no alignment
+    Convert(wire, *(D*)rec.data);
+    rec.len = (u8)sizeof(D);
+    return true;
+} // end Decode_As
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Decodes an event packet's data into the record; the decoder is looked up by the event's bit. Events with
+ *  no layout, more than one bit set or too short a packet are kept as is (cut short to fit).
+ */
+static void Decode(Event_Record &rec, const u16 event, const u8 *pdata, const u32 len)
+{
+    rec.bdecoded = false;
+    if (event && !(event & (event - 1)))
+    {
+        pfn_Decoder decoder = decoders[__builtin_ctz(event)];
+        if (decoder && decoder(rec, pdata, len))
+        {
+            rec.bdecoded = true;
+            return;
+        } // end if
+    } // end if
+
+    rec.len = (u8)(len < EVENT_DATA_SIZE ? len : EVENT_DATA_SIZE);
+    if (rec.len)
+        iCpy(rec.data, pdata, rec.len);
+} // end Decode
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Puts a record on the subscriber's ring; never blocks.
+ *
+ * @return bool
+ *  false when the ring is full
+ */
+static bool Push(Event_Sub *psub, const Event_Record &rec)
+{
+    u64 pos = psub->head.load(std::memory_order_relaxed);
+    Event_Slot *pslot;
+
+    for (;;)
+    {
+        pslot = &psub->pslots[pos & psub->mask];
+        u64 seq = pslot->seq.load(std::memory_order_acquire);
+        s64 diff = (s64)seq - (s64)pos;
+
+        if (diff == 0)
+        {
+            if (psub->head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } // end if
+        else if (diff < 0)
+            return false;       // the consumer is a lap behind
+        else
+            pos = psub->head.load(std::memory_order_relaxed);
+    } // end for
+
+    pslot->rec = rec;
+    pslot->seq.store(pos + 1, std::memory_order_release);
+
+    // pairs up with the fence in Run_Subscriber; one of us sees the other
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (psub->bsleeping.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> guard(psub->lock);
+        psub->cv.notify_one();
+    } // end if
+
+    return true;
+} // end Push
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Tells if the slot at the consumer's tail is filled.
+ */
+static bool Ready(Event_Sub *psub)
+{
+    return psub->pslots[psub->tail & psub->mask].seq.load(std::memory_order_acquire) == psub->tail + 1;
+} // end Ready
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Takes up to max filled records off the ring in order.
+ *
+ * @return size_t
+ *  the number of records taken
+ */
+static size_t Pop_Batch(Event_Sub *psub, Event_Record *precs, const size_t max)
+{
+    size_t n{0};
+
+    while (n < max && Ready(psub))
+    {
+        Event_Slot &slot = psub->pslots[psub->tail & psub->mask];
+        precs[n++] = slot.rec;
+        slot.seq.store(psub->tail + psub->mask + 1, std::memory_order_release);
+        ++psub->tail;
+    } // end while
+
+    return n;
+} // end Pop_Batch
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Subscriber thread; hands the events over in batches and sleeps only when the ring is dry. Whatever is on
+ *  the ring when told to stop is still delivered.
+ */
+static void Run_Subscriber(Event_Sub *psub)
+{
+    Event_Record batch[EVENT_BATCH_SIZE];
+
+    for (;;)
+    {
+        size_t n = Pop_Batch(psub, batch, EVENT_BATCH_SIZE);
+        if (n)
+        {
+            psub->handler(batch, n, psub->arg);
+            psub->delivered += n;
+            ++psub->batches;
+            continue;
+        } // end if
+
+        std::unique_lock<std::mutex> lock(psub->lock);
+        if (psub->bstop)
+            break;
+
+        psub->bsleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        psub->cv.wait(lock, [psub]() { return psub->bstop || Ready(psub); });
+        psub->bsleeping.store(false, std::memory_order_relaxed);
+    } // end for
+} // end Run_Subscriber
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Registers a subscriber; the handler is called on a thread of its own with batches of the events in mask.
+ *
+ * @param [handler] takes the events
+ * @param [arg] passed to handler
+ * @param [mask] the events wanted
+ * @param [capacity] the ring size in records; rounded up to a power of 2
+ *
+ * @return int
+ *  the subscriber id or -1 when out of room
+ */
+int Event_Subscribe(pfn_Event_Handler handler, void *arg, const Realtime_Mask mask, const u32 capacity)
+{
+    std::lock_guard<std::mutex> guard(sub_lock);
+
+    if (!handler)
+        return -1;
+
+    int id;
+    for (id = 0; id < EVENT_MAX_SUBSCRIBERS; id++)
+    {
+        if (!subs[id].load())
+            break;
+    } // end for
+
+    if (id == EVENT_MAX_SUBSCRIBERS)
+        return -1;
+
+    u64 cap{2};
+    while (cap < capacity)
+        cap <<= 1;
+
+    Event_Sub *psub = new Event_Sub;
+    psub->pslots = new Event_Slot[cap];
+    psub->mask = cap - 1;
+    for (u64 i = 0; i < cap; i++)
+        psub->pslots[i].seq.store(i, std::memory_order_relaxed);
+
+    psub->handler = handler;
+    psub->arg = arg;
+    psub->filter = mask;
+    psub->pthread = new std::thread(Run_Subscriber, psub);
+
+    subs[id].store(psub, std::memory_order_release);
+    return id;
+} // end Event_Subscribe
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Removes a subscriber; events already on its ring are delivered before this returns. Must not be called
+ *  from the subscriber's own handler.
+ *
+ * @param [id] what Event_Subscribe returned
+ *
+ * @return int
+ *  0 on success, -1 if no such subscriber
+ */
+int Event_Unsubscribe(const int id)
+{
+    std::lock_guard<std::mutex> guard(sub_lock);
+
+    if (id < 0 || id >= EVENT_MAX_SUBSCRIBERS)
+        return -1;
+
+    Event_Sub *psub = subs[id].exchange(nullptr);
+    if (!psub)
+        return -1;
+
+    // publishers that picked up the pointer before it went are done with it once they are all out
+    while (publishing.load())
+        std::this_thread::yield();
+
+    {
+        std::lock_guard<std::mutex> lock(psub->lock);
+        psub->bstop = true;
+        psub->cv.notify_one();
+    }
+
+    psub->pthread->join();
+    delete psub->pthread;
+    delete[] psub->pslots;
+    delete psub;
+
+    return 0;
+} // end Event_Unsubscribe
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns a subscriber's counters.
+ *
+ * @param [id] the subscriber id
+ * @param [pstats] gets the counters
+ *
+ * @return int
+ *  0 on success, -1 if no such subscriber
+ */
+int Event_Get_Stats(const int id, Event_Stats *pstats)
+{
+    std::lock_guard<std::mutex> guard(sub_lock);
+
+    if (id < 0 || id >= EVENT_MAX_SUBSCRIBERS || !pstats)
+        return -1;
+
+    Event_Sub *psub = subs[id].load();
+    if (!psub)
+        return -1;
+
+    pstats->delivered = psub->delivered;
+    pstats->dropped = psub->dropped;
+    pstats->batches = psub->batches;
+
+    return 0;
+} // end Event_Get_Stats
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Decodes a realtime event and puts it on the ring of every subscriber that wants it; called from the receive
+ *  path as soon as the packet is framed.
+ *
+ * @param [machine_num] the device the event came from
+ * @param [event] the EF_XXX code (the packet's session id)
+ * @param [pdata] the packet data
+ * @param [len] the packet data length
+ */
+void Event_Publish(const int machine_num, const u16 event, const u8 *pdata, const u32 len)
+{
+    Event_Record rec;
+
+    rec.recv_us = (u64)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    rec.machine_num = machine_num;
+    rec.event = event;
+    Decode(rec, event, pdata, len);
+
+    // journaled events are numbered by the journal, so a subscriber can tell Journal_Trim how far it got
+    s64 seq = Journal_Is_Open() ? Journal_Append(&rec, sizeof(rec)) : -1;
+    rec.seq = seq > 0 ? (u64)seq : bus_seq++;
+
+    // the other processes first; the ring never waits on its readers
+    Shm_Ring_Publish(rec);
+
+    ++publishing;
+    for (int i = 0; i < EVENT_MAX_SUBSCRIBERS; i++)
+    {
+        Event_Sub *psub = subs[i].load(std::memory_order_acquire);
+        if (psub && (psub->filter & event) && !Push(psub, rec))
+            ++psub->dropped;
+    } // end for
+    --publishing;
+} // end Event_Publish
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Journal_Replay glue for Event_Replay; gathers the records into batches.
+ */
+typedef struct Event_Replay_Info
+{
+    pfn_Event_Handler handler;
+    void *arg;
+    Event_Record batch[EVENT_BATCH_SIZE];
+    size_t count;
+} Event_Replay_State;
+
+
+static int Replay_Record(const u64 seq, const void *pdata, const u32 len, void *arg)
+{
+    Event_Replay_State *pstate = (Event_Replay_State*)arg;
+    if (len != sizeof(Event_Record))
+        return 0;       // not one of ours
+
+    Event_Record &rec = pstate->batch[pstate->count++];
+    iCpy(&rec, pdata, sizeof(rec));
+    rec.seq = seq;
+
+    if (pstate->count == EVENT_BATCH_SIZE)
+    {
+        pstate->handler(pstate->batch, pstate->count, pstate->arg);
+        pstate->count = 0;
+    } // end if
+
+    return 0;
+} // end Replay_Record
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Hands the journaled events from from_seq on to handler, in batches and on the caller's thread; used after a
+ *  restart to pick up the events that were received but never handed downstream.
+ *
+ * @param [from_seq] the first event wanted; one past what was last passed to Journal_Trim say
+ * @param [handler] takes the events
+ * @param [arg] passed to handler
+ *
+ * @return s64
+ *  the number of events replayed or -1 on fail
+ */
+s64 Event_Replay(const u64 from_seq, pfn_Event_Handler handler, void *arg)
+{
+    if (!handler)
+        return -1;
+
+    std::unique_ptr<Event_Replay_State> pstate(new Event_Replay_State);
+    pstate->handler = handler;
+    pstate->arg = arg;
+    pstate->count = 0;
+
+    s64 count = Journal_Replay(from_seq, Replay_Record, pstate.get());
+    if (pstate->count)
+        handler(pstate->batch, pstate->count, arg);
+
+    return count;
+} // end Event_Replay
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Tells which events the subscribers (and the shared memory ring) want between them; what a device has to be registered for (see
+ *  Init_Realtime) for none of them to miss out.
+ *
+ * @return Realtime_Mask
+ *  the subscriber filters and the ring's or'ed together
+ */
+Realtime_Mask Event_Wanted_Mask()
+{
+    std::lock_guard<std::mutex> guard(sub_lock);
+    Realtime_Mask mask = Shm_Ring_Mask();
+
+    for (int i = 0; i < EVENT_MAX_SUBSCRIBERS; i++)
+    {
+        Event_Sub *psub = subs[i].load();
+        if (psub)
+            mask |= psub->filter;
+    } // end for
+
+    return mask;
+} // end Event_Wanted_Mask
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,885 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for the exporters. A row is formatted in place at the end of its file's buffer;
+//  the buffer goes to the disk only when the next row won't fit, and only then does the file need an fd.
+//  Numbers are written two digits at a time off a table, and an att_time's date is worked out once for every
+//  run of rows on the same day.
+//
+//  With partitioning, files come and go by the thousand; a buffer given up is kept for the next file to take
+//  (never cleared, the bytes past used are never read), and the file to give up a buffer or an fd for room is
+//  the head of a list kept in order of use, thus neither costs more as the files pile up.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "exporter.h"
+#include "global-errors.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define EXPORT_MIN_BUFFER       (64 << 10)
+#define EXPORT_MAX_ROW          512         // room a row may take; more than the longest escaped one
+#define EXPORT_NO_KEY           (~0ULL)
+
+#define EXPORT_KIND_ATT         1
+#define EXPORT_KIND_USERS       2
+
+#define ATT_CSV_HEADER          "user_id,att_time,machine_num,verify_type,verify_state,serial\n"
+#define USER_CSV_HEADER         "machine_num,user_id,name,serial,privilege,card_number,group_number\n"
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+// "00" through "99"
+static const char digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes an unsigned decimal; returns the end.
+ */
+static inline char *Put_U32(char *p, u32 v)
+{
+    char tmp[10];
+    char *t = tmp + sizeof(tmp);
+
+    while (v >= 100)
+    {
+        u32 r = v % 100;
+        v /= 100;
+        t -= 2;
+        iCpy(t, digit_pairs + r * 2, 2);
+    } // end while
+
+    if (v >= 10)
+    {
+        t -= 2;
+        iCpy(t, digit_pairs + v * 2, 2);
+    } // end if
+    else
+        *--t = (char)('0' + v);
+
+    size_t len = tmp + sizeof(tmp) - t;
+    iCpy(p, t, len);
+    return p + len;
+} // end Put_U32
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes a signed decimal; returns the end.
+ */
+static inline char *Put_S32(char *p, const s32 v)
+{
+    if (v < 0)
+    {
+        *p++ = '-';
+        return Put_U32(p, (u32)0 - (u32)v);
+    } // end if
+
+    return Put_U32(p, (u32)v);
+} // end Put_S32
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes two digits; returns the end.
+ */
+static inline char *Put_2(char *p, const u32 v)
+{
+    iCpy(p, digit_pairs + v * 2, 2);
+    return p + 2;
+} // end Put_2
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes a CSV field, quoted only if it holds a comma, a quote or a line break; returns the end.
+ */
+static char *Put_Csv_String(char *p, const char *s, const size_t len)
+{
+    bool bquote{false};
+    for (size_t i = 0; i < len && !bquote; i++)
+        bquote = s[i] == ',' || s[i] == '"' || s[i] == '\n' || s[i] == '\r';
+
+    if (!bquote)
+    {
+        iCpy(p, s, len);
+        return p + len;
+    } // end if
+
+    *p++ = '"';
+    for (size_t i = 0; i < len; i++)
+    {
+        if (s[i] == '"')
+            *p++ = '"';
+        *p++ = s[i];
+    } // end for
+    *p++ = '"';
+
+    return p;
+} // end Put_Csv_String
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes a JSON string with its quotes; returns the end.
+ */
+static char *Put_Json_String(char *p, const char *s, const size_t len)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    *p++ = '"';
+    for (size_t i = 0; i < len; i++)
+    {
+        u8 c = (u8)s[i];
+        if (c == '"' || c == '\\')
+        {
+            *p++ = '\\';
+            *p++ = (char)c;
+        } // end if
+        else if (c < 0x20)
+        {
+            iCpy(p, "\\u00", 4);
+            p[4] = hex[c >> 4];
+            p[5] = hex[c & 15];
+            p += 6;
+        } // end else if
+        else
+            *p++ = (char)c;
+    } // end for
+    *p++ = '"';
+
+    return p;
+} // end Put_Json_String
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes a fixed size, maybe nul terminated, device string as a column of its own size.
+ */
+static void Fill_Column(char *pdest, const char *psrc, const size_t size)
+{
+    size_t len = strnlen(psrc, size);
+    iCpy(pdest, psrc, len);
+    iZero(pdest + len, size - len);
+} // end Fill_Column
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief Construct a new Exporter object; closed.
+ */
+Exporter::Exporter()
+    : bopen{false}, plast{nullptr}, last_key{EXPORT_NO_KEY}, nbuffered{0}, nopen{0}, date_day{0xffffffff},
+      berror{false}
+{
+    buffered.link = &Out_File::buf_link;
+    opened.link = &Out_File::fd_link;
+    iZero(date_text, sizeof(date_text));
+} // end constructor
+
+
+//==============================================================================================================|
+/**
+ * @brief Destroy the Exporter object; closes it first.
+ */
+Exporter::~Exporter()
+{
+    Close();
+} // end destructor
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Gets the exporter ready; files are made as rows for them come in.
+ *
+ * @param [config] settings
+ *
+ * @return int
+ *  0 on success, -1 if open already or the directory isn't there
+ */
+int Exporter::Open(const Export_Config &config)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    struct stat st;
+
+    if (bopen)
+        return -1;
+
+    if (stat(config.dir.c_str(), &st) < 0 || !S_ISDIR(st.st_mode))
+    {
+        Dump_Err("export: no directory %s", config.dir.c_str());
+        return -1;
+    } // end if
+
+    this->config = config;
+    if (this->config.buffer_size < EXPORT_MIN_BUFFER)
+        this->config.buffer_size = EXPORT_MIN_BUFFER;
+    if (!this->config.max_buffered)
+        this->config.max_buffered = 1;
+    if (!this->config.max_open)
+        this->config.max_open = 1;
+
+    stats = Export_Stats();
+    berror = false;
+    plast = nullptr;
+    last_key = EXPORT_NO_KEY;
+    bopen = true;
+    return 0;
+} // end Open
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Exports punches, each to the file of its partition.
+ *
+ * @param [ppunches] the punches
+ * @param [count] how many
+ *
+ * @return int
+ *  0 on success, -1 if not open or a write has failed since Open
+ */
+int Exporter::Write(const Punch_Record *ppunches, const size_t count)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (!bopen)
+        return -1;
+
+    for (size_t i = 0; i < count; i++)
+        Row(*Get(false, PUNCH_DAY(ppunches[i].att_time), ppunches[i].machine_num), ppunches[i]);
+
+    stats.punches += count;
+    return berror ? -1 : 0;
+} // end Write
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Exports the users of a device.
+ *
+ * @param [machine_num] the device
+ * @param [users] the users
+ *
+ * @return int
+ *  0 on success, -1 if not open or a write has failed since Open
+ */
+int Exporter::Write_Users(const int machine_num, const std::vector<User_Entry> &users)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (!bopen)
+        return -1;
+
+    Out_File *pfile = Get(true, 0, machine_num);
+    for (const User_Entry &user : users)
+        Row(*pfile, user, machine_num);
+
+    stats.users += users.size();
+    return berror ? -1 : 0;
+} // end Write_Users
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes out everything buffered; columnar files get a block with what they hold.
+ *
+ * @return int
+ *  0 on success, -1 if not open or a write has failed since Open
+ */
+int Exporter::Flush()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (!bopen)
+        return -1;
+
+    for (auto &it : files)
+    {
+        Flush_Block(*it.second);
+        Flush_Buffer(*it.second);
+    } // end for
+
+    return berror ? -1 : 0;
+} // end Flush
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes out everything and closes the files.
+ *
+ * @return int
+ *  0 on success, -1 if not open or a write has failed since Open
+ */
+int Exporter::Close()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (!bopen)
+        return -1;
+
+    for (auto &it : files)
+    {
+        Release(*it.second);
+        if (it.second->fd >= 0)
+            close(it.second->fd);
+    } // end for
+
+    files.clear();
+    spare.clear();
+    buffered.phead = buffered.ptail = opened.phead = opened.ptail = nullptr;
+    nbuffered = nopen = 0;
+    plast = nullptr;
+    last_key = EXPORT_NO_KEY;
+    bopen = false;
+    return berror ? -1 : 0;
+} // end Close
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  A pfn_Punch_Sink; arg is the Exporter. Fits as a Punch_Pipeline stage or behind Fleet_Merge_Attendance.
+ */
+void Exporter::On_Punches(const Punch_Record *ppunches, const size_t count, void *arg)
+{
+    ((Exporter*)arg)->Write(ppunches, count);
+} // end On_Punches
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the exporter counters.
+ */
+Export_Stats Exporter::Get_Stats()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return stats;
+} // end Get_Stats
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The file a row goes to, with a buffer to take it; made the first time round, with its header if there's
+ *  nothing on the disk yet. The buffer used longest ago is written out and given up when too many are held.
+ */
+Exporter::Out_File *Exporter::Get(const bool busers, const u32 day, const s32 machine_num)
+{
+    u32 d = !busers && (config.partition & EXPORT_BY_DAY) ? day + 1 : 0;
+    s32 m = (config.partition & EXPORT_BY_DEVICE) ? machine_num : -1;
+    u64 key = ((u64)busers << 63) | ((u64)(d & 0x7fffffff) << 32) | (u32)m;
+
+    if (key == last_key && plast->buf)
+        return plast;
+
+    bool bnew{false};
+    std::unique_ptr<Out_File> &pfile = files[key];
+    if (!pfile)
+    {
+        pfile.reset(new Out_File());
+        pfile->busers = busers;
+        pfile->path = config.dir + (busers ? "/users" : "/attendance");
+
+        if (d)
+        {
+            char text[16];
+            u32 t = d - 1;
+            snprintf(text, sizeof(text), "-%04u-%02u-%02u", t / 372 + 2000, t / 31 % 12 + 1, t % 31 + 1);
+            pfile->path += text;
+        } // end if
+
+        if (m != -1)
+            pfile->path += "-m" + std::to_string(m);
+
+        pfile->path += config.format == EXPORT_CSV ? ".csv" : config.format == EXPORT_JSONL ? ".jsonl" : ".col";
+
+        struct stat st;
+        bnew = stat(pfile->path.c_str(), &st) < 0 || st.st_size == 0;
+        ++stats.files;
+    } // end if
+
+    if (!pfile->buf)
+    {
+        if (nbuffered >= config.max_buffered && buffered.phead)
+        {
+            Release(*buffered.phead);
+            ++stats.evictions;
+        } // end if
+
+        if (!spare.empty())
+        {
+            pfile->buf = std::move(spare.back());
+            spare.pop_back();
+        } // end if
+        else
+            pfile->buf.reset(new char[config.buffer_size]);
+
+        pfile->used = 0;
+        ++nbuffered;
+    } // end if
+    else
+        Lru_Remove(buffered, *pfile);
+
+    Lru_Push(buffered, *pfile);
+
+    if (bnew)
+    {
+        if (config.format == EXPORT_CSV)
+        {
+            const char *phdr = busers ? USER_CSV_HEADER : ATT_CSV_HEADER;
+            Put(*pfile, phdr, strlen(phdr));
+        } // end if
+        else if (config.format == EXPORT_COLUMNAR)
+        {
+            u32 magic = EXPORT_COL_MAGIC;
+            u16 version = EXPORT_COL_VERSION, kind = busers ? EXPORT_KIND_USERS : EXPORT_KIND_ATT;
+            Put(*pfile, &magic, sizeof(magic));
+            Put(*pfile, &version, sizeof(version));
+            Put(*pfile, &kind, sizeof(kind));
+        } // end else if
+    } // end if
+
+    plast = pfile.get();
+    last_key = key;
+    return plast;
+} // end Get
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Opens a file for append; the one written out longest ago is closed when too many are open.
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+int Exporter::Open_File(Out_File &file)
+{
+    if (nopen >= config.max_open && opened.phead)
+    {
+        Out_File *poldest = opened.phead;
+        Lru_Remove(opened, *poldest);
+        close(poldest->fd);
+        poldest->fd = -1;
+        --nopen;
+    } // end if
+
+    file.fd = open(file.path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (file.fd < 0)
+    {
+        if (!berror)
+            Dump_Err("export: unable to open %s", file.path.c_str());
+        berror = true;
+        return -1;
+    } // end if
+
+    if (file.bopened)
+        ++stats.reopens;
+
+    file.bopened = true;
+    Lru_Push(opened, file);
+    ++nopen;
+    return 0;
+} // end Open_File
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Takes a file off a list.
+ */
+void Exporter::Lru_Remove(Lru_List &list, Out_File &file)
+{
+    Lru_Link &link = file.*list.link;
+
+    if (link.pprev)
+        (link.pprev->*list.link).pnext = link.pnext;
+    else
+        list.phead = link.pnext;
+
+    if (link.pnext)
+        (link.pnext->*list.link).pprev = link.pprev;
+    else
+        list.ptail = link.pprev;
+
+    link.pprev = link.pnext = nullptr;
+} // end Lru_Remove
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Puts a file at the tail of a list; the one used last.
+ */
+void Exporter::Lru_Push(Lru_List &list, Out_File &file)
+{
+    Lru_Link &link = file.*list.link;
+
+    link.pprev = list.ptail;
+    link.pnext = nullptr;
+    if (list.ptail)
+        (list.ptail->*list.link).pnext = &file;
+    else
+        list.phead = &file;
+
+    list.ptail = &file;
+} // end Lru_Push
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes a file's rows out and gives up its buffer to the spares; it gets one again if more rows come.
+ */
+void Exporter::Release(Out_File &file)
+{
+    if (!file.buf)
+        return;
+
+    Flush_Block(file);
+    Flush_Buffer(file);
+
+    Lru_Remove(buffered, file);
+    spare.push_back(std::move(file.buf));
+    --nbuffered;
+} // end Release
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Room for len bytes at the end of a file's buffer; the caller moves used on by what it takes.
+ */
+char *Exporter::Reserve(Out_File &file, const size_t len)
+{
+    if (file.used + len > config.buffer_size)
+        Flush_Buffer(file);
+
+    return file.buf.get() + file.used;
+} // end Reserve
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Copies bytes into a file's buffer, writing it out as it fills.
+ */
+void Exporter::Put(Out_File &file, const void *p, const size_t len)
+{
+    const char *psrc = (const char*)p;
+    size_t left = len;
+
+    while (left)
+    {
+        if (file.used == config.buffer_size)
+            Flush_Buffer(file);
+
+        size_t n = std::min(left, config.buffer_size - file.used);
+        iCpy(file.buf.get() + file.used, psrc, n);
+        file.used += n;
+        psrc += n;
+        left -= n;
+    } // end while
+} // end Put
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes a file's buffer to the disk.
+ */
+void Exporter::Flush_Buffer(Out_File &file)
+{
+    size_t done{0};
+
+    if (!file.used)
+        return;
+
+    if (file.fd < 0 && Open_File(file) < 0)
+    {
+        file.used = 0;
+        return;
+    } // end if
+
+    while (done < file.used)
+    {
+        ssize_t r = write(file.fd, file.buf.get() + done, file.used - done);
+        if (r < 0 && errno == EINTR)
+            continue;
+
+        if (r <= 0)
+        {
+            if (!berror)
+                Dump_Err("export: unable to write %s", file.path.c_str());
+            berror = true;
+            break;
+        } // end if
+
+        done += (size_t)r;
+    } // end while
+
+    stats.bytes += done;
+    file.used = 0;
+    Lru_Remove(opened, file);
+    Lru_Push(opened, file);
+} // end Flush_Buffer
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes the rows held for a columnar file as a block; a column at a time.
+ */
+void Exporter::Flush_Block(Out_File &file)
+{
+    if (config.format != EXPORT_COLUMNAR)
+        return;
+
+    if (!file.busers && !file.punches.empty())
+    {
+        const std::vector<Punch_Record> &rows = file.punches;
+        u32 n = (u32)rows.size();
+        std::vector<char> col((size_t)n * PUNCH_USER_ID_SIZE);
+
+        Put(file, &n, sizeof(n));
+        for (u32 i = 0; i < n; i++) iCpy(&col[i * 4], &rows[i].att_time, 4);
+        Put(file, col.data(), n * 4);
+        for (u32 i = 0; i < n; i++) iCpy(&col[i * 4], &rows[i].machine_num, 4);
+        Put(file, col.data(), n * 4);
+        for (u32 i = 0; i < n; i++) iCpy(&col[i * 2], &rows[i].serial, 2);
+        Put(file, col.data(), n * 2);
+        for (u32 i = 0; i < n; i++) col[i] = (char)rows[i].verify_type;
+        Put(file, col.data(), n);
+        for (u32 i = 0; i < n; i++) col[i] = (char)rows[i].verify_state;
+        Put(file, col.data(), n);
+        for (u32 i = 0; i < n; i++)
+            Fill_Column(&col[i * PUNCH_USER_ID_SIZE], rows[i].user_id, PUNCH_USER_ID_SIZE);
+        Put(file, col.data(), (size_t)n * PUNCH_USER_ID_SIZE);
+
+        file.punches.clear();
+    } // end if
+    else if (file.busers && !file.users.empty())
+    {
+        const std::vector<User_Row> &rows = file.users;
+        u32 n = (u32)rows.size();
+        std::vector<char> col((size_t)n * sizeof(rows[0].entry.name));
+
+        Put(file, &n, sizeof(n));
+        for (u32 i = 0; i < n; i++) iCpy(&col[i * 4], &rows[i].machine_num, 4);
+        Put(file, col.data(), n * 4);
+        for (u32 i = 0; i < n; i++) iCpy(&col[i * 2], &rows[i].entry.serial_number, 2);
+        Put(file, col.data(), n * 2);
+        for (u32 i = 0; i < n; i++) col[i] = (char)rows[i].entry.permissions;
+        Put(file, col.data(), n);
+        for (u32 i = 0; i < n; i++) col[i] = (char)rows[i].entry.group_number;
+        Put(file, col.data(), n);
+        for (u32 i = 0; i < n; i++) iCpy(&col[i * 4], &rows[i].entry.card_number, 4);
+        Put(file, col.data(), n * 4);
+        for (u32 i = 0; i < n; i++)
+            Fill_Column(&col[i * sizeof(rows[i].entry.user_id)], rows[i].entry.user_id,
+                sizeof(rows[i].entry.user_id));
+        Put(file, col.data(), (size_t)n * sizeof(rows[0].entry.user_id));
+        for (u32 i = 0; i < n; i++)
+            Fill_Column(&col[i * sizeof(rows[i].entry.name)], rows[i].entry.name, sizeof(rows[i].entry.name));
+        Put(file, col.data(), (size_t)n * sizeof(rows[0].entry.name));
+
+        file.users.clear();
+    } // end else if
+} // end Flush_Block
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes "YYYY-MM-DD HH:MM:SS"; the date part is kept from the row before when it's the same day.
+ */
+char *Exporter::Put_Time(char *p, const u32 att_time)
+{
+    u32 day = att_time / 86400, secs = att_time % 86400;
+
+    if (day != date_day)
+    {
+        u32 yr = day / 372 + 2000, mon = day / 31 % 12 + 1, dd = day % 31 + 1;
+        char *q = date_text;
+
+        q = Put_2(q, yr / 100);
+        q = Put_2(q, yr % 100);
+        *q++ = '-';
+        q = Put_2(q, mon);
+        *q++ = '-';
+        Put_2(q, dd);
+        date_day = day;
+    } // end if
+
+    iCpy(p, date_text, 10);
+    p[10] = ' ';
+    p = Put_2(p + 11, secs / 3600);
+    *p++ = ':';
+    p = Put_2(p, secs / 60 % 60);
+    *p++ = ':';
+    return Put_2(p, secs % 60);
+} // end Put_Time
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Formats an attendance row onto a file.
+ */
+void Exporter::Row(Out_File &file, const Punch_Record &punch)
+{
+    if (config.format == EXPORT_COLUMNAR)
+    {
+        file.punches.push_back(punch);
+        if (file.punches.size() == EXPORT_COL_BLOCK)
+            Flush_Block(file);
+        return;
+    } // end if
+
+    char *p = Reserve(file, EXPORT_MAX_ROW), *start = p;
+    size_t len = strnlen(punch.user_id, sizeof(punch.user_id));
+
+    if (config.format == EXPORT_CSV)
+    {
+        p = Put_Csv_String(p, punch.user_id, len);
+        *p++ = ',';
+        p = Put_Time(p, punch.att_time);
+        *p++ = ',';
+        p = Put_S32(p, punch.machine_num);
+        *p++ = ',';
+        p = Put_U32(p, punch.verify_type);
+        *p++ = ',';
+        p = Put_U32(p, punch.verify_state);
+        *p++ = ',';
+        p = Put_U32(p, punch.serial);
+    } // end if
+    else
+    {
+        iCpy(p, "{\"user_id\":", 11);
+        p = Put_Json_String(p + 11, punch.user_id, len);
+        iCpy(p, ",\"att_time\":\"", 13);
+        p = Put_Time(p + 13, punch.att_time);
+        iCpy(p, "\",\"machine_num\":", 16);
+        p = Put_S32(p + 16, punch.machine_num);
+        iCpy(p, ",\"verify_type\":", 15);
+        p = Put_U32(p + 15, punch.verify_type);
+        iCpy(p, ",\"verify_state\":", 16);
+        p = Put_U32(p + 16, punch.verify_state);
+        iCpy(p, ",\"serial\":", 10);
+        p = Put_U32(p + 10, punch.serial);
+        *p++ = '}';
+    } // end else
+
+    *p++ = '\n';
+    file.used += p - start;
+} // end Row
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Formats a user row onto a file.
+ */
+void Exporter::Row(Out_File &file, const User_Entry &user, const s32 machine_num)
+{
+    if (config.format == EXPORT_COLUMNAR)
+    {
+        User_Row row;
+        row.entry = user;
+        row.machine_num = machine_num;
+        file.users.push_back(row);
+        if (file.users.size() == EXPORT_COL_BLOCK)
+            Flush_Block(file);
+        return;
+    } // end if
+
+    char *p = Reserve(file, EXPORT_MAX_ROW), *start = p;
+    size_t id_len = strnlen(user.user_id, sizeof(user.user_id));
+    size_t name_len = strnlen(user.name, sizeof(user.name));
+
+    if (config.format == EXPORT_CSV)
+    {
+        p = Put_S32(p, machine_num);
+        *p++ = ',';
+        p = Put_Csv_String(p, user.user_id, id_len);
+        *p++ = ',';
+        p = Put_Csv_String(p, user.name, name_len);
+        *p++ = ',';
+        p = Put_U32(p, user.serial_number);
+        *p++ = ',';
+        p = Put_U32(p, user.permissions);
+        *p++ = ',';
+        p = Put_U32(p, user.card_number);
+        *p++ = ',';
+        p = Put_U32(p, user.group_number);
+    } // end if
+    else
+    {
+        iCpy(p, "{\"machine_num\":", 15);
+        p = Put_S32(p + 15, machine_num);
+        iCpy(p, ",\"user_id\":", 11);
+        p = Put_Json_String(p + 11, user.user_id, id_len);
+        iCpy(p, ",\"name\":", 8);
+        p = Put_Json_String(p + 8, user.name, name_len);
+        iCpy(p, ",\"serial\":", 10);
+        p = Put_U32(p + 10, user.serial_number);
+        iCpy(p, ",\"privilege\":", 13);
+        p = Put_U32(p + 13, user.permissions);
+        iCpy(p, ",\"card_number\":", 15);
+        p = Put_U32(p + 15, user.card_number);
+        iCpy(p, ",\"group_number\":", 16);
+        p = Put_U32(p + 16, user.group_number);
+        *p++ = '}';
+    } // end else
+
+    *p++ = '\n';
+    file.used += p - start;
+} // end Row
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,254 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for the fleet fan out executor. The devices are run as jobs on the shared work
+//  stealing pool (see job-pool.h) with no more than max_parallel of them queued or running at once; the driver
+//  keeps each device on its own connection and reply queue, thus different devices never wait on each other.
+//  The same device must not appear twice in a set.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "fan-out.h"
+#include "job-pool.h"
+
+#include <chrono>
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  Book keeping for a single Fan_Out call
+ */
+typedef struct Fan_Out_State_Info
+{
+    std::atomic<size_t> next{0};        // the next device to take up
+    size_t count{0};                    // devices in the set
+    std::atomic<int> failed{0};         // devices that failed
+    std::atomic<size_t> remaining{0};   // devices not yet done; brought down under lock
+    std::mutex lock;                    // keeps the done calls one at a time
+    std::condition_variable done_cv;    // wakes the caller once remaining hits 0
+} Fan_Out_State;
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Runs op on every device in machines, up to max_parallel of them at once, and waits for all to complete.
+ *
+ * @param [machines] the devices to work on (connected, each one only once)
+ * @param [op] the operation to run
+ * @param [arg] passed to op
+ * @param [results] gets one result per device, in the same order as machines
+ * @param [opt] fan out options
+ *
+ * @return int
+ *  the number of devices that failed
+ */
+int Fan_Out(const std::vector<int> &machines, pfn_Fleet_Op op, void *arg, std::vector<Fan_Out_Result> &results,
+    const Fan_Out_Options &opt)
+{
+    Job_Pool &pool = Default_Job_Pool();
+    auto pstate = std::make_shared<Fan_Out_State>();
+
+    results.assign(machines.size(), Fan_Out_Result());
+    if (!op || machines.empty())
+        return 0;
+
+    pstate->count = pstate->remaining = machines.size();
+    size_t nslots = std::min<size_t>(opt.max_parallel ? opt.max_parallel : 1, machines.size());
+
+    // each slot runs one device then queues itself again for the next; a slot queued from a worker lands on
+    //  that worker's deque, where an idle worker can steal it if this one gets stuck on a long job
+    std::function<void()> slot;
+    std::function<void()> *pslot = &slot;
+    slot = [&, pstate, pslot]() {
+        // a slot may be left queued after the last device is taken and Fan_Out has returned; only pstate is
+        //  safe to touch until we hold a device
+        size_t i = pstate->next++;
+        if (i >= pstate->count)
+            return;
+
+        Fan_Out_Result &res = results[i];
+        auto start = std::chrono::steady_clock::now();
+
+        res.machine_num = machines[i];
+        res.status = op(machines[i], i, arg);
+        res.elapsed_ms = (u64)std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        if (res.status < 0)
+        {
+            res.err = Whats_Last_Error(machines[i]);
+            ++pstate->failed;
+        } // end if
+
+        {
+            std::lock_guard<std::mutex> guard(pstate->lock);
+            if (opt.done)
+                opt.done(i, res, opt.done_arg);
+
+            if (pstate->next < pstate->count)
+                pool.Submit(*pslot);
+
+            if (--pstate->remaining)
+                return;
+
+            pstate->done_cv.notify_all();
+        }
+
+        // a caller that is a worker itself waits in Help_Until; Fan_Out may have returned by now, thus only
+        //  the shared pool is touched
+        Default_Job_Pool().Wake();
+    };
+
+    for (size_t t = 0; t < nslots; t++)
+        pool.Submit(slot);
+
+    if (pool.In_Worker())
+    {
+        // we are a job ourselves; help out rather than tie up a worker doing nothing, and sleep when there's
+        //  nothing to help with
+        pool.Help_Until([&pstate]() { return pstate->remaining == 0; });
+    } // end if
+    else
+    {
+        std::unique_lock<std::mutex> lock(pstate->lock);
+        pstate->done_cv.wait(lock, [&pstate]() { return pstate->remaining == 0; });
+    } // end else
+
+    return pstate->failed;
+} // end Fan_Out
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Fan out glue for the calls below
+ */
+static int Op_Get_Time(const int machine_num, const size_t index, void *arg)
+{
+    return Get_Time(machine_num, &(*(std::vector<u32>*)arg)[index]);
+} // end Op_Get_Time
+
+
+static int Op_Set_Time(const int machine_num, const size_t index, void *arg)
+{
+    return Set_Time(machine_num, *(u32*)arg);
+} // end Op_Set_Time
+
+
+static int Op_Read_Attendance(const int machine_num, const size_t index, void *arg)
+{
+    return Read_Attendance_Record(machine_num, (*(std::vector<std::vector<Attendance_Entry>>*)arg)[index]);
+} // end Op_Read_Attendance
+
+
+static int Op_Restart(const int machine_num, const size_t index, void *arg)
+{
+    return Restart_Device(machine_num);
+} // end Op_Restart
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Reads the time off every device in the set.
+ *
+ * @param [machines] the devices to work on
+ * @param [times] gets the device times, in the same order as machines
+ * @param [results] gets one result per device
+ * @param [opt] fan out options
+ *
+ * @return int
+ *  the number of devices that failed
+ */
+int Fleet_Get_Time(const std::vector<int> &machines, std::vector<u32> &times, std::vector<Fan_Out_Result> &results,
+    const Fan_Out_Options &opt)
+{
+    times.assign(machines.size(), 0);
+    return Fan_Out(machines, Op_Get_Time, &times, results, opt);
+} // end Fleet_Get_Time
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Sets the same time on every device in the set.
+ *
+ * @param [machines] the devices to work on
+ * @param [_time] the time encoded the device way
+ * @param [results] gets one result per device
+ * @param [opt] fan out options
+ *
+ * @return int
+ *  the number of devices that failed
+ */
+int Fleet_Set_Time(const std::vector<int> &machines, const u32 _time, std::vector<Fan_Out_Result> &results,
+    const Fan_Out_Options &opt)
+{
+    u32 t{_time};
+    return Fan_Out(machines, Op_Set_Time, &t, results, opt);
+} // end Fleet_Set_Time
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Downloads the attendance log off every device in the set.
+ *
+ * @param [machines] the devices to work on
+ * @param [entries] gets the logs, one per device in the same order as machines
+ * @param [results] gets one result per device
+ * @param [opt] fan out options
+ *
+ * @return int
+ *  the number of devices that failed
+ */
+int Fleet_Read_Attendance(const std::vector<int> &machines, std::vector<std::vector<Attendance_Entry>> &entries,
+    std::vector<Fan_Out_Result> &results, const Fan_Out_Options &opt)
+{
+    entries.assign(machines.size(), std::vector<Attendance_Entry>());
+    return Fan_Out(machines, Op_Read_Attendance, &entries, results, opt);
+} // end Fleet_Read_Attendance
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Restarts every device in the set.
+ *
+ * @param [machines] the devices to work on
+ * @param [results] gets one result per device
+ * @param [opt] fan out options
+ *
+ * @return int
+ *  the number of devices that failed
+ */
+int Fleet_Restart(const std::vector<int> &machines, std::vector<Fan_Out_Result> &results,
+    const Fan_Out_Options &opt)
+{
+    return Fan_Out(machines, Op_Restart, nullptr, results, opt);
+} // end Fleet_Restart
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
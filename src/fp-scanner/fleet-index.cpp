@@ -0,0 +1,329 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for the fleet wide user index. Devices are given a slot (bit position) the first
+//  time they show up and all the bitsets live back to back in one flat array of 64-bit words, one fixed stride
+//  per user; thus 400 devices cost 56 bytes a user. Each device also keeps the sorted list of rows it holds so
+//  that a fresh user table is applied as a diff, touching only the bits that actually change.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "fleet-index.h"
+#include "user-cache.h"
+
+#include <mutex>
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+static std::unordered_map<std::string, u32> rows;       // user_id : row in bits
+static std::vector<u64> bits;                           // row * stride words of device bits
+static u32 stride{1};                                   // words per row
+static std::unordered_map<int, u32> slots;              // machine_num : bit position
+static std::vector<int> slot_owner;                     // bit position : machine_num
+static std::unordered_map<int, std::vector<u32>> held;  // machine_num : sorted rows it holds
+static std::mutex fleet_lock;                           // guards the lot
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  The user id as key; ids are at most 9 chars and not always null terminated.
+ */
+static inline std::string Key(const char *user_id)
+{
+    return std::string(user_id, strnlen(user_id, sizeof(User_Entry::user_id)));
+} // end Key
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the bit position of a device, handing out a new one (and widening the rows if needed) the first
+ *  time; caller holds the lock.
+ */
+static u32 Slot(const int machine_num)
+{
+    auto it = slots.find(machine_num);
+    if (it != slots.end())
+        return it->second;
+
+    u32 slot = (u32)slot_owner.size();
+    slots[machine_num] = slot;
+    slot_owner.push_back(machine_num);
+
+    if (slot >= stride * 64)
+    {
+        // re-stride; happens once every 64 devices
+        u32 wide = stride + 1;
+        std::vector<u64> nbits(rows.size() * wide, 0);
+        for (size_t r = 0; r < rows.size(); r++)
+            iCpy(&nbits[r * wide], &bits[r * stride], stride * sizeof(u64));
+
+        bits.swap(nbits);
+        stride = wide;
+    } // end if
+
+    return slot;
+} // end Slot
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the row of a user id, making a new one if need be; caller holds the lock.
+ */
+static u32 Row(const std::string &key)
+{
+    auto it = rows.find(key);
+    if (it != rows.end())
+        return it->second;
+
+    u32 row = (u32)rows.size();
+    rows[key] = row;
+    bits.resize(bits.size() + stride, 0);
+
+    return row;
+} // end Row
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Sets or clears the device bit on the row; caller holds the lock.
+ */
+static inline void Mark(const u32 row, const u32 slot, const bool bset)
+{
+    u64 &w = bits[row * stride + (slot >> 6)];
+    if (bset)
+        w |= (1ULL << (slot & 63));
+    else
+        w &= ~(1ULL << (slot & 63));
+} // end Mark
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Applies a freshly downloaded user table of a device to the index; only the users that came or went since
+ *  the last update have their bits touched.
+ *
+ * @param [machine_num] the machine identifier
+ * @param [users] the full user table of the device
+ *
+ * @return int
+ *  the number of bits changed
+ */
+int Fleet_Index_Update(const int machine_num, const std::vector<User_Entry> &users)
+{
+    std::lock_guard<std::mutex> guard(fleet_lock);
+
+    u32 slot = Slot(machine_num);
+    std::vector<u32> now;
+    now.reserve(users.size());
+
+    for (auto &u : users)
+        now.push_back(Row(Key(u.user_id)));
+
+    std::sort(now.begin(), now.end());
+    now.erase(std::unique(now.begin(), now.end()), now.end());
+
+    std::vector<u32> &before = held[machine_num];
+    std::vector<u32> gone, came;
+    std::set_difference(before.begin(), before.end(), now.begin(), now.end(), std::back_inserter(gone));
+    std::set_difference(now.begin(), now.end(), before.begin(), before.end(), std::back_inserter(came));
+
+    for (auto r : gone)
+        Mark(r, slot, false);
+    for (auto r : came)
+        Mark(r, slot, true);
+
+    before.swap(now);
+    return (int)(gone.size() + came.size());
+} // end Fleet_Index_Update
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Records that the device now holds the user.
+ *
+ * @param [machine_num] the machine identifier
+ * @param [user_id] the user id
+ */
+void Fleet_Index_Add(const int machine_num, const char *user_id)
+{
+    std::lock_guard<std::mutex> guard(fleet_lock);
+
+    u32 slot = Slot(machine_num);
+    u32 row = Row(Key(user_id));
+    std::vector<u32> &h = held[machine_num];
+
+    auto it = std::lower_bound(h.begin(), h.end(), row);
+    if (it != h.end() && *it == row)
+        return;
+
+    h.insert(it, row);
+    Mark(row, slot, true);
+} // end Fleet_Index_Add
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Records that the device no longer holds the user.
+ *
+ * @param [machine_num] the machine identifier
+ * @param [user_id] the user id
+ */
+void Fleet_Index_Remove(const int machine_num, const char *user_id)
+{
+    std::lock_guard<std::mutex> guard(fleet_lock);
+
+    auto sit = slots.find(machine_num);
+    auto rit = rows.find(Key(user_id));
+    if (sit == slots.end() || rit == rows.end())
+        return;
+
+    std::vector<u32> &h = held[machine_num];
+    auto it = std::lower_bound(h.begin(), h.end(), rit->second);
+    if (it == h.end() || *it != rit->second)
+        return;
+
+    h.erase(it);
+    Mark(rit->second, sit->second, false);
+} // end Fleet_Index_Remove
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Forgets everything about a device (decommissioned for instance); its slot stays reserved.
+ *
+ * @param [machine_num] the machine identifier
+ */
+void Fleet_Index_Drop_Device(const int machine_num)
+{
+    std::lock_guard<std::mutex> guard(fleet_lock);
+
+    auto sit = slots.find(machine_num);
+    if (sit == slots.end())
+        return;
+
+    for (auto r : held[machine_num])
+        Mark(r, sit->second, false);
+
+    held.erase(machine_num);
+} // end Fleet_Index_Drop_Device
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the devices holding the user.
+ *
+ * @param [user_id] the user id
+ * @param [machines] gets the machine numbers
+ *
+ * @return int
+ *  the number of devices found
+ */
+int Fleet_Index_Lookup(const char *user_id, std::vector<int> &machines)
+{
+    std::lock_guard<std::mutex> guard(fleet_lock);
+
+    machines.clear();
+    auto it = rows.find(Key(user_id));
+    if (it == rows.end())
+        return 0;
+
+    const u64 *pw = &bits[it->second * stride];
+    for (u32 w = 0; w < stride; w++)
+    {
+        u64 word = pw[w];
+        while (word)
+        {
+            u32 b = (u32)__builtin_ctzll(word);
+            machines.push_back(slot_owner[(w << 6) + b]);
+            word &= word - 1;
+        } // end while
+    } // end for
+
+    return (int)machines.size();
+} // end Fleet_Index_Lookup
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Deletes a user from every device the index says holds it. The user's serial on each device comes from
+ *  that device's user cache, thus devices whose cache is not loaded are loaded first.
+ *
+ * @param [user_id] the user id
+ *
+ * @return int
+ *  the number of devices the user was deleted from, or -ve if any of the deletes failed
+ */
+int Fleet_Revoke_User(const char *user_id)
+{
+    std::vector<int> machines;
+    int count{0}, ret{0};
+
+    Fleet_Index_Lookup(user_id, machines);
+    for (auto machine_num : machines)
+    {
+        User_Entry user;
+
+        if (Cache_Load_Users(machine_num) < 0)
+        {
+            ret = -1;
+            continue;
+        } // end if
+
+        int found = Cache_Find_UserID(machine_num, user_id, &user);
+        if (found == -2)
+        {
+            // went stale right under our feet; leave it for the next go
+            ret = -1;
+            continue;
+        } // end if
+        else if (found < 0)
+        {
+            // the device no longer has it; bring the index in line
+            Fleet_Index_Remove(machine_num, user_id);
+            continue;
+        } // end else if
+
+        if (Delete_User(machine_num, user.serial_number) < 0)
+        {
+            ret = -1;
+            continue;
+        } // end if
+
+        ++count;
+    } // end for
+
+    return (ret < 0 ? ret : count);
+} // end Fleet_Revoke_User
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
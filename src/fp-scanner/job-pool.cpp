@@ -0,0 +1,337 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for class Job_Pool. Every deque has its own lock; a worker only ever touches
+//  another worker's lock when it's out of work and the shared queue is empty, so in the common case the only
+//  lock it shares is the one it takes once per job submitted or taken from outside.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "job-pool.h"
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define JOB_POOL_OUTSIDER       0xffffffffU     // the worker index of a thread that isn't one
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+static thread_local const Job_Pool *pself_pool{nullptr};    // the pool the calling thread works for, if any
+static thread_local u32 self_index{0};                      // and its index in there
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief Construct a new Job_Pool object
+ *  workers are started as jobs come in (see Submit).
+ *
+ * @param [nworkers] the most worker threads (at least 1)
+ */
+Job_Pool::Job_Pool(const u32 nworkers)
+{
+    u32 n = nworkers ? nworkers : 1;
+
+    for (u32 i = 0; i < n; i++)
+        workers.emplace_back(new Worker);
+} // end constructor
+
+
+//==============================================================================================================|
+/**
+ * @brief Destroy the Job_Pool object
+ *  lets the workers finish off whatever is queued and joins them.
+ */
+Job_Pool::~Job_Pool()
+{
+    {
+        std::lock_guard<std::mutex> guard(idle_lock);
+        bstop = true;       // no worker is started from here on, thus threads stays as is
+    }
+
+    idle_cv.notify_all();
+    for (auto &t : threads)
+        t.join();
+} // end destructor
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Queues a job; from a worker of this pool it goes onto that worker's own deque, from outside onto the shared
+ *  queue. A worker is started for it when none is asleep and the pool isn't full grown.
+ *
+ * @param [job] the job to run
+ */
+void Job_Pool::Submit(Job job)
+{
+    bool bworker = In_Worker();
+
+    if (bworker)
+    {
+        std::lock_guard<std::mutex> guard(workers[self_index]->lock);
+        workers[self_index]->jobs.push_back(std::move(job));
+    } // end if
+
+    {
+        std::lock_guard<std::mutex> guard(idle_lock);
+        if (!bworker)
+            shared.push_back(std::move(job));
+        ++queued;
+
+        if (!idle)
+            Start_Worker();
+    }
+
+    idle_cv.notify_one();
+} // end Submit
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Runs a single queued job on the calling thread, if there's one. A worker that has to wait on jobs it
+ *  submitted keeps helping through this instead of blocking (which could leave the pool with no one to run
+ *  them).
+ *
+ * @return bool
+ *  true if a job was run
+ */
+bool Job_Pool::Run_One()
+{
+    Job job;
+    u32 self = In_Worker() ? self_index : JOB_POOL_OUTSIDER;
+
+    if (!Take(self, job))
+        return false;
+
+    job();
+    if (self == JOB_POOL_OUTSIDER)
+        ++outside;
+    else
+        ++workers[self]->executed;
+
+    return true;
+} // end Run_One
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  For a worker waiting on jobs it submitted; runs queued jobs until bdone tells it's done and, with nothing
+ *  to run, sleeps until a job is queued or Wake is called. Whoever makes bdone true must call Wake after.
+ *
+ * @param [bdone] tells if the wait is over; called under the pool's idle lock, thus must not block
+ */
+void Job_Pool::Help_Until(const std::function<bool()> &bdone)
+{
+    while (!bdone())
+    {
+        if (Run_One())
+            continue;
+
+        std::unique_lock<std::mutex> lock(idle_lock);
+        idle_cv.wait(lock, [&]() { return queued > 0 || bstop || bdone(); });
+    } // end while
+} // end Help_Until
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Wakes the workers sleeping in Help_Until (and the idle ones, who go back to sleep) to look at their wait
+ *  again.
+ */
+void Job_Pool::Wake()
+{
+    std::lock_guard<std::mutex> guard(idle_lock);
+    idle_cv.notify_all();
+} // end Wake
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  tells if the calling thread is a worker of this pool.
+ */
+bool Job_Pool::In_Worker() const
+{
+    return pself_pool == this;
+} // end In_Worker
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  returns the number of worker threads.
+ */
+u32 Job_Pool::Workers() const
+{
+    return (u32)workers.size();
+} // end Workers
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  returns the pool counters.
+ */
+Job_Pool_Stats Job_Pool::Get_Stats() const
+{
+    Job_Pool_Stats stats;
+
+    for (auto &w : workers)
+    {
+        stats.executed += w->executed;
+        stats.stolen += w->stolen;
+    } // end for
+
+    stats.executed += outside;
+    stats.queued = queued;
+    stats.started = started;
+    return stats;
+} // end Get_Stats
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Takes a job for worker self; the oldest off the shared queue first, then the oldest off its own deque, then
+ *  the oldest off the other workers starting with the one next to it.
+ *
+ * @param [self] the worker index; JOB_POOL_OUTSIDER for a thread that isn't a worker
+ * @param [job] gets the job
+ *
+ * @return bool
+ *  true if a job was taken
+ */
+bool Job_Pool::Take(const u32 self, Job &job)
+{
+    u32 n = started;
+
+    {
+        std::lock_guard<std::mutex> guard(idle_lock);
+        if (!shared.empty())
+        {
+            job = std::move(shared.front());
+            shared.pop_front();
+            --queued;
+            return true;
+        } // end if
+    }
+
+    if (self != JOB_POOL_OUTSIDER)
+    {
+        Worker &w = *workers[self];
+        std::lock_guard<std::mutex> guard(w.lock);
+        if (!w.jobs.empty())
+        {
+            job = std::move(w.jobs.front());
+            w.jobs.pop_front();
+            --queued;
+            return true;
+        } // end if
+    } // end if
+
+    for (u32 i = self == JOB_POOL_OUTSIDER ? 0 : 1; i < n; i++)
+    {
+        Worker &victim = *workers[(self == JOB_POOL_OUTSIDER ? i : self + i) % n];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.jobs.empty())
+        {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            --queued;
+            if (self != JOB_POOL_OUTSIDER)
+                ++workers[self]->stolen;
+            return true;
+        } // end if
+    } // end for
+
+    return false;
+} // end Take
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Starts one more worker unless the pool is full grown or on its way down; caller holds idle_lock.
+ */
+void Job_Pool::Start_Worker()
+{
+    if (bstop || threads.size() >= workers.size())
+        return;
+
+    threads.emplace_back(&Job_Pool::Run, this, (u32)threads.size());
+    started = (u32)threads.size();
+} // end Start_Worker
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Worker thread; runs jobs until told to stop and there's nothing left.
+ *
+ * @param [self] the worker index
+ */
+void Job_Pool::Run(const u32 self)
+{
+    pself_pool = this;
+    self_index = self;
+
+    for (;;)
+    {
+        Job job;
+        if (Take(self, job))
+        {
+            job();
+            ++workers[self]->executed;
+            continue;
+        } // end if
+
+        std::unique_lock<std::mutex> lock(idle_lock);
+        ++idle;
+        idle_cv.wait(lock, [this]() { return queued > 0 || bstop; });
+        --idle;
+        if (bstop && !queued)
+            break;
+    } // end for
+} // end Run
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  The pool shared by the fan out executor and the sync scheduler; made on first use.
+ */
+Job_Pool &Default_Job_Pool()
+{
+    static Job_Pool pool(JOB_POOL_WORKERS);
+    return pool;
+} // end Default_Job_Pool
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
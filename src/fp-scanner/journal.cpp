@@ -0,0 +1,869 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for the append only journal. A segment is a file of segment_size bytes made up front
+//  and mapped whole; records are laid one after another (8 byte aligned) behind a small segment header and the
+//  zeros past the last one mark the end. The flusher thread msync's what's been written since the last flush
+//  and, between flushes, makes the next segment ready (allocated and faulted in) so that rolling over to it in
+//  the middle of a burst is a rename rather than a trip to the disk. The segment rolled off is handed to the
+//  flusher as well, which syncs what's left of it; the append path never syncs nor makes a segment, an append
+//  that outruns the flusher waits on the spare instead.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "journal.h"
+#include "global-errors.h"
+#include "utils.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define ALIGN8(x)           (((x) + 7) & ~(u64)7)
+#define SPARE_NAME          "spare.jnl"
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  Head of every segment file
+ */
+typedef struct Journal_Segment_Header_Info
+{
+    u32 magic;                  // JOURNAL_MAGIC
+    u32 reserved;
+    u64 first_seq;              // the first record in the segment
+} Journal_Seg_Header;
+
+
+
+/**
+ * @brief
+ *  Head of every record; the data follows padded to 8 bytes. crc covers the data, then len and seq, so a
+ *  record half written (or never written) fails it.
+ */
+typedef struct Journal_Record_Header_Info
+{
+    u32 len;                    // data bytes; 0 marks the end of the segment
+    u32 crc;
+    u64 seq;
+} Journal_Rec_Header;
+
+
+
+/**
+ * @brief
+ *  A mapped segment file
+ */
+typedef struct Journal_Segment_Info
+{
+    int fd{-1};
+    u8 *pmap{nullptr};
+    u64 size{0};
+    u64 first_seq{0};
+
+    ~Journal_Segment_Info()
+    {
+        if (pmap)
+            munmap(pmap, size);
+        if (fd >= 0)
+            close(fd);
+    } // end destructor
+} Journal_Segment;
+
+
+
+/**
+ * @brief
+ *  A segment rolled off and not yet on disk in full
+ */
+typedef struct Journal_Retired_Info
+{
+    std::shared_ptr<Journal_Segment> seg;
+    u64 from;                   // on disk up to here
+    u64 to;                     // written up to here
+    u64 last_seq;               // the last record in it
+} Journal_Retired;
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+static Journal_Config jnl_cfg;                      // the running config
+static std::shared_ptr<Journal_Segment> pseg;      // the segment being appended to
+static std::shared_ptr<Journal_Segment> pspare;    // the next one, made ready by the flusher
+static std::deque<Journal_Retired> retired;         // rolled off, for the flusher to sync; oldest first
+static std::vector<u64> segs;                       // first seq of every segment on disk, in order
+static u64 write_off{0};                            // where the next record goes in pseg
+static u64 synced_off{0};                           // pseg is on disk up to here
+static u64 dirty_bytes{0};                          // appended since the last flush
+static u64 last_seq{0};
+static u64 synced_seq{0};
+static u32 sync_waiters{0};                         // appenders waiting on a flush
+static bool bjnl_failed{false};                     // a flush failed; appending stops
+static bool bdir_dirty{false};                      // a segment got named since the dir was synced
+static std::atomic<bool> bjnl_running{false};
+static std::mutex jnl_lock;                         // guards all of the above
+static std::condition_variable flush_cv;            // wakes the flusher
+static std::condition_variable synced_cv;           // wakes those waiting on a flush
+static std::condition_variable spare_cv;            // wakes appenders waiting on a spare
+static std::thread *pflusher{nullptr};
+static Journal_Stats jnl_stats;
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Path to a segment file
+ */
+static std::string Segment_Path(const u64 first_seq)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/%016" PRIx64 ".jnl", first_seq);
+    return jnl_cfg.dir + name;
+} // end Segment_Path
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The CRC a record ought to carry
+ */
+static u32 Record_Crc(const u32 data_crc, const u32 len, const u64 seq)
+{
+    return Crc32(&seq, sizeof(seq), Crc32(&len, sizeof(len), data_crc));
+} // end Record_Crc
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Flushes a range of a segment to disk; msync wants the start on a page boundary.
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+static int Sync_Range(const Journal_Segment &seg, const u64 from, const u64 to)
+{
+    if (to <= from)
+        return 0;
+
+    u64 page = (u64)sysconf(_SC_PAGESIZE);
+    u64 start = from & ~(page - 1);
+
+    return msync(seg.pmap + start, to - start, MS_SYNC);
+} // end Sync_Range
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  fsync's the journal directory so the segment names are on disk as well.
+ */
+static int Sync_Dir()
+{
+    int fd = open(jnl_cfg.dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+        return -1;
+
+    int r = fsync(fd);
+    close(fd);
+    return r;
+} // end Sync_Dir
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Makes a zero filled segment file of the configured size and maps it; the blocks are allocated and the pages
+ *  faulted in now so that appending to it later costs neither.
+ *
+ * @param [path] the file to make
+ *
+ * @return std::shared_ptr<Journal_Segment>
+ *  the segment or nullptr on fail
+ */
+static std::shared_ptr<Journal_Segment> Make_Segment(const std::string &path, const u64 size)
+{
+    auto seg = std::make_shared<Journal_Segment>();
+
+    seg->size = size;
+    seg->fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (seg->fd < 0)
+        return nullptr;
+
+    // not every file system allocates; a sparse file still works, only slower on first touch
+    if (posix_fallocate(seg->fd, 0, (off_t)size) != 0 && ftruncate(seg->fd, (off_t)size) != 0)
+        return nullptr;
+
+    if (fsync(seg->fd) != 0)
+        return nullptr;
+
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, seg->fd, 0);
+    if (p == MAP_FAILED)
+        return nullptr;
+
+    seg->pmap = (u8*)p;
+    return seg;
+} // end Make_Segment
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Moves appending on to the spare, renamed to start at first_seq; the old segment goes to the flusher to be
+ *  synced. Caller must hold the lock and have seen to it that there's a spare.
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+static int Roll(const u64 first_seq)
+{
+    std::string path = Segment_Path(first_seq);
+
+    if (rename((jnl_cfg.dir + "/" SPARE_NAME).c_str(), path.c_str()) != 0)
+        return -1;
+
+    std::shared_ptr<Journal_Segment> seg = pspare;
+    pspare = nullptr;
+
+    if (pseg)
+    {
+        Journal_Retired old;
+        old.seg = pseg;
+        old.from = synced_off;
+        old.to = write_off;
+        old.last_seq = last_seq;
+        retired.push_back(old);
+    } // end if
+
+    Journal_Seg_Header hdr;
+    hdr.magic = JOURNAL_MAGIC;
+    hdr.reserved = 0;
+    hdr.first_seq = first_seq;
+    iCpy(seg->pmap, &hdr, sizeof(hdr));
+    seg->first_seq = first_seq;
+
+    pseg = seg;
+    write_off = sizeof(hdr);
+    synced_off = 0;
+    dirty_bytes += sizeof(hdr);
+    bdir_dirty = true;
+    segs.push_back(first_seq);
+
+    flush_cv.notify_one();      // the old one to sync, the next spare to make
+    return 0;
+} // end Roll
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Walks the good records of a segment in order, handing those from from_seq on to replay (if given).
+ *
+ * @param [first_seq] the segment
+ * @param [from_seq] the first record wanted
+ * @param [replay] gets the records; may be nullptr to just walk
+ * @param [arg] passed to replay
+ * @param [last] gets the seq of the last good record; left alone if there's none
+ * @param [bstop] set when replay asked to stop
+ *
+ * @return s64
+ *  records handed to replay or -1 when the segment can't be read
+ */
+static s64 Scan_Segment(const u64 first_seq, const u64 from_seq, pfn_Journal_Replay replay, void *arg, u64 &last,
+    bool &bstop)
+{
+    int fd = open(Segment_Path(first_seq).c_str(), O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return -1;
+    } // end if
+
+    if ((u64)st.st_size < sizeof(Journal_Seg_Header))
+    {
+        close(fd);
+        return 0;       // made but never written to
+    } // end if
+
+    u64 size = (u64)st.st_size;
+    void *p = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+        return -1;
+
+    madvise(p, size, MADV_SEQUENTIAL);
+    const u8 *pmap = (const u8*)p;
+    s64 count{0};
+
+    Journal_Seg_Header shdr;
+    iCpy(&shdr, pmap, sizeof(shdr));
+
+    u64 off = sizeof(shdr);
+    u64 expect = first_seq;
+    while (shdr.magic == JOURNAL_MAGIC && off + sizeof(Journal_Rec_Header) <= size)
+    {
+        Journal_Rec_Header hdr;
+        iCpy(&hdr, pmap + off, sizeof(hdr));
+
+        // the end, a torn record or something that's not ours; whatever comes after can't be trusted
+        if (!hdr.len || hdr.len > JOURNAL_MAX_RECORD || off + sizeof(hdr) + hdr.len > size || hdr.seq != expect)
+            break;
+
+        const u8 *pdata = pmap + off + sizeof(hdr);
+        if (Record_Crc(Crc32(pdata, hdr.len), hdr.len, hdr.seq) != hdr.crc)
+            break;
+
+        last = hdr.seq;
+        if (replay && hdr.seq >= from_seq)
+        {
+            ++count;
+            if (replay(hdr.seq, pdata, hdr.len, arg))
+            {
+                bstop = true;
+                break;
+            } // end if
+        } // end if
+
+        off += sizeof(hdr) + ALIGN8(hdr.len);
+        ++expect;
+    } // end while
+
+    munmap(p, size);
+    return count;
+} // end Scan_Segment
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Lists the segment files in the journal directory in order; a left over spare is removed.
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+static int List_Segments(std::vector<u64> &list)
+{
+    DIR *pdir = opendir(jnl_cfg.dir.c_str());
+    if (!pdir)
+        return -1;
+
+    struct dirent *pent;
+    list.clear();
+
+    while ((pent = readdir(pdir)) != nullptr)
+    {
+        u64 first;
+        char tail[8];
+
+        if (!strcmp(pent->d_name, SPARE_NAME))
+            unlink((jnl_cfg.dir + "/" SPARE_NAME).c_str());
+        else if (strlen(pent->d_name) == 20 && sscanf(pent->d_name, "%16" SCNx64 "%4s", &first, tail) == 2 &&
+            !strcmp(tail, ".jnl"))
+            list.push_back(first);
+    } // end while
+
+    closedir(pdir);
+    std::sort(list.begin(), list.end());
+    return 0;
+} // end List_Segments
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Brings the disk up to date with the segments rolled off and, when bcurrent is set, with what's been
+ *  appended to the current one; drops the lock while the disk is busy. Caller must hold the lock.
+ */
+static void Flush(std::unique_lock<std::mutex> &lock, const bool bcurrent)
+{
+    std::vector<Journal_Retired> old(retired.begin(), retired.end());
+    std::shared_ptr<Journal_Segment> seg = bcurrent ? pseg : nullptr;
+    u64 from{synced_off}, to{write_off}, target{bcurrent ? last_seq : synced_seq};
+    bool bdir{bdir_dirty};
+
+    if (!bcurrent && !old.empty())
+        target = old.back().last_seq;
+    if (bcurrent)
+        dirty_bytes = 0;
+    bdir_dirty = false;
+    lock.unlock();
+
+    int r{0};
+    for (size_t i = 0; i < old.size() && !r; i++)
+        r = Sync_Range(*old[i].seg, old[i].from, old[i].to);
+    if (!r && seg)
+        r = Sync_Range(*seg, from, to);
+    if (!r && bdir)
+        r = Sync_Dir();
+
+    lock.lock();
+    if (r)
+    {
+        Dump_Err("journal: flush failed");
+        bjnl_failed = true;
+        spare_cv.notify_all();
+    } // end if
+    else
+    {
+        // only the flusher takes them off, thus those synced are still the first ones
+        retired.erase(retired.begin(), retired.begin() + old.size());
+
+        // a roll in the mean time has put the segment on the retired list and synced_off to the new one
+        if (seg && seg == pseg && to > synced_off)
+            synced_off = to;
+        if (target > synced_seq)
+            synced_seq = target;
+        ++jnl_stats.syncs;
+    } // end else
+
+    synced_cv.notify_all();
+} // end Flush
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Flusher thread; flushes as the sync policy says (and whenever someone waits on it), syncs the segments
+ *  rolled off whatever the policy, and keeps a spare segment ready in between.
+ */
+static void Run_Flusher()
+{
+    std::unique_lock<std::mutex> lock(jnl_lock);
+
+    while (bjnl_running)
+    {
+        // only what's left to do counts; waking up to nothing would spin with the lock held
+        auto bwake = []() {
+            return !bjnl_running || (!bjnl_failed && ((sync_waiters && (synced_seq < last_seq || bdir_dirty)) ||
+                !pspare || !retired.empty() || (jnl_cfg.sync == JOURNAL_SYNC_INTERVAL &&
+                dirty_bytes >= jnl_cfg.sync_bytes)));
+        };
+
+        if (jnl_cfg.sync == JOURNAL_SYNC_INTERVAL)
+            flush_cv.wait_for(lock, std::chrono::milliseconds(jnl_cfg.sync_interval_ms), bwake);
+        else
+            flush_cv.wait(lock, bwake);
+
+        if (!bjnl_running)
+            break;
+
+        // appends may be held up on the spare; they come first
+        if (!pspare && !bjnl_failed)
+        {
+            lock.unlock();
+            auto spare = Make_Segment(jnl_cfg.dir + "/" SPARE_NAME, jnl_cfg.segment_size);
+            lock.lock();
+
+            if (!spare)
+            {
+                Dump_Err("journal: unable to make a spare segment");
+                bjnl_failed = true;
+                synced_cv.notify_all();
+            } // end if
+            else
+                pspare = spare;
+
+            spare_cv.notify_all();
+        } // end if
+
+        bool bcurrent = (synced_seq < last_seq || bdir_dirty) && (jnl_cfg.sync != JOURNAL_SYNC_NONE || sync_waiters);
+        if (!bjnl_failed && (bcurrent || !retired.empty()))
+            Flush(lock, bcurrent);
+    } // end while
+} // end Run_Flusher
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Waits until the flusher has the record seq on disk; caller must hold the lock.
+ *
+ * @return int
+ *  0 on success, -1 when the journal failed or got closed first
+ */
+static int Wait_Synced(std::unique_lock<std::mutex> &lock, const u64 seq)
+{
+    ++sync_waiters;
+    flush_cv.notify_one();
+    synced_cv.wait(lock, [seq]() { return synced_seq >= seq || bjnl_failed || !bjnl_running; });
+    --sync_waiters;
+
+    return synced_seq >= seq ? 0 : -1;
+} // end Wait_Synced
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Opens the journal in config.dir and starts the flusher. Numbering carries on from the last good record on
+ *  disk; appending always starts a fresh segment, thus a torn tail left by a crash is never written after.
+ *
+ * @param [config] the journal config
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+int Journal_Open(const Journal_Config &config)
+{
+    std::lock_guard<std::mutex> guard(jnl_lock);
+
+    if (bjnl_running)
+        return -1;
+
+    if (config.segment_size < sizeof(Journal_Seg_Header) + sizeof(Journal_Rec_Header) + JOURNAL_MAX_RECORD)
+        return -1;
+
+    jnl_cfg = config;
+    if (List_Segments(segs) < 0)
+    {
+        Dump_Err("journal: unable to read %s", jnl_cfg.dir.c_str());
+        return -1;
+    } // end if
+
+    // the last segment with a good record tells where numbering left off; empty ones at the end would only
+    //  clash by name with the one made next
+    last_seq = 0;
+    while (!segs.empty())
+    {
+        u64 last{0};
+        bool bstop{false};
+
+        if (Scan_Segment(segs.back(), 0, nullptr, nullptr, last, bstop) < 0)
+        {
+            Dump_Err("journal: unable to read %s", Segment_Path(segs.back()).c_str());
+            return -1;
+        } // end if
+
+        if (last)
+        {
+            last_seq = last;
+            break;
+        } // end if
+
+        unlink(Segment_Path(segs.back()).c_str());
+        segs.pop_back();
+    } // end while
+
+    // the first spare is made here, so that even the first append doesn't wait on the flusher
+    pspare = Make_Segment(jnl_cfg.dir + "/" SPARE_NAME, jnl_cfg.segment_size);
+    if (!pspare)
+    {
+        Dump_Err("journal: unable to make a segment in %s", jnl_cfg.dir.c_str());
+        return -1;
+    } // end if
+
+    synced_seq = last_seq;
+    pseg = nullptr;
+    retired.clear();
+    write_off = synced_off = dirty_bytes = 0;
+    sync_waiters = 0;
+    bjnl_failed = bdir_dirty = false;
+    jnl_stats = Journal_Stats();
+
+    bjnl_running = true;
+    pflusher = new std::thread(Run_Flusher);
+
+    return 0;
+} // end Journal_Open
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Flushes what's left, stops the flusher and closes the journal.
+ *
+ * @return int
+ *  0 on success, -1 if not open or the last flush failed
+ */
+int Journal_Close()
+{
+    {
+        std::lock_guard<std::mutex> guard(jnl_lock);
+        if (!bjnl_running)
+            return -1;
+
+        bjnl_running = false;
+        flush_cv.notify_all();
+        synced_cv.notify_all();
+        spare_cv.notify_all();
+    }
+
+    pflusher->join();
+    delete pflusher;
+    pflusher = nullptr;
+
+    std::lock_guard<std::mutex> guard(jnl_lock);
+    int r{0};
+    for (auto &old : retired)
+    {
+        if (Sync_Range(*old.seg, old.from, old.to) != 0)
+            r = -1;
+    } // end for
+
+    if (pseg && (Sync_Range(*pseg, synced_off, write_off) != 0 || Sync_Dir() != 0))
+        r = -1;
+
+    retired.clear();
+    pseg = nullptr;
+    if (pspare)
+    {
+        pspare = nullptr;
+        unlink((jnl_cfg.dir + "/" SPARE_NAME).c_str());
+    } // end if
+
+    return r;
+} // end Journal_Close
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Tells if the journal is open; cheap enough for the receive path.
+ */
+bool Journal_Is_Open()
+{
+    return bjnl_running.load(std::memory_order_relaxed);
+} // end Journal_Is_Open
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Appends a record. The record is in the journal (and seen by a replay) when this returns; it's on disk
+ *  when this returns only with JOURNAL_SYNC_ALWAYS, otherwise see Journal_Sync.
+ *
+ * @param [pdata] the record
+ * @param [len] its length; up to JOURNAL_MAX_RECORD
+ *
+ * @return s64
+ *  the record's seq (from 1 up) or -1 on fail
+ */
+s64 Journal_Append(const void *pdata, const u32 len)
+{
+    if (!pdata || !len || len > JOURNAL_MAX_RECORD)
+        return -1;
+
+    u32 data_crc = Crc32(pdata, len);      // the bulk of the work, kept out of the lock
+    u64 need = sizeof(Journal_Rec_Header) + ALIGN8(len);
+
+    std::unique_lock<std::mutex> lock(jnl_lock);
+    if (!bjnl_running || bjnl_failed)
+        return -1;
+
+    while (!pseg || write_off + need > pseg->size)
+    {
+        if (!pspare)
+        {
+            // the flusher is still making it; waiting beats making one here, on the receive path
+            ++jnl_stats.spare_waits;
+            flush_cv.notify_one();
+            spare_cv.wait(lock);
+            if (!bjnl_running || bjnl_failed)
+                return -1;
+
+            continue;
+        } // end if
+
+        if (Roll(last_seq + 1) < 0)
+        {
+            Dump_Err("journal: unable to start a new segment");
+            bjnl_failed = true;
+            synced_cv.notify_all();
+            spare_cv.notify_all();
+            return -1;
+        } // end if
+    } // end while
+
+    Journal_Rec_Header hdr;
+    hdr.len = len;
+    hdr.seq = last_seq + 1;
+    hdr.crc = Record_Crc(data_crc, len, hdr.seq);
+
+    iCpy(pseg->pmap + write_off + sizeof(hdr), pdata, len);
+    iCpy(pseg->pmap + write_off, &hdr, sizeof(hdr));
+
+    last_seq = hdr.seq;
+    write_off += need;
+    dirty_bytes += need;
+    ++jnl_stats.appended;
+    jnl_stats.bytes += len;
+
+    if (jnl_cfg.sync == JOURNAL_SYNC_ALWAYS)
+    {
+        if (Wait_Synced(lock, hdr.seq) < 0)
+            return -1;
+    } // end if
+    else if (jnl_cfg.sync == JOURNAL_SYNC_INTERVAL && dirty_bytes >= jnl_cfg.sync_bytes)
+        flush_cv.notify_one();
+
+    return (s64)hdr.seq;
+} // end Journal_Append
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Waits until every record up to seq is on disk; works whatever the sync policy.
+ *
+ * @param [seq] the record to wait on; 0 for all appended so far
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+int Journal_Sync(const u64 seq)
+{
+    std::unique_lock<std::mutex> lock(jnl_lock);
+    if (!bjnl_running)
+        return -1;
+
+    u64 target = seq && seq < last_seq ? seq : last_seq;
+    if (synced_seq >= target)
+        return 0;
+
+    return Wait_Synced(lock, target);
+} // end Journal_Sync
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Hands every good record from from_seq on to replay, in order and on the caller's thread; meant for picking
+ *  up after a restart, before new records come in. Segments wholly before from_seq are not read at all.
+ *
+ * @param [from_seq] the first record wanted
+ * @param [replay] gets the records
+ * @param [arg] passed to replay
+ *
+ * @return s64
+ *  the number of records replayed or -1 on fail
+ */
+s64 Journal_Replay(const u64 from_seq, pfn_Journal_Replay replay, void *arg)
+{
+    std::vector<u64> list;
+    {
+        std::lock_guard<std::mutex> guard(jnl_lock);
+        if (bjnl_running)
+            list = segs;
+        else if (List_Segments(list) < 0)
+            return -1;
+    }
+
+    if (!replay)
+        return -1;
+
+    s64 total{0};
+    bool bstop{false};
+
+    for (size_t i = 0; i < list.size() && !bstop; i++)
+    {
+        if (i + 1 < list.size() && list[i + 1] <= from_seq)
+            continue;
+
+        u64 last{0};
+        s64 count = Scan_Segment(list[i], from_seq, replay, arg, last, bstop);
+        if (count < 0)
+            return -1;
+
+        total += count;
+    } // end for
+
+    return total;
+} // end Journal_Replay
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Deletes the segments that hold nothing past upto_seq; call once the records up to there have been handed
+ *  downstream. The segment being appended to is always kept.
+ *
+ * @param [upto_seq] the last record no longer needed
+ *
+ * @return int
+ *  the number of segments deleted or -1 when not open
+ */
+int Journal_Trim(const u64 upto_seq)
+{
+    std::lock_guard<std::mutex> guard(jnl_lock);
+    if (!bjnl_running)
+        return -1;
+
+    size_t n{0};
+    while (n + 1 < segs.size() && segs[n + 1] <= upto_seq + 1)
+    {
+        unlink(Segment_Path(segs[n]).c_str());
+        ++n;
+    } // end while
+
+    segs.erase(segs.begin(), segs.begin() + n);
+    if (n)
+        bdir_dirty = true;
+
+    return (int)n;
+} // end Journal_Trim
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the journal counters.
+ *
+ * @param [pstats] gets the counters
+ */
+void Journal_Get_Stats(Journal_Stats *pstats)
+{
+    std::lock_guard<std::mutex> guard(jnl_lock);
+
+    if (!pstats)
+        return;
+
+    *pstats = jnl_stats;
+    pstats->segments = segs.size();
+    pstats->last_seq = last_seq;
+    pstats->synced_seq = synced_seq;
+} // end Journal_Get_Stats
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,786 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for the batched ODBC sink. Parameters are bound by column: each one points at an
+//  array with a row per element, and the statement is executed once with the parameter set size set to the
+//  rows in the batch. Autocommit is off; a batch is committed, or rolled back, whole. A batch the database
+//  turns down goes again a row at a time, each row committed on its own, thus only the rows at fault are lost.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "odbc-sink.h"
+#include "global-errors.h"
+
+#include <sql.h>
+#include <sqlext.h>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define ODBC_USER_ID_SIZE       PUNCH_USER_ID_SIZE
+#define ODBC_NAME_SIZE          25          // the device's 24 bytes and a nul
+#define ODBC_DEVICE_ID_SIZE     10          // User_Entry's 9 bytes and a nul
+#define ODBC_RETRY_MS           1000        // least wait before trying a lost connection again
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  The column arrays of an attendance batch
+ */
+struct Odbc_Batch
+{
+    size_t n{0};                                // rows filled
+    std::vector<SQLCHAR> user_ids;              // ODBC_USER_ID_SIZE a row
+    std::vector<SQLLEN> user_id_lens;
+    std::vector<SQL_TIMESTAMP_STRUCT> times;
+    std::vector<SQLINTEGER> machines;
+    std::vector<SQLSMALLINT> verify_types;
+    std::vector<SQLSMALLINT> verify_states;
+    std::vector<SQLUSMALLINT> status;           // per row result of the execute
+    size_t done{0};                             // rows settled; a try cut short by the connection goes on here
+    size_t rejected{0};                         // of those, the ones turned down
+
+    Odbc_Batch(const size_t rows)
+        : user_ids(rows * ODBC_USER_ID_SIZE), user_id_lens(rows), times(rows), machines(rows),
+          verify_types(rows), verify_states(rows), status(rows)
+    {
+    }
+};
+
+
+/**
+ * @brief
+ *  The column arrays of a user batch
+ */
+struct Odbc_User_Batch
+{
+    std::vector<SQLCHAR> ids;                   // ODBC_DEVICE_ID_SIZE a row
+    std::vector<SQLCHAR> names;                 // ODBC_NAME_SIZE a row
+    std::vector<SQLLEN> id_lens, name_lens;
+    std::vector<SQLINTEGER> serials, privileges, groups, machines;
+    std::vector<SQLBIGINT> cards;
+    std::vector<SQLUSMALLINT> status;
+
+    Odbc_User_Batch(const size_t rows, const int machine_num)
+        : ids(rows * ODBC_DEVICE_ID_SIZE), names(rows * ODBC_NAME_SIZE), id_lens(rows), name_lens(rows),
+          serials(rows), privileges(rows), groups(rows), machines(rows, machine_num), cards(rows), status(rows)
+    {
+    }
+};
+
+
+// binds the parameters of a statement to the column arrays, starting at row first
+typedef void (*pfn_Bind_Rows)(SQLHSTMT hstmt, void *pcols, const size_t first);
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Logs the diagnostics of a handle after a failed call.
+ *
+ * @return std::string
+ *  the SQLSTATE of the first record; empty if there's none
+ */
+static std::string Log_Diag(const SQLSMALLINT type, SQLHANDLE handle, const char *what)
+{
+    SQLCHAR state[6], msg[SQL_MAX_MESSAGE_LENGTH];
+    SQLINTEGER native;
+    SQLSMALLINT len;
+    std::string first;
+
+    for (SQLSMALLINT i = 1; SQLGetDiagRec(type, handle, i, state, &native, msg, sizeof(msg), &len) ==
+        SQL_SUCCESS; i++)
+    {
+        if (first.empty())
+            first = (const char*)state;
+        Dump_Err("odbc: %s: [%s] %s", what, state, msg);
+    } // end for
+
+    return first;
+} // end Log_Diag
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  att_time to a SQL timestamp; the inverse of Encode_Time.
+ */
+static void To_Timestamp(u32 att_time, SQL_TIMESTAMP_STRUCT &ts)
+{
+    ts.second = att_time % 60;          att_time /= 60;
+    ts.minute = att_time % 60;          att_time /= 60;
+    ts.hour = att_time % 24;            att_time /= 24;
+    ts.day = att_time % 31 + 1;         att_time /= 31;
+    ts.month = att_time % 12 + 1;       att_time /= 12;
+    ts.year = att_time + 2000;
+    ts.fraction = 0;
+} // end To_Timestamp
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Copies a device string, which isn't always nul terminated, into a column.
+ */
+static SQLLEN Put_String(SQLCHAR *pdest, const char *psrc, const size_t src_size, const size_t dest_size)
+{
+    size_t len = strnlen(psrc, std::min(src_size, dest_size - 1));
+    iCpy(pdest, psrc, len);
+    pdest[len] = 0;
+    return (SQLLEN)len;
+} // end Put_String
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Tells if a failure was the connection going; connection errors are class 08, and some drivers only own up
+ *  to it through SQL_ATTR_CONNECTION_DEAD.
+ */
+static bool Connection_Lost(SQLHDBC hdbc, const std::string &state)
+{
+    SQLUINTEGER dead{SQL_CD_FALSE};
+
+    if (state.compare(0, 2, "08") == 0)
+        return true;
+
+    return SQL_SUCCEEDED(SQLGetConnectAttr(hdbc, SQL_ATTR_CONNECTION_DEAD, &dead, 0, nullptr)) &&
+        dead == SQL_CD_TRUE;
+} // end Connection_Lost
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Executes what's bound and commits it, or rolls it back on failure. The diagnostics are read before the
+ *  statement is closed; the next call on a handle clears them. SQL_NO_DATA is a success that touched no rows,
+ *  which a MERGE or upsert of rows already there comes back with.
+ *
+ * @param [state] gets the SQLSTATE of the failure
+ *
+ * @return int
+ *  0 on success, -1 on failure
+ */
+static int Execute_Commit(SQLHDBC hdbc, SQLHSTMT hstmt, const char *what, std::string &state)
+{
+    SQLRETURN rc = SQLExecute(hstmt);
+    if (rc == SQL_NO_DATA)
+        rc = SQL_SUCCESS;
+
+    state.clear();
+    if (rc != SQL_SUCCESS)
+        state = Log_Diag(SQL_HANDLE_STMT, hstmt, what);
+    SQLFreeStmt(hstmt, SQL_CLOSE);
+
+    if (SQL_SUCCEEDED(rc))
+    {
+        if (SQL_SUCCEEDED(SQLEndTran(SQL_HANDLE_DBC, hdbc, SQL_COMMIT)))
+            return 0;
+
+        state = Log_Diag(SQL_HANDLE_DBC, hdbc, what);
+    } // end if
+
+    SQLEndTran(SQL_HANDLE_DBC, hdbc, SQL_ROLLBACK);
+    return -1;
+} // end Execute_Commit
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes the rows [done, n) of a set of column arrays with one execute. When the database turns the lot
+ *  down (one bad row is enough on most) the rows go again one at a time, so that only the bad ones are lost.
+ *
+ * @param [bind] binds the statement to the arrays from a given row
+ * @param [pcols] the column arrays
+ * @param [pstatus] the per row status array; n long
+ * @param [n] rows in the arrays
+ * @param [done] the first row to go; gets how far it got
+ * @param [rejected] gets the rows turned down added
+ * @param [what] for the log
+ *
+ * @return int
+ *  0 once every row is written or turned down, -2 when the connection went; rows from done on are yet to go
+ */
+static int Execute_Rows(SQLHDBC hdbc, SQLHSTMT hstmt, pfn_Bind_Rows bind, void *pcols, SQLUSMALLINT *pstatus,
+    const size_t n, size_t &done, size_t &rejected, const char *what)
+{
+    std::string state;
+
+    if (done >= n)
+        return 0;
+
+    std::fill(pstatus + done, pstatus + n, (SQLUSMALLINT)SQL_PARAM_UNUSED);
+    SQLSetStmtAttr(hstmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)(SQLULEN)(n - done), 0);
+    SQLSetStmtAttr(hstmt, SQL_ATTR_PARAM_STATUS_PTR, pstatus + done, 0);
+    bind(hstmt, pcols, done);
+
+    if (Execute_Commit(hdbc, hstmt, what, state) == 0)
+    {
+        // with info, some rows may have been turned down on their own
+        for (size_t i = done; i < n; i++)
+            rejected += pstatus[i] == SQL_PARAM_ERROR;
+
+        done = n;
+        return 0;
+    } // end if
+
+    if (Connection_Lost(hdbc, state))
+        return -2;
+
+    SQLSetStmtAttr(hstmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)1, 0);
+    for (; done < n; done++)
+    {
+        SQLSetStmtAttr(hstmt, SQL_ATTR_PARAM_STATUS_PTR, pstatus + done, 0);
+        bind(hstmt, pcols, done);
+        if (Execute_Commit(hdbc, hstmt, what, state) == 0)
+            continue;
+
+        if (Connection_Lost(hdbc, state))
+            return -2;
+
+        ++rejected;
+    } // end for
+
+    return 0;
+} // end Execute_Rows
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  pfn_Bind_Rows for Odbc_Batch
+ */
+static void Bind_Att(SQLHSTMT hstmt, void *pcols, const size_t first)
+{
+    Odbc_Batch &b = *(Odbc_Batch*)pcols;
+
+    SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, ODBC_USER_ID_SIZE - 1, 0,
+        &b.user_ids[first * ODBC_USER_ID_SIZE], ODBC_USER_ID_SIZE, &b.user_id_lens[first]);
+    SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT, SQL_C_TYPE_TIMESTAMP, SQL_TYPE_TIMESTAMP, 19, 0, &b.times[first],
+        sizeof(SQL_TIMESTAMP_STRUCT), nullptr);
+    SQLBindParameter(hstmt, 3, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &b.machines[first], 0, nullptr);
+    SQLBindParameter(hstmt, 4, SQL_PARAM_INPUT, SQL_C_SSHORT, SQL_SMALLINT, 0, 0, &b.verify_types[first], 0,
+        nullptr);
+    SQLBindParameter(hstmt, 5, SQL_PARAM_INPUT, SQL_C_SSHORT, SQL_SMALLINT, 0, 0, &b.verify_states[first], 0,
+        nullptr);
+} // end Bind_Att
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  pfn_Bind_Rows for Odbc_User_Batch
+ */
+static void Bind_Users(SQLHSTMT hstmt, void *pcols, const size_t first)
+{
+    Odbc_User_Batch &b = *(Odbc_User_Batch*)pcols;
+
+    SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, ODBC_DEVICE_ID_SIZE - 1, 0,
+        &b.ids[first * ODBC_DEVICE_ID_SIZE], ODBC_DEVICE_ID_SIZE, &b.id_lens[first]);
+    SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, ODBC_NAME_SIZE - 1, 0,
+        &b.names[first * ODBC_NAME_SIZE], ODBC_NAME_SIZE, &b.name_lens[first]);
+    SQLBindParameter(hstmt, 3, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &b.serials[first], 0, nullptr);
+    SQLBindParameter(hstmt, 4, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &b.privileges[first], 0, nullptr);
+    SQLBindParameter(hstmt, 5, SQL_PARAM_INPUT, SQL_C_SBIGINT, SQL_BIGINT, 0, 0, &b.cards[first], 0, nullptr);
+    SQLBindParameter(hstmt, 6, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &b.groups[first], 0, nullptr);
+    SQLBindParameter(hstmt, 7, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &b.machines[first], 0, nullptr);
+} // end Bind_Users
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief Construct a new Odbc_Sink object; closed.
+ */
+Odbc_Sink::Odbc_Sink()
+    : henv{nullptr}, hdbc{nullptr}, hatt{nullptr}, huser{nullptr}, brunning{false}, bflush{false}, added{0},
+      settled{0}
+{
+} // end constructor
+
+
+//==============================================================================================================|
+/**
+ * @brief Destroy the Odbc_Sink object; what's pending is written first.
+ */
+Odbc_Sink::~Odbc_Sink()
+{
+    Close();
+} // end destructor
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Connects, prepares the statements and starts the flusher.
+ *
+ * @param [config] settings
+ *
+ * @return int
+ *  0 on success, -1 if open already or the database can't be had
+ */
+int Odbc_Sink::Open(const Odbc_Sink_Config &config)
+{
+    if (brunning)
+        return -1;
+
+    this->config = config;
+    if (!this->config.batch_size)
+        this->config.batch_size = ODBC_BATCH_SIZE;
+    if (!this->config.flush_ms)
+        this->config.flush_ms = ODBC_FLUSH_MS;
+
+    {
+        std::lock_guard<std::mutex> guard(db_lock);
+        if (Connect() < 0)
+            return -1;
+    }
+
+    pfilling.reset(new Odbc_Batch(this->config.batch_size));
+    pflushing.reset(new Odbc_Batch(this->config.batch_size));
+    added = settled = 0;
+    stats = Odbc_Sink_Stats();
+    bflush = false;
+    brunning = true;
+    flusher = std::thread(&Odbc_Sink::Flusher, this);
+
+    return 0;
+} // end Open
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes what's pending and disconnects; if the database is out, one more try is made and the rows are
+ *  dropped (counted in stats) when it fails.
+ *
+ * @return int
+ *  0 on success, -1 if not open
+ */
+int Odbc_Sink::Close()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!brunning)
+            return -1;
+
+        brunning = false;
+    }
+
+    cv.notify_all();
+    cv_space.notify_all();
+    flusher.join();
+
+    std::lock_guard<std::mutex> guard(db_lock);
+    Disconnect();
+    return 0;
+} // end Close
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Takes a punch into the filling batch; waits only while both batches are taken.
+ *
+ * @param [punch] the punch
+ *
+ * @return int
+ *  0 on success, -1 if not open
+ */
+int Odbc_Sink::Add(const Punch_Record &punch)
+{
+    return Add(&punch, 1);
+} // end Add
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Takes punches into the filling batch.
+ *
+ * @param [ppunches] the punches
+ * @param [count] how many
+ *
+ * @return int
+ *  0 on success, -1 if not open
+ */
+int Odbc_Sink::Add(const Punch_Record *ppunches, const size_t count)
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        while (brunning && pfilling->n >= config.batch_size)
+            cv_space.wait(guard);
+
+        if (!brunning)
+            return -1;
+
+        Odbc_Batch &b = *pfilling;
+        const Punch_Record &p = ppunches[i];
+        size_t r = b.n++;
+
+        b.user_id_lens[r] = Put_String(&b.user_ids[r * ODBC_USER_ID_SIZE], p.user_id, sizeof(p.user_id),
+            ODBC_USER_ID_SIZE);
+        To_Timestamp(p.att_time, b.times[r]);
+        b.machines[r] = p.machine_num;
+        b.verify_types[r] = p.verify_type;
+        b.verify_states[r] = p.verify_state;
+        ++added;
+
+        if (b.n == config.batch_size)
+            cv.notify_one();
+    } // end for
+
+    return 0;
+} // end Add
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes the users of a device, a batch at a time on the caller's thread; they come by the download, not as
+ *  a stream.
+ *
+ * @param [machine_num] the device they came from
+ * @param [users] the users
+ *
+ * @return int
+ *  0 on success, -1 if rows were turned down, -2 if the database can't be had
+ */
+int Odbc_Sink::Write_Users(const int machine_num, const std::vector<User_Entry> &users)
+{
+    std::lock_guard<std::mutex> guard(db_lock);
+    size_t batch = config.batch_size ? config.batch_size : ODBC_BATCH_SIZE;
+    int ret{0};
+
+    if (!hdbc && Connect() < 0)
+        return -2;
+
+    Odbc_User_Batch cols(batch, machine_num);
+
+    for (size_t first = 0; first < users.size(); first += batch)
+    {
+        size_t n = std::min(batch, users.size() - first);
+        size_t done{0}, rejected{0};
+
+        for (size_t i = 0; i < n; i++)
+        {
+            const User_Entry &u = users[first + i];
+            cols.id_lens[i] = Put_String(&cols.ids[i * ODBC_DEVICE_ID_SIZE], u.user_id, sizeof(u.user_id),
+                ODBC_DEVICE_ID_SIZE);
+            cols.name_lens[i] = Put_String(&cols.names[i * ODBC_NAME_SIZE], u.name, sizeof(u.name),
+                ODBC_NAME_SIZE);
+            cols.serials[i] = u.serial_number;
+            cols.privileges[i] = u.permissions;
+            cols.cards[i] = u.card_number;
+            cols.groups[i] = u.group_number;
+        } // end for
+
+        int r = Execute_Rows((SQLHDBC)hdbc, (SQLHSTMT)huser, Bind_Users, &cols, cols.status.data(), n, done,
+            rejected, "users");
+
+        {
+            std::lock_guard<std::mutex> sguard(lock);
+            stats.users += done - rejected;
+            stats.failed += rejected;
+            ++stats.batches;
+        }
+
+        if (r == -2)
+        {
+            Disconnect();
+            return -2;
+        } // end if
+
+        if (rejected)
+            ret = -1;
+    } // end for
+
+    return ret;
+} // end Write_Users
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Waits until every row taken in so far is written (or turned down).
+ *
+ * @return int
+ *  0 on success, -1 if the sink was closed meanwhile
+ */
+int Odbc_Sink::Flush()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    u64 target = added;
+
+    while (brunning && settled < target)
+    {
+        bflush = true;
+        cv.notify_one();
+        cv_space.wait(guard);
+    } // end while
+
+    return settled >= target ? 0 : -1;
+} // end Flush
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  A pfn_Punch_Sink; arg is the Odbc_Sink. Fits behind Punch_Dedup or Fleet_Merge_Attendance.
+ */
+void Odbc_Sink::On_Punches(const Punch_Record *ppunches, const size_t count, void *arg)
+{
+    ((Odbc_Sink*)arg)->Add(ppunches, count);
+} // end On_Punches
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Event bus handler; arg is the Odbc_Sink. Subscribe with RT_ATTLOG.
+ */
+void Odbc_Sink::On_Events(const Event_Record *precs, const size_t count, void *arg)
+{
+    Odbc_Sink *psink = (Odbc_Sink*)arg;
+    Punch_Record punch;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (Punch_From_Event(precs[i], punch))
+            psink->Add(&punch, 1);
+    } // end for
+} // end On_Events
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the sink counters.
+ */
+Odbc_Sink_Stats Odbc_Sink::Get_Stats()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    Odbc_Sink_Stats out = stats;
+
+    out.pending = added - settled;
+    return out;
+} // end Get_Stats
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Connects and prepares the statements; caller holds db_lock.
+ *
+ * @return int
+ *  0 on success, -1 on failure (logged)
+ */
+int Odbc_Sink::Connect()
+{
+    SQLHENV env;
+    SQLHDBC dbc;
+    SQLHSTMT att, user;
+
+    if (!SQL_SUCCEEDED(SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &env)))
+    {
+        Dump_Err("odbc: unable to allocate an environment");
+        return -1;
+    } // end if
+
+    henv = env;
+    SQLSetEnvAttr(env, SQL_ATTR_ODBC_VERSION, (SQLPOINTER)SQL_OV_ODBC3, 0);
+    if (!SQL_SUCCEEDED(SQLAllocHandle(SQL_HANDLE_DBC, env, &dbc)))
+    {
+        Log_Diag(SQL_HANDLE_ENV, env, "connection handle");
+        Disconnect();
+        return -1;
+    } // end if
+
+    SQLSetConnectAttr(dbc, SQL_ATTR_LOGIN_TIMEOUT, (SQLPOINTER)5, 0);
+    if (!SQL_SUCCEEDED(SQLDriverConnect(dbc, nullptr, (SQLCHAR*)config.connection.c_str(), SQL_NTS, nullptr, 0,
+        nullptr, SQL_DRIVER_NOPROMPT)))
+    {
+        Log_Diag(SQL_HANDLE_DBC, dbc, "connect");
+        SQLFreeHandle(SQL_HANDLE_DBC, dbc);
+        Disconnect();
+        return -1;
+    } // end if
+
+    hdbc = dbc;
+    SQLSetConnectAttr(dbc, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER)SQL_AUTOCOMMIT_OFF, SQL_IS_UINTEGER);
+
+    if (!SQL_SUCCEEDED(SQLAllocHandle(SQL_HANDLE_STMT, dbc, &att)))
+    {
+        Log_Diag(SQL_HANDLE_DBC, dbc, "statement handle");
+        Disconnect();
+        return -1;
+    } // end if
+
+    hatt = att;
+    if (!SQL_SUCCEEDED(SQLPrepare(att, (SQLCHAR*)config.att_insert.c_str(), SQL_NTS)))
+    {
+        Log_Diag(SQL_HANDLE_STMT, att, "prepare attendance");
+        Disconnect();
+        return -1;
+    } // end if
+
+    if (!SQL_SUCCEEDED(SQLAllocHandle(SQL_HANDLE_STMT, dbc, &user)))
+    {
+        Log_Diag(SQL_HANDLE_DBC, dbc, "statement handle");
+        Disconnect();
+        return -1;
+    } // end if
+
+    huser = user;
+    if (!SQL_SUCCEEDED(SQLPrepare(user, (SQLCHAR*)config.user_insert.c_str(), SQL_NTS)))
+    {
+        Log_Diag(SQL_HANDLE_STMT, user, "prepare users");
+        Disconnect();
+        return -1;
+    } // end if
+
+    SQLSetStmtAttr(att, SQL_ATTR_PARAM_BIND_TYPE, (SQLPOINTER)SQL_PARAM_BIND_BY_COLUMN, 0);
+    SQLSetStmtAttr(user, SQL_ATTR_PARAM_BIND_TYPE, (SQLPOINTER)SQL_PARAM_BIND_BY_COLUMN, 0);
+    return 0;
+} // end Connect
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Lets go of whatever handles there are; caller holds db_lock.
+ */
+void Odbc_Sink::Disconnect()
+{
+    if (huser)
+        SQLFreeHandle(SQL_HANDLE_STMT, (SQLHSTMT)huser);
+    if (hatt)
+        SQLFreeHandle(SQL_HANDLE_STMT, (SQLHSTMT)hatt);
+    if (hdbc)
+    {
+        SQLDisconnect((SQLHDBC)hdbc);
+        SQLFreeHandle(SQL_HANDLE_DBC, (SQLHDBC)hdbc);
+    } // end if
+    if (henv)
+        SQLFreeHandle(SQL_HANDLE_ENV, (SQLHENV)henv);
+
+    henv = hdbc = hatt = huser = nullptr;
+} // end Disconnect
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Sends what's left of an attendance batch and commits it; see Execute_Rows.
+ *
+ * @param [batch] the batch; done and rejected are kept up
+ *
+ * @return int
+ *  0 once every row is written or turned down, -2 when the connection is out and the rest must go again
+ */
+int Odbc_Sink::Execute_Att(Odbc_Batch &batch)
+{
+    std::lock_guard<std::mutex> guard(db_lock);
+
+    if (!hdbc && Connect() < 0)
+        return -2;
+
+    if (Execute_Rows((SQLHDBC)hdbc, (SQLHSTMT)hatt, Bind_Att, &batch, batch.status.data(), batch.n, batch.done,
+        batch.rejected, "attendance") < 0)
+    {
+        Disconnect();
+        return -2;
+    } // end if
+
+    return 0;
+} // end Execute_Att
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The flusher thread; swaps the batches when the filling one is full, its time is up or a Flush asks, and
+ *  writes the full one out with the lock let go.
+ */
+void Odbc_Sink::Flusher()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    u32 retry_ms = std::max(config.flush_ms, (u32)ODBC_RETRY_MS);
+
+    for (;;)
+    {
+        cv.wait_for(guard, std::chrono::milliseconds(config.flush_ms), [this]() {
+            return !brunning || bflush || pfilling->n >= config.batch_size; });
+
+        bflush = false;
+        if (!pfilling->n)
+        {
+            if (!brunning)
+                break;
+
+            continue;
+        } // end if
+
+        std::swap(pfilling, pflushing);
+        cv_space.notify_all();
+
+        Odbc_Batch &batch = *pflushing;
+        int r;
+        for (;;)
+        {
+            bool blast = !brunning;     // closing; one more try and no more
+
+            guard.unlock();
+            r = Execute_Att(batch);
+            guard.lock();
+
+            if (r != -2 || blast)
+                break;
+
+            ++stats.retries;
+            cv.wait_for(guard, std::chrono::milliseconds(retry_ms), [this]() { return !brunning; });
+        } // end for
+
+        if (r == -2)
+            stats.dropped += batch.n - batch.done;
+        else
+            ++stats.batches;
+
+        stats.rows += batch.done - batch.rejected;
+        stats.failed += batch.rejected;
+        settled += batch.n;
+        batch.n = batch.done = batch.rejected = 0;
+        cv_space.notify_all();
+    } // end for
+} // end Flusher
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,774 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for the write behind outbox. Every request is appended to the outbox file as a fixed
+//  size record before it's acknowledged; once applied a small "done" record is appended after it. On open the
+//  file is replayed (done records cancel the ones they name, later records supersede earlier ones for the same
+//  key) and rewritten with only what's still pending.
+//
+//  Pending operations are keyed by (device, user); user writes and deletes share the serial as their key, so a
+//  delete supersedes a write and vice versa. Enrolls are keyed by user id and finger. A key is ready
+//  flush_interval_ms after its first pending write; the writes that supersede it meanwhile don't push that out,
+//  thus a user edited without let up still gets applied. A refused operation waits out a back off of its own.
+//
+//  The applier hands each device's batch to the shared job pool (see job-pool.h) and takes up a device again
+//  only once its batch is done; thus a device sees its writes in order while an unreachable one holds up no
+//  one else's.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "outbox.h"
+#include "device-session.h"
+#include "job-pool.h"
+#include "global-errors.h"
+#include "utils.h"
+
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <fcntl.h>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define OUTBOX_MAGIC        0x584F4258      // "XBOX"
+#define OUTBOX_DONE         0               // op of a record that marks another as applied
+
+// the largest of the things we store
+#define OUTBOX_DATA_LEN     sizeof(User_Entry)
+
+// rewrite the file once it holds this many records more than are pending
+#define OUTBOX_COMPACT_AT   4096
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  A record as it sits in the outbox file; check covers every byte before it.
+ */
+#pragma pack(1)
+typedef struct Outbox_Record_Format
+{
+    u32 magic;                  // OUTBOX_MAGIC
+    u64 seq;                    // order of arrival
+    s32 machine_num;            // the target device
+    u8 op;                      // OUTBOX_XXX or OUTBOX_DONE
+    u8 data[OUTBOX_DATA_LEN];   // User_Entry, the serial, Enroll_Data or for done the seq applied
+    u64 check;                  // Hash_Block of the above
+} Outbox_Record;
+#pragma pack()
+
+
+
+/**
+ * @brief
+ *  A pending operation
+ */
+typedef struct Outbox_Op_Info
+{
+    Outbox_Record rec;          // as written to the file
+    u32 attempts{0};            // times the device refused it
+    u64 ready_at{0};            // not applied before this (ms, steady clock)
+} Outbox_Op;
+
+
+
+/**
+ * @brief
+ *  Per device retry state
+ */
+typedef struct Outbox_Device_Info
+{
+    u64 retry_at{0};            // don't bother the device before this (ms, steady clock)
+    u32 backoff_ms{0};          // current back off; 0 when the last round went fine
+    bool bbusy{false};          // a batch of it is on the job pool
+} Outbox_Device;
+
+
+
+// machine_num, key within the device
+typedef std::pair<int, u64> Outbox_Key;
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+static Outbox_Config outbox_cfg;                    // the running config
+static std::map<Outbox_Key, Outbox_Op> pending;     // what's left to apply
+static std::unordered_map<int, Outbox_Device> outbox_devs;
+static std::mutex outbox_lock;                      // guards all of the above and the file
+static std::condition_variable outbox_cv;           // wakes the applier (new work or stop)
+static std::condition_variable idle_cv;             // wakes Outbox_Flush
+static std::thread *papplier{nullptr};
+static bool boutbox_running{false};
+static int outbox_fd{-1};
+static u64 next_seq{1};
+static u64 file_records{0};                         // records in the file right now
+static u32 in_flight{0};                            // device batches on the job pool
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Milliseconds on the monotonic clock
+ */
+static u64 Now_Ms()
+{
+    return (u64)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+} // end Now_Ms
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Works out the coalescing key for a record; everything that targets the same thing gets the same key.
+ */
+static Outbox_Key Key_Of(const Outbox_Record &rec)
+{
+    u64 id;
+
+    if (rec.op == OUTBOX_ENROLL_USER)
+    {
+        const Enroll_Data *penroll = (const Enroll_Data *)rec.data;
+        id = (1ULL << 63) | (Hash_Block(penroll->user_id, sizeof(penroll->user_id), penroll->finger_index) >> 1);
+    } // end if
+    else
+    {
+        u16 serial;
+        memcpy(&serial, rec.data, sizeof(serial));      // the serial leads a User_Entry as well
+        id = serial;
+    } // end else
+
+    return Outbox_Key(rec.machine_num, id);
+} // end Key_Of
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Seals and appends a single record to the outbox file; caller must hold the lock.
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+static int Append(Outbox_Record &rec, const bool bsync)
+{
+    rec.magic = OUTBOX_MAGIC;
+    rec.check = Hash_Block(&rec, offsetof(Outbox_Record, check));
+
+    if (write(outbox_fd, &rec, sizeof(rec)) != (ssize_t)sizeof(rec))
+    {
+        Dump_Err("outbox: write failed");
+        return -1;
+    } // end if
+
+    if (bsync && fdatasync(outbox_fd) < 0)
+    {
+        Dump_Err("outbox: fdatasync failed");
+        return -1;
+    } // end if
+
+    ++file_records;
+    return 0;
+} // end Append
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Rewrites the outbox file with just the pending records; done in a temp file that's renamed over the old
+ *  one so a crash in between leaves one or the other intact. Caller must hold the lock.
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+static int Compact()
+{
+    std::string tmp = outbox_cfg.path + ".tmp";
+    int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        Dump_Err("outbox: unable to create %s", tmp.c_str());
+        return -1;
+    } // end if
+
+    // rewrite in arrival order, replay depends on it
+    std::vector<const Outbox_Record*> recs;
+    recs.reserve(pending.size());
+    for (auto &p : pending)
+        recs.push_back(&p.second.rec);
+
+    std::sort(recs.begin(), recs.end(), [](const Outbox_Record *a, const Outbox_Record *b) {
+        return a->seq < b->seq; });
+
+    std::vector<u8> buf;
+    buf.reserve(recs.size() * sizeof(Outbox_Record));
+    for (auto prec : recs)
+        buf.insert(buf.end(), (const u8*)prec, (const u8*)prec + sizeof(Outbox_Record));
+
+    if (write(fd, buf.data(), buf.size()) != (ssize_t)buf.size() || fdatasync(fd) < 0 ||
+        rename(tmp.c_str(), outbox_cfg.path.c_str()) < 0)
+    {
+        Dump_Err("outbox: unable to rewrite %s", outbox_cfg.path.c_str());
+        close(fd);
+        unlink(tmp.c_str());
+        return -1;
+    } // end if
+
+    if (outbox_fd >= 0)
+        close(outbox_fd);
+
+    outbox_fd = fd;
+    file_records = recs.size();
+    lseek(outbox_fd, 0, SEEK_END);
+    return 0;
+} // end Compact
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Reads back the outbox file into pending; stops at the first torn or corrupt record (a crash in the middle
+ *  of an append), whatever follows is lost anyway.
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+static int Replay()
+{
+    int fd = open(outbox_cfg.path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return errno == ENOENT ? 0 : -1;
+
+    std::unordered_map<u64, Outbox_Key> by_seq;     // seq : key of the pending ones
+    Outbox_Record recs[256];
+    ssize_t n{0};
+    bool bbad{false};
+
+    while (!bbad && (n = read(fd, recs, sizeof(recs))) > 0)
+    {
+        size_t count = (size_t)n / sizeof(Outbox_Record);
+        for (size_t i = 0; i < count; i++)
+        {
+            Outbox_Record &rec = recs[i];
+            if (rec.magic != OUTBOX_MAGIC || rec.check != Hash_Block(&rec, offsetof(Outbox_Record, check)))
+            {
+                bbad = true;
+                break;
+            } // end if
+
+            if (rec.seq >= next_seq)
+                next_seq = rec.seq + 1;
+
+            if (rec.op == OUTBOX_DONE)
+            {
+                u64 seq;
+                memcpy(&seq, rec.data, sizeof(seq));
+
+                auto it = by_seq.find(seq);
+                if (it != by_seq.end())
+                {
+                    auto p = pending.find(it->second);
+                    if (p != pending.end() && p->second.rec.seq == seq)
+                        pending.erase(p);
+                    by_seq.erase(it);
+                } // end if
+                continue;
+            } // end if
+
+            Outbox_Key key = Key_Of(rec);
+            auto p = pending.find(key);
+            if (p != pending.end())
+                by_seq.erase(p->second.rec.seq);
+
+            pending[key].rec = rec;
+            pending[key].attempts = 0;
+            by_seq[rec.seq] = key;
+        } // end for
+
+        if (n % sizeof(Outbox_Record))
+            break;      // short tail; torn append
+    } // end while
+
+    close(fd);
+    return n < 0 ? -1 : 0;
+} // end Replay
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Takes an applied (or given up on) operation out of pending, unless it's been superseded in the mean time,
+ *  and records the fact in the file. Caller must hold the lock.
+ */
+static void Retire(const Outbox_Key &key, const u64 seq)
+{
+    auto it = pending.find(key);
+    if (it != pending.end() && it->second.rec.seq == seq)
+        pending.erase(it);
+
+    Outbox_Record done;
+    memset(&done, 0, sizeof(done));
+    done.seq = next_seq++;
+    done.machine_num = key.first;
+    done.op = OUTBOX_DONE;
+    memcpy(done.data, &seq, sizeof(seq));
+
+    // a lost done record only means the operation is applied once more after a crash
+    Append(done, false);
+} // end Retire
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Applies a batch of operations to a single device; user writes and deletes go in a single maintenance
+ *  session with one refresh, enrolls are run one after the other afterwards as they need the device live.
+ *
+ * @param [machine_num] the machine identifier
+ * @param [ops] the operations to apply
+ * @param [status] gets per operation 0 when applied, -1 when the device could not be reached and -2 when the
+ *  device refused it
+ */
+static void Apply(const int machine_num, const std::vector<Outbox_Op> &ops, std::vector<int> &status)
+{
+    std::vector<User_Entry> users;
+    std::vector<u16> serials;
+    std::vector<size_t> user_idx, serial_idx;
+    std::vector<int> st;
+
+    status.assign(ops.size(), -1);
+    for (size_t i = 0; i < ops.size(); i++)
+    {
+        if (ops[i].rec.op == OUTBOX_SET_USER)
+        {
+            User_Entry user;
+            memcpy(&user, ops[i].rec.data, sizeof(user));
+            users.push_back(user);
+            user_idx.push_back(i);
+        } // end if
+        else if (ops[i].rec.op == OUTBOX_DELETE_USER)
+        {
+            u16 serial;
+            memcpy(&serial, ops[i].rec.data, sizeof(serial));
+            serials.push_back(serial);
+            serial_idx.push_back(i);
+        } // end else if
+    } // end for
+
+    if (!users.empty() || !serials.empty())
+    {
+        Maintenance_Session session(machine_num);
+        if (!session.Is_Held())
+            return;         // can't reach it; all stay at -1
+
+        if (Set_User_Info_Batch(machine_num, users, st, serials.empty()) >= 0)
+        {
+            for (size_t i = 0; i < user_idx.size(); i++)
+                status[user_idx[i]] = st[i] ? -2 : 0;
+        } // end if
+
+        if (!serials.empty() && Delete_User_Batch(machine_num, serials, st, true) >= 0)
+        {
+            for (size_t i = 0; i < serial_idx.size(); i++)
+                status[serial_idx[i]] = st[i] ? -2 : 0;
+        } // end if
+
+        session.Release();
+    } // end if
+
+    for (size_t i = 0; i < ops.size(); i++)
+    {
+        if (ops[i].rec.op != OUTBOX_ENROLL_USER)
+            continue;
+
+        Enroll_Data enroll;
+        memcpy(&enroll, ops[i].rec.data, sizeof(enroll));
+        status[i] = Enroll_User(machine_num, enroll);
+        if (status[i] == -1)
+            break;          // lost the device; leave the rest for later
+    } // end for
+} // end Apply
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Applies a batch to a device as a job on the shared pool and settles the outcome; the applied ones are
+ *  retired, the refused ones backed off or given up on and an unreachable device is backed off as a whole.
+ *
+ * @param [machine_num] the machine identifier
+ * @param [ops] the operations to apply
+ */
+static void Run_Batch(const int machine_num, const std::vector<Outbox_Op> &ops)
+{
+    std::vector<int> status;
+
+    Apply(machine_num, ops, status);
+    std::string err = Whats_Last_Error(machine_num);
+    std::lock_guard<std::mutex> guard(outbox_lock);
+
+    bool bunreachable{false};
+    for (size_t i = 0; i < ops.size(); i++)
+    {
+        const Outbox_Record &rec = ops[i].rec;
+        Outbox_Key key = Key_Of(rec);
+
+        if (status[i] == 0)
+            Retire(key, rec.seq);
+        else if (status[i] == -1)
+            bunreachable = true;
+        else
+        {
+            // the device said no; only so many times before we give up on it
+            auto it = pending.find(key);
+            if (it == pending.end() || it->second.rec.seq != rec.seq)
+                continue;
+
+            if (++it->second.attempts >= outbox_cfg.max_attempts)
+            {
+                if (outbox_cfg.failed)
+                    outbox_cfg.failed(rec.machine_num, rec.op, rec.data, err);
+                Retire(key, rec.seq);
+                continue;
+            } // end if
+
+            // asking again right away gets the same answer; back off on the operation alone
+            u32 shift = std::min(it->second.attempts - 1, 16u);
+            it->second.ready_at = Now_Ms() + std::min((u64)outbox_cfg.retry_base_ms << shift,
+                (u64)outbox_cfg.retry_max_ms);
+        } // end else
+    } // end for
+
+    Outbox_Device &dev = outbox_devs[machine_num];
+    if (bunreachable)
+    {
+        dev.backoff_ms = dev.backoff_ms ? std::min(dev.backoff_ms * 2, outbox_cfg.retry_max_ms) :
+            outbox_cfg.retry_base_ms;
+        dev.retry_at = Now_Ms() + dev.backoff_ms;
+    } // end if
+    else
+    {
+        dev.backoff_ms = 0;
+        dev.retry_at = 0;
+    } // end else
+
+    dev.bbusy = false;
+    --in_flight;
+    outbox_cv.notify_all();
+    idle_cv.notify_all();
+} // end Run_Batch
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Applier thread; takes up to a batch of the operations that are ready for each device that isn't backing off
+ *  or busy and hands it to the job pool, no more than max_running devices at once, then sleeps until the next
+ *  one is due or a batch is done.
+ */
+static void Run_Applier()
+{
+    std::unique_lock<std::mutex> lock(outbox_lock);
+
+    while (boutbox_running)
+    {
+        u64 now = Now_Ms();
+        std::map<int, std::vector<Outbox_Op>> work;
+        u64 wake = now + outbox_cfg.flush_interval_ms;
+
+        for (auto &p : pending)
+        {
+            Outbox_Device &dev = outbox_devs[p.first.first];
+            if (dev.bbusy)
+                continue;       // looked at again once its batch is done
+
+            if (dev.retry_at > now)
+            {
+                if (dev.retry_at < wake)
+                    wake = dev.retry_at;
+                continue;
+            } // end if
+
+            if (p.second.ready_at > now)
+            {
+                if (p.second.ready_at < wake)
+                    wake = p.second.ready_at;
+                continue;
+            } // end if
+
+            auto &ops = work[p.first.first];
+            if (ops.size() < outbox_cfg.batch_size)
+                ops.push_back(p.second);
+        } // end for
+
+        for (auto &w : work)
+        {
+            if (in_flight >= outbox_cfg.max_running)
+                break;          // the rest go once a batch on the go is done
+
+            int machine_num = w.first;
+            auto pops = std::make_shared<std::vector<Outbox_Op>>(std::move(w.second));
+            outbox_devs[machine_num].bbusy = true;
+            ++in_flight;
+            Default_Job_Pool().Submit([machine_num, pops]() { Run_Batch(machine_num, *pops); });
+        } // end for
+
+        if (file_records > pending.size() + OUTBOX_COMPACT_AT)
+            Compact();
+
+        if (!in_flight)
+            idle_cv.notify_all();
+        outbox_cv.wait_for(lock, std::chrono::milliseconds(wake - now));
+    } // end while
+} // end Run_Applier
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Appends a new operation and makes it pending, superseding any earlier one for the same key; it takes over
+ *  the ready time of the one it supersedes. The applier isn't woken, nothing new is due before it wakes anyway.
+ */
+static int Enqueue(const int machine_num, const u8 op, const void *pdata, const size_t len)
+{
+    std::lock_guard<std::mutex> guard(outbox_lock);
+    if (!boutbox_running)
+        return -1;
+
+    Outbox_Op entry;
+    memset(&entry.rec, 0, sizeof(entry.rec));
+    entry.rec.seq = next_seq++;
+    entry.rec.machine_num = machine_num;
+    entry.rec.op = op;
+    memcpy(entry.rec.data, pdata, len);
+
+    if (Append(entry.rec, outbox_cfg.bsync) < 0)
+        return -1;
+
+    Outbox_Key key = Key_Of(entry.rec);
+    auto it = pending.find(key);
+    entry.ready_at = it != pending.end() ? it->second.ready_at : Now_Ms() + outbox_cfg.flush_interval_ms;
+    pending[key] = entry;
+
+    return 0;
+} // end Enqueue
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Opens (or creates) the outbox file, picks up whatever was pending in it and starts the applier.
+ *
+ * @param [config] the outbox config
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+int Outbox_Open(const Outbox_Config &config)
+{
+    std::lock_guard<std::mutex> guard(outbox_lock);
+
+    if (boutbox_running || !config.batch_size || !config.max_running)
+        return -1;
+
+    outbox_cfg = config;
+    pending.clear();
+    outbox_devs.clear();
+    next_seq = 1;
+
+    if (Replay() < 0 || Compact() < 0)
+    {
+        Dump_Err("outbox: unable to open %s", outbox_cfg.path.c_str());
+        pending.clear();
+        return -1;
+    } // end if
+
+    boutbox_running = true;
+    papplier = new std::thread(Run_Applier);
+
+    return 0;
+} // end Outbox_Open
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Stops the applier and closes the outbox file; whatever is pending stays in the file for the next open.
+ *
+ * @return int
+ *  0 on success, -1 if not open
+ */
+int Outbox_Close()
+{
+    {
+        std::lock_guard<std::mutex> guard(outbox_lock);
+        if (!boutbox_running)
+            return -1;
+
+        boutbox_running = false;
+        outbox_cv.notify_all();
+    }
+
+    papplier->join();
+    delete papplier;
+    papplier = nullptr;
+
+    // batches already on the pool are let to finish, they still write their done records
+    std::unique_lock<std::mutex> lock(outbox_lock);
+    idle_cv.wait(lock, []() { return !in_flight; });
+    fdatasync(outbox_fd);
+    close(outbox_fd);
+    outbox_fd = -1;
+    pending.clear();
+    idle_cv.notify_all();
+
+    return 0;
+} // end Outbox_Close
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Queues a user write; returns once the request is in the outbox file.
+ *
+ * @param [machine_num] the machine identifier
+ * @param [user] the user info to write
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+int Outbox_Set_User(const int machine_num, const User_Entry &user)
+{
+    return Enqueue(machine_num, OUTBOX_SET_USER, &user, sizeof(user));
+} // end Outbox_Set_User
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Queues a user delete; returns once the request is in the outbox file.
+ *
+ * @param [machine_num] the machine identifier
+ * @param [serial] the serial of the user to delete
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+int Outbox_Delete_User(const int machine_num, const u16 serial)
+{
+    return Enqueue(machine_num, OUTBOX_DELETE_USER, &serial, sizeof(serial));
+} // end Outbox_Delete_User
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Queues a finger enrollment; returns once the request is in the outbox file.
+ *
+ * @param [machine_num] the machine identifier
+ * @param [enroll] the user id and finger to enroll
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+int Outbox_Enroll_User(const int machine_num, const Enroll_Data &enroll)
+{
+    return Enqueue(machine_num, OUTBOX_ENROLL_USER, &enroll, sizeof(enroll));
+} // end Outbox_Enroll_User
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the number of operations yet to be applied.
+ *
+ * @param [machine_num] the machine identifier or -1 for all
+ */
+u32 Outbox_Pending(const int machine_num)
+{
+    std::lock_guard<std::mutex> guard(outbox_lock);
+
+    if (machine_num < 0)
+        return (u32)pending.size();
+
+    auto first = pending.lower_bound(Outbox_Key(machine_num, 0));
+    auto last = pending.lower_bound(Outbox_Key(machine_num + 1, 0));
+    return (u32)std::distance(first, last);
+} // end Outbox_Pending
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Makes whatever is pending ready, wakes the applier and waits until nothing is left that can be applied
+ *  right now (devices backing off and operations queued meanwhile don't count) or the timeout expires.
+ *
+ * @param [timeout_ms] how long to wait at most
+ *
+ * @return int
+ *  0 when drained, 1 on timeout, -1 if not open
+ */
+int Outbox_Flush(const u32 timeout_ms)
+{
+    std::unique_lock<std::mutex> lock(outbox_lock);
+    if (!boutbox_running)
+        return -1;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    for (auto &d : outbox_devs)
+        d.second.retry_at = 0;      // a flush is a good reason to try again
+    for (auto &p : pending)
+        p.second.ready_at = 0;
+
+    outbox_cv.notify_one();
+    while (boutbox_running)
+    {
+        u64 now = Now_Ms();
+        bool bready{false};
+        for (auto &p : pending)
+        {
+            auto it = outbox_devs.find(p.first.first);
+            if (p.second.ready_at <= now && (it == outbox_devs.end() || it->second.retry_at <= now))
+            {
+                bready = true;
+                break;
+            } // end if
+        } // end for
+
+        if (!bready && !in_flight)
+            return 0;
+
+        if (idle_cv.wait_until(lock, deadline) == std::cv_status::timeout)
+            return 1;
+    } // end while
+
+    return -1;
+} // end Outbox_Flush
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
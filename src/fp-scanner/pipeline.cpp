@@ -0,0 +1,590 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for the bounded pipeline. A stage is in one of two modes: in memory, where pushes go
+//  on the queue, or spilling, where they go to the back of the spill. Its worker reads the spill back onto the
+//  queue whenever the queue is down to the low watermark, and once the spill is empty the stage is back in
+//  memory; since pushes only go to memory while nothing is on disk, the order is kept throughout. Spill
+//  segments are plain runs of Punch_Record; a torn record at the end of one (a crash mid write) is cut off.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "pipeline.h"
+#include "global-errors.h"
+
+#include <chrono>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define PIPE_RECORD             sizeof(Punch_Record)
+#define PIPE_RETRY_MS           100         // wait before a failed spill write goes again
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Path to a spill segment
+ */
+static std::string Segment_Path(const std::string &dir, const u64 id)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/%016" PRIx64 ".spl", id);
+    return dir + name;
+} // end Segment_Path
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief Construct a new Punch_Pipeline object; stopped and without stages.
+ */
+Punch_Pipeline::Punch_Pipeline()
+    : brunning{false}
+{
+} // end constructor
+
+
+//==============================================================================================================|
+/**
+ * @brief Destroy the Punch_Pipeline object; stops it first.
+ */
+Punch_Pipeline::~Punch_Pipeline()
+{
+    Stop();
+    for (auto &pstage : stages)
+        Close_Spill(*pstage);
+} // end destructor
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Adds a stage feeding a sink; before Start only.
+ *
+ * @param [name] names the stage in the stats and its spill directory
+ * @param [sink] the sink
+ * @param [arg] passed to sink
+ * @param [config] stage settings
+ *
+ * @return int
+ *  the stage index, -1 if running or the settings make no sense
+ */
+int Punch_Pipeline::Add_Stage(const std::string &name, pfn_Punch_Sink sink, void *arg,
+    const Pipe_Stage_Config &config)
+{
+    if (brunning || !sink || name.empty() || !config.high_water || config.low_water >= config.high_water ||
+        !config.batch_size || config.segment_size < PIPE_RECORD)
+        return -1;
+
+    std::unique_ptr<Stage> pstage(new Stage());
+    pstage->config = config;
+    pstage->sink = sink;
+    pstage->arg = arg;
+    pstage->stats.name = name;
+    if (!config.spill_dir.empty())
+        pstage->dir = config.spill_dir + "/" + name;
+
+    stages.push_back(std::move(pstage));
+    return (int)stages.size() - 1;
+} // end Add_Stage
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Starts the stage workers; spill left over from before is read back first.
+ *
+ * @return int
+ *  0 on success, -1 if running already or a spill directory can't be had
+ */
+int Punch_Pipeline::Start()
+{
+    if (brunning)
+        return -1;
+
+    for (auto &pstage : stages)
+    {
+        if (Recover(*pstage) < 0)
+        {
+            Dump_Err("pipeline: unable to set up the spill of %s", pstage->stats.name.c_str());
+            for (auto &p : stages)
+                Close_Spill(*p);
+            return -1;
+        } // end if
+    } // end for
+
+    for (auto &pstage : stages)
+    {
+        pstage->brunning = true;
+        pstage->worker = std::thread(Worker, pstage.get());
+    } // end for
+
+    brunning = true;
+    return 0;
+} // end Start
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Stops the pipeline; what's queued in memory goes to the sinks, what's spilled stays on disk for the next
+ *  Start.
+ *
+ * @return int
+ *  0 on success, -1 if not running
+ */
+int Punch_Pipeline::Stop()
+{
+    if (!brunning)
+        return -1;
+
+    brunning = false;
+    for (auto &pstage : stages)
+    {
+        {
+            std::lock_guard<std::mutex> guard(pstage->lock);
+            pstage->brunning = false;
+        }
+
+        pstage->cv.notify_all();
+        pstage->cv_space.notify_all();
+        pstage->worker.join();
+    } // end for
+
+    return 0;
+} // end Stop
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Hands punches to every stage. Doesn't wait on a stage that spills unless the disk fails it; waits on a
+ *  full stage without a spill.
+ *
+ * @param [ppunches] the punches
+ * @param [count] how many
+ *
+ * @return int
+ *  0 on success, -1 if not running
+ */
+int Punch_Pipeline::Push(const Punch_Record *ppunches, const size_t count)
+{
+    if (!brunning)
+        return -1;
+
+    for (auto &pstage : stages)
+        Put(*pstage, ppunches, count);
+
+    return 0;
+} // end Push
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  A pfn_Punch_Sink; arg is the Punch_Pipeline. Fits behind Punch_Dedup or Fleet_Merge_Attendance.
+ */
+void Punch_Pipeline::On_Punches(const Punch_Record *ppunches, const size_t count, void *arg)
+{
+    ((Punch_Pipeline*)arg)->Push(ppunches, count);
+} // end On_Punches
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Event bus handler; arg is the Punch_Pipeline. Subscribe with RT_ATTLOG.
+ */
+void Punch_Pipeline::On_Events(const Event_Record *precs, const size_t count, void *arg)
+{
+    std::vector<Punch_Record> punches;
+    Punch_Record punch;
+
+    punches.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (Punch_From_Event(precs[i], punch))
+            punches.push_back(punch);
+    } // end for
+
+    if (!punches.empty())
+        ((Punch_Pipeline*)arg)->Push(punches.data(), punches.size());
+} // end On_Events
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the counters of every stage, in the order added.
+ *
+ * @param [out] gets the counters
+ */
+void Punch_Pipeline::Get_Stats(std::vector<Pipe_Stage_Stats> &out)
+{
+    out.clear();
+    for (auto &pstage : stages)
+    {
+        std::lock_guard<std::mutex> guard(pstage->lock);
+        out.push_back(pstage->stats);
+        out.back().depth = pstage->queue.size();
+        out.back().spill_segments = pstage->segments.size();
+        out.back().bspilling = pstage->bspilling;
+    } // end for
+} // end Get_Stats
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Makes the stage's spill directory and takes stock of the segments left in it; a torn record at the end
+ *  of a segment is cut off.
+ *
+ * @return int
+ *  0 on success, -1 on fail
+ */
+int Punch_Pipeline::Recover(Stage &stage)
+{
+    if (stage.dir.empty())
+        return 0;
+
+    Close_Spill(stage);
+    if ((mkdir(stage.config.spill_dir.c_str(), 0755) < 0 && errno != EEXIST) ||
+        (mkdir(stage.dir.c_str(), 0755) < 0 && errno != EEXIST))
+        return -1;
+
+    DIR *pdir = opendir(stage.dir.c_str());
+    if (!pdir)
+        return -1;
+
+    struct dirent *pent;
+    std::vector<u64> ids;
+    while ((pent = readdir(pdir)) != nullptr)
+    {
+        u64 id;
+        char tail[8];
+
+        if (strlen(pent->d_name) == 20 && sscanf(pent->d_name, "%16" SCNx64 "%4s", &id, tail) == 2 &&
+            !strcmp(tail, ".spl"))
+            ids.push_back(id);
+    } // end while
+
+    closedir(pdir);
+    std::sort(ids.begin(), ids.end());
+
+    stage.segments.clear();
+    stage.stats.spilled = 0;
+    stage.next_segment = ids.empty() ? 1 : ids.back() + 1;
+
+    for (u64 id : ids)
+    {
+        std::string path = Segment_Path(stage.dir, id);
+        struct stat st;
+
+        if (stat(path.c_str(), &st) < 0)
+            continue;
+
+        u64 whole = (u64)st.st_size / PIPE_RECORD * PIPE_RECORD;
+        if (whole != (u64)st.st_size && truncate(path.c_str(), (off_t)whole) < 0)
+            return -1;
+
+        stage.segments.push_back(id);
+        stage.stats.spilled += whole / PIPE_RECORD;
+    } // end for
+
+    stage.bspilling = !stage.segments.empty();
+    return 0;
+} // end Recover
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes punches to the back of the spill, starting a segment whenever one is full; caller holds the lock.
+ *
+ * @return size_t
+ *  the number written; fewer than count when the disk fails
+ */
+size_t Punch_Pipeline::Spill(Stage &stage, const Punch_Record *ppunches, const size_t count)
+{
+    size_t done{0};
+
+    while (done < count)
+    {
+        if (stage.write_fd < 0 || stage.write_size + PIPE_RECORD > stage.config.segment_size)
+        {
+            if (stage.write_fd >= 0)
+                close(stage.write_fd);
+
+            u64 id = stage.next_segment++;
+            stage.write_fd = open(Segment_Path(stage.dir, id).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND,
+                0644);
+            stage.write_size = 0;
+            if (stage.write_fd < 0)
+            {
+                Dump_Err("pipeline: unable to start a spill segment for %s", stage.stats.name.c_str());
+                break;
+            } // end if
+
+            stage.segments.push_back(id);
+        } // end if
+
+        size_t n = std::min((size_t)((stage.config.segment_size - stage.write_size) / PIPE_RECORD), count - done);
+        const u8 *p = (const u8*)(ppunches + done);
+        size_t bytes = n * PIPE_RECORD, written{0};
+
+        while (written < bytes)
+        {
+            ssize_t r = write(stage.write_fd, p + written, bytes - written);
+            if (r < 0 && errno == EINTR)
+                continue;
+            if (r <= 0)
+                break;
+            written += (size_t)r;
+        } // end while
+
+        if (written < bytes)
+        {
+            // a torn record would throw the rest of the segment off; cut back to the last whole one
+            Dump_Err("pipeline: unable to spill %s", stage.stats.name.c_str());
+            written = written / PIPE_RECORD * PIPE_RECORD;
+            if (ftruncate(stage.write_fd, (off_t)(stage.write_size + written)) < 0)
+            {
+                close(stage.write_fd);
+                stage.write_fd = -1;
+            } // end if
+        } // end if
+
+        n = written / PIPE_RECORD;
+        stage.write_size += written;
+        stage.stats.spilled += n;
+        stage.stats.spill_writes += n;
+        done += n;
+
+        if (written < bytes)
+            break;
+    } // end while
+
+    return done;
+} // end Spill
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Reads up to max punches from the front of the spill onto the queue, letting go of the segments read
+ *  through; the stage is back in memory once the spill is empty. Caller holds the lock.
+ *
+ * @return size_t
+ *  the number read back
+ */
+size_t Punch_Pipeline::Unspill(Stage &stage, const size_t max)
+{
+    std::vector<Punch_Record> buf;
+    size_t total{0};
+
+    while (total < max && !stage.segments.empty())
+    {
+        u64 id = stage.segments.front();
+        bool bwriting = stage.segments.size() == 1 && stage.write_fd >= 0;
+
+        if (stage.read_fd < 0)
+        {
+            stage.read_fd = open(Segment_Path(stage.dir, id).c_str(), O_RDONLY);
+            stage.read_offset = 0;
+            if (stage.read_fd < 0)
+            {
+                Dump_Err("pipeline: unable to read back the spill of %s", stage.stats.name.c_str());
+                break;
+            } // end if
+        } // end if
+
+        buf.resize(std::min(max - total, (size_t)stage.config.batch_size));
+        ssize_t r = pread(stage.read_fd, buf.data(), buf.size() * PIPE_RECORD, (off_t)stage.read_offset);
+        if (r < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            Dump_Err("pipeline: unable to read back the spill of %s", stage.stats.name.c_str());
+            break;
+        } // end if
+
+        size_t n = (size_t)r / PIPE_RECORD;
+        if (n)
+        {
+            stage.queue.insert(stage.queue.end(), buf.begin(), buf.begin() + n);
+            stage.read_offset += n * PIPE_RECORD;
+            total += n;
+            continue;
+        } // end if
+
+        // read through; the segment goes
+        close(stage.read_fd);
+        stage.read_fd = -1;
+        if (bwriting)
+        {
+            close(stage.write_fd);
+            stage.write_fd = -1;
+        } // end if
+
+        unlink(Segment_Path(stage.dir, id).c_str());
+        stage.segments.pop_front();
+    } // end while
+
+    stage.stats.spilled -= std::min((u64)total, stage.stats.spilled);
+    stage.stats.spill_reads += total;
+    if (stage.queue.size() > stage.stats.peak_depth)
+        stage.stats.peak_depth = stage.queue.size();
+
+    if (stage.segments.empty())
+        stage.bspilling = false;
+
+    return total;
+} // end Unspill
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Closes the spill files; they stay on disk.
+ */
+void Punch_Pipeline::Close_Spill(Stage &stage)
+{
+    if (stage.read_fd >= 0)
+        close(stage.read_fd);
+    if (stage.write_fd >= 0)
+        close(stage.write_fd);
+
+    stage.read_fd = stage.write_fd = -1;
+} // end Close_Spill
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Queues punches on a stage, spilling what's over the high watermark.
+ */
+void Punch_Pipeline::Put(Stage &stage, const Punch_Record *ppunches, size_t count)
+{
+    std::unique_lock<std::mutex> guard(stage.lock);
+    u64 high = stage.config.high_water;
+
+    stage.stats.pushed += count;
+    while (count)
+    {
+        if (!stage.brunning)
+        {
+            // stopped under us; the worker is gone, thus only the spill keeps them
+            if (stage.dir.empty())
+                break;
+            stage.bspilling = true;
+        } // end if
+
+        if (!stage.bspilling)
+        {
+            size_t n = stage.queue.size() < high ? std::min((size_t)(high - stage.queue.size()), count) : 0;
+            if (n)
+            {
+                stage.queue.insert(stage.queue.end(), ppunches, ppunches + n);
+                ppunches += n;
+                count -= n;
+                if (stage.queue.size() > stage.stats.peak_depth)
+                    stage.stats.peak_depth = stage.queue.size();
+                stage.cv.notify_one();
+                continue;
+            } // end if
+
+            if (stage.dir.empty())
+            {
+                ++stage.stats.waits;
+                stage.cv_space.wait(guard);
+                continue;
+            } // end if
+
+            stage.bspilling = true;
+        } // end if
+
+        size_t n = Spill(stage, ppunches, count);
+        ppunches += n;
+        count -= n;
+        if (n)
+            stage.cv.notify_one();
+
+        if (count)
+        {
+            // the disk is failing us; hold the caller rather than let memory go
+            ++stage.stats.waits;
+            stage.cv_space.wait_for(guard, std::chrono::milliseconds(PIPE_RETRY_MS));
+        } // end if
+    } // end while
+} // end Put
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  A stage's thread; feeds the sink from the queue and the queue from the spill. Once stopped it finishes
+ *  the queue but leaves the spill.
+ */
+void Punch_Pipeline::Worker(Stage *pstage)
+{
+    Stage &stage = *pstage;
+    std::vector<Punch_Record> batch;
+    std::unique_lock<std::mutex> guard(stage.lock);
+
+    for (;;)
+    {
+        if (stage.brunning && stage.bspilling && stage.queue.size() <= stage.config.low_water)
+            Unspill(stage, stage.config.high_water - stage.queue.size());
+
+        if (stage.queue.empty())
+        {
+            if (!stage.brunning)
+                break;
+
+            stage.cv.wait(guard);
+            continue;
+        } // end if
+
+        size_t n = std::min(stage.queue.size(), (size_t)stage.config.batch_size);
+        batch.assign(stage.queue.begin(), stage.queue.begin() + n);
+        stage.queue.erase(stage.queue.begin(), stage.queue.begin() + n);
+        stage.cv_space.notify_all();
+
+        guard.unlock();
+        stage.sink(batch.data(), n, stage.arg);
+        guard.lock();
+
+        stage.stats.delivered += n;
+    } // end for
+
+    Close_Spill(stage);
+} // end Worker
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,417 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for the dedup stage. A key is the 64 bit hash of the punch's device, user id, time
+//  and verify state; the window holds a table of those per day, and the Bloom filter sets all of a key's bits
+//  in one 512 bit block, thus a lookup there costs a single cache line.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "punch-dedup.h"
+#include "global-errors.h"
+#include "utils.h"
+
+#include <cmath>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define DEDUP_DAY_SLOTS         1024        // first size of a day's table
+#define BLOOM_BLOCK_WORDS       8           // u64s in a 512 bit block
+#define BLOOM_MAX_PROBES        16
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  The key of a punch; never 0, which marks an empty slot.
+ */
+static u64 Punch_Key(const Punch_Record &punch)
+{
+    u8 buf[9 + PUNCH_USER_ID_SIZE];
+    size_t len = strnlen(punch.user_id, sizeof(punch.user_id));
+
+    iCpy(buf, &punch.machine_num, 4);
+    iCpy(buf + 4, &punch.att_time, 4);
+    buf[8] = punch.verify_state;
+    iCpy(buf + 9, punch.user_id, len);
+
+    u64 key = Hash_Block(buf, 9 + len);
+    return key ? key : 1;
+} // end Punch_Key
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief Construct a new Punch_Dedup object; the filter is sized up front.
+ *
+ * @param [config] settings
+ */
+Punch_Dedup::Punch_Dedup(const Dedup_Config &config)
+    : config(config)
+{
+    if (!this->config.window_days)
+        this->config.window_days = 1;
+
+    double n = (double)(this->config.bloom_items ? this->config.bloom_items : DEDUP_BLOOM_ITEMS);
+    double p = this->config.bloom_fp > 0 && this->config.bloom_fp < 1 ? this->config.bloom_fp : DEDUP_BLOOM_FP;
+
+    // the textbook size, a fifth more for blocking, which crowds some blocks more than others
+    double bits = -n * std::log(p) / (M_LN2 * M_LN2) * 1.2;
+    bloom_blocks = (u64)(bits / 512) + 1;
+    bloom_probes = (u32)std::ceil(-std::log2(p));
+    if (bloom_probes < 1)
+        bloom_probes = 1;
+    else if (bloom_probes > BLOOM_MAX_PROBES)
+        bloom_probes = BLOOM_MAX_PROBES;
+
+    bloom.assign(bloom_blocks * BLOOM_BLOCK_WORDS, 0);
+    stats.bloom_bytes = bloom.size() * sizeof(u64);
+} // end constructor
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Checks a punch and remembers it.
+ *
+ * @param [punch] the punch
+ *
+ * @return bool
+ *  true if it's new, false if it's been seen before
+ */
+bool Punch_Dedup::Insert(const Punch_Record &punch)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return Check(punch);
+} // end Insert
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Drops the punches seen before from a batch, duplicates within the batch included; the rest keep their
+ *  order.
+ *
+ * @param [punches] the batch
+ *
+ * @return size_t
+ *  the number of punches left
+ */
+size_t Punch_Dedup::Filter(std::vector<Punch_Record> &punches)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    size_t n{0};
+
+    for (size_t i = 0; i < punches.size(); i++)
+    {
+        if (Check(punches[i]))
+        {
+            if (n != i)
+                punches[n] = punches[i];
+            ++n;
+        } // end if
+    } // end for
+
+    punches.resize(n);
+    return n;
+} // end Filter
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Sets where On_Punches and On_Events pass the new punches on to; called with the lock held, thus the sink
+ *  sees them one batch at a time in the order checked.
+ *
+ * @param [sink] the next stage; nullptr for none
+ * @param [arg] passed to sink
+ */
+void Punch_Dedup::Set_Sink(pfn_Punch_Sink sink, void *arg)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    this->sink = sink;
+    sink_arg = arg;
+} // end Set_Sink
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  A pfn_Punch_Sink; arg is the Punch_Dedup. Fits as the sink of Fleet_Merge_Attendance.
+ */
+void Punch_Dedup::On_Punches(const Punch_Record *ppunches, const size_t count, void *arg)
+{
+    Punch_Dedup *pdedup = (Punch_Dedup*)arg;
+    std::lock_guard<std::mutex> guard(pdedup->lock);
+
+    pdedup->batch.clear();
+    for (size_t i = 0; i < count; i++)
+    {
+        if (pdedup->Check(ppunches[i]))
+            pdedup->batch.push_back(ppunches[i]);
+    } // end for
+
+    pdedup->Pass_On();
+} // end On_Punches
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Event bus handler; arg is the Punch_Dedup. Subscribe with RT_ATTLOG.
+ */
+void Punch_Dedup::On_Events(const Event_Record *precs, const size_t count, void *arg)
+{
+    Punch_Dedup *pdedup = (Punch_Dedup*)arg;
+    std::lock_guard<std::mutex> guard(pdedup->lock);
+    Punch_Record punch;
+
+    pdedup->batch.clear();
+    for (size_t i = 0; i < count; i++)
+    {
+        if (Punch_From_Event(precs[i], punch) && pdedup->Check(punch))
+            pdedup->batch.push_back(punch);
+    } // end for
+
+    pdedup->Pass_On();
+} // end On_Events
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the counters.
+ */
+Dedup_Stats Punch_Dedup::Get_Stats()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return stats;
+} // end Get_Stats
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The check itself; caller holds the lock. The confirm callback, if any, is called with it held too.
+ */
+bool Punch_Dedup::Check(const Punch_Record &punch)
+{
+    u32 day = PUNCH_DAY(punch.att_time);
+    u64 key = Punch_Key(punch);
+
+    ++stats.seen;
+    if (day > last_day || days.empty())
+        Advance(day);
+
+    if (last_day - day < config.window_days)
+    {
+        if (hint >= days.size() || days[hint].day != day)
+        {
+            for (hint = 0; hint < days.size() && days[hint].day != day; hint++) ;
+
+            if (hint == days.size())
+            {
+                days.emplace_back();
+                days.back().day = day;
+            } // end if
+        } // end if
+
+        if (!Day_Insert(days[hint], key))
+        {
+            ++stats.dropped;
+            return false;
+        } // end if
+
+        ++stats.window_keys;
+        ++stats.passed;
+        return true;
+    } // end if
+
+    // older than the window
+    if (Bloom_Test(key))
+    {
+        if (!config.confirm)
+        {
+            // a duplicate most likely, yet no one can tell; logged at the 1st, 2nd, 4th, ... lest it floods
+            u64 n = ++stats.unconfirmed;
+            if (!(n & (n - 1)))
+                Dump_Err("dedup: %llu punches older than the window dropped unconfirmed, last user %.*s at %u "
+                    "on %d; set a confirm callback to check them", (unsigned long long)n,
+                    (int)sizeof(punch.user_id), punch.user_id, punch.att_time, punch.machine_num);
+            return false;
+        } // end if
+
+        ++stats.confirms;
+        if (config.confirm(punch, config.confirm_arg))
+        {
+            ++stats.dropped_old;
+            return false;
+        } // end if
+    } // end if
+    else
+    {
+        Bloom_Add(key);
+        ++stats.bloom_keys;
+    } // end else
+
+    ++stats.passed;
+    return true;
+} // end Check
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Moves the end of the window up to day; the days that fall out go into the filter. Caller holds the lock.
+ */
+void Punch_Dedup::Advance(const u32 day)
+{
+    if (day > last_day)
+        last_day = day;
+
+    for (size_t i = 0; i < days.size(); )
+    {
+        if (last_day - days[i].day < config.window_days)
+        {
+            ++i;
+            continue;
+        } // end if
+
+        for (u64 key : days[i].slots)
+        {
+            if (key)
+                Bloom_Add(key);
+        } // end for
+
+        stats.bloom_keys += days[i].count;
+        stats.window_keys -= days[i].count;
+
+        if (i != days.size() - 1)
+            days[i] = std::move(days.back());
+        days.pop_back();
+    } // end for
+
+    hint = days.size();
+} // end Advance
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Adds a key to a day's table, growing it at half full.
+ *
+ * @return bool
+ *  true if it wasn't there
+ */
+bool Punch_Dedup::Day_Insert(Day &d, const u64 key)
+{
+    if ((d.count + 1) * 2 > d.slots.size())
+    {
+        std::vector<u64> old;
+        old.swap(d.slots);
+        d.slots.assign(old.empty() ? DEDUP_DAY_SLOTS : old.size() * 2, 0);
+
+        size_t mask = d.slots.size() - 1;
+        for (u64 k : old)
+        {
+            if (!k)
+                continue;
+
+            size_t i = k & mask;
+            while (d.slots[i])
+                i = (i + 1) & mask;
+            d.slots[i] = k;
+        } // end for
+    } // end if
+
+    size_t mask = d.slots.size() - 1;
+    size_t i = key & mask;
+    while (d.slots[i])
+    {
+        if (d.slots[i] == key)
+            return false;
+        i = (i + 1) & mask;
+    } // end while
+
+    d.slots[i] = key;
+    ++d.count;
+    return true;
+} // end Day_Insert
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  True if the filter may have the key; the block comes from the key's high half, the bits within it from
+ *  the low half by double hashing.
+ */
+bool Punch_Dedup::Bloom_Test(const u64 key) const
+{
+    const u64 *pblock = &bloom[(((key >> 32) * bloom_blocks) >> 32) * BLOOM_BLOCK_WORDS];
+    u32 a = (u32)key & 0xffff, b = ((u32)key >> 16) | 1;
+
+    for (u32 i = 0; i < bloom_probes; i++, a += b)
+    {
+        u32 bit = a & 511;
+        if (!(pblock[bit >> 6] & (1ULL << (bit & 63))))
+            return false;
+    } // end for
+
+    return true;
+} // end Bloom_Test
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Adds a key to the filter.
+ */
+void Punch_Dedup::Bloom_Add(const u64 key)
+{
+    u64 *pblock = &bloom[(((key >> 32) * bloom_blocks) >> 32) * BLOOM_BLOCK_WORDS];
+    u32 a = (u32)key & 0xffff, b = ((u32)key >> 16) | 1;
+
+    for (u32 i = 0; i < bloom_probes; i++, a += b)
+    {
+        u32 bit = a & 511;
+        pblock[bit >> 6] |= 1ULL << (bit & 63);
+    } // end for
+} // end Bloom_Add
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Hands the batch to the sink; caller holds the lock.
+ */
+void Punch_Dedup::Pass_On()
+{
+    if (sink && !batch.empty())
+        sink(batch.data(), batch.size(), sink_arg);
+} // end Pass_On
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
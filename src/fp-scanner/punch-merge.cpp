@@ -0,0 +1,559 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for the cross device merge. The heap only comes into play when the lead changes
+//  hands; a source keeps being drained as long as its next punch is no later than the best of the others,
+//  which for devices that punch in turns is most of the time. A source that spills keeps a single piece in
+//  memory and reads the next one back only once the merge is through with it.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "punch-merge.h"
+#include "global-errors.h"
+
+#include <fcntl.h>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define RADIX_BITS          11
+#define RADIX_BUCKETS       (1 << RADIX_BITS)
+#define RADIX_PASSES        3       // 33 bits worth; covers the 32 bit att_time
+#define MERGE_RECORD        sizeof(Punch_Record)
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  Fleet_Merge_Attendance glue
+ */
+typedef struct Merge_Download_Info
+{
+    Punch_Merge *pmerge;
+} Merge_Download;
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Sorts punches on att_time with an LSD radix sort; stable, thus punches with the same time keep their order.
+ *  The (time, index) pairs are sorted rather than the punches, which are moved only once at the end, and a
+ *  pass whose digit is the same for all is skipped. A log already in order (the usual case) costs one pass.
+ *
+ * @param [punches] the punches to sort
+ */
+void Punch_Radix_Sort(std::vector<Punch_Record> &punches)
+{
+    size_t n = punches.size();
+    bool bsorted{true};
+
+    for (size_t i = 1; i < n && bsorted; i++)
+        bsorted = punches[i - 1].att_time <= punches[i].att_time;
+
+    if (bsorted)
+        return;
+
+    std::vector<u64> a(n), b(n);
+    std::vector<u32> counts(RADIX_PASSES * RADIX_BUCKETS, 0);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        u64 t = punches[i].att_time;
+        a[i] = (t << 32) | i;
+        for (int p = 0; p < RADIX_PASSES; p++)
+            ++counts[p * RADIX_BUCKETS + ((t >> (p * RADIX_BITS)) & (RADIX_BUCKETS - 1))];
+    } // end for
+
+    for (int p = 0; p < RADIX_PASSES; p++)
+    {
+        u32 *pcount = &counts[p * RADIX_BUCKETS];
+        u32 shift = 32 + p * RADIX_BITS;
+
+        if (pcount[(a[0] >> shift) & (RADIX_BUCKETS - 1)] == n)
+            continue;       // nothing to tell apart on this digit
+
+        u32 sum{0};
+        for (u32 d = 0; d < RADIX_BUCKETS; d++)
+        {
+            u32 c = pcount[d];
+            pcount[d] = sum;
+            sum += c;
+        } // end for
+
+        for (size_t i = 0; i < n; i++)
+            b[pcount[(a[i] >> shift) & (RADIX_BUCKETS - 1)]++] = a[i];
+
+        a.swap(b);
+    } // end for
+
+    std::vector<Punch_Record> sorted(n);
+    for (size_t i = 0; i < n; i++)
+        sorted[i] = punches[(u32)a[i]];
+
+    punches.swap(sorted);
+} // end Punch_Radix_Sort
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Heap order; true when a comes out after b.
+ */
+static inline bool After(const u32 a_time, const u32 a_source, const u32 b_time, const u32 b_source)
+{
+    return a_time > b_time || (a_time == b_time && a_source > b_source);
+} // end After
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief Construct a new Punch_Merge object
+ *
+ * @param [nsources] the number of sources; numbered from 0
+ * @param [config] merge settings
+ */
+Punch_Merge::Punch_Merge(const u32 nsources, const Punch_Merge_Config &config)
+    : config(config), sources(nsources), nwaiting{nsources}, bspill_failed{false}
+{
+    heap.reserve(nsources);
+} // end constructor
+
+
+//==============================================================================================================|
+/**
+ * @brief Destroy the Punch_Merge object; whatever is still spilled goes with it.
+ */
+Punch_Merge::~Punch_Merge()
+{
+    for (auto &src : sources)
+    {
+        if (src.spill_fd >= 0)
+            close(src.spill_fd);
+    } // end for
+} // end destructor
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Puts a source on the heap if it has something to offer, otherwise counts it as waited on unless it's
+ *  finished; caller holds the lock and the source is off the heap.
+ */
+void Punch_Merge::Queue(const u32 source)
+{
+    Source &src = sources[source];
+
+    Refill(src);
+    if (!src.runs.empty())
+    {
+        Head head;
+        head.att_time = src.runs.front()[src.pos].att_time;
+        head.source = source;
+        heap.push_back(head);
+        std::push_heap(heap.begin(), heap.end(), [](const Head &a, const Head &b) {
+            return After(a.att_time, a.source, b.att_time, b.source); });
+
+        src.bqueued = true;
+    } // end if
+    else if (!src.bfinished)
+        ++nwaiting;
+} // end Queue
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Hands over a run of punches of a source; the run must be in time order and follow on from the runs before
+ *  it. A run of up to MERGE_RUN_SIZE punches that fits is moved in as is; a longer one is taken in pieces, and
+ *  the pieces over max_queued, or after one that was, go to the source's spill.
+ *
+ * @param [source] the source
+ * @param [run] the punches
+ *
+ * @return int
+ *  0 on success, -1 on a bad or finished source
+ */
+int Punch_Merge::Push(const u32 source, std::vector<Punch_Record> &&run)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (source >= sources.size() || sources[source].bfinished)
+        return -1;
+
+    if (run.empty())
+        return 0;
+
+    Source &src = sources[source];
+    bool bwaited = !src.bqueued && src.runs.empty();
+
+    for (size_t first = 0; first < run.size(); )
+    {
+        size_t n = std::min((size_t)MERGE_RUN_SIZE, run.size() - first);
+        bool bspill = !bspill_failed && !config.spill_dir.empty() && (src.spill_head < src.spill_tail ||
+            (config.max_queued && stats.queued + n > config.max_queued));
+
+        if (bspill && Spill(src, &run[first], n) == 0)
+        {
+            first += n;
+            continue;
+        } // end if
+
+        if (bspill)
+        {
+            // the disk let us down; what's spilled comes back so the order holds
+            bspill_failed = true;
+            Refill(src, true);
+        } // end if
+
+        if (!first && n == run.size())
+            src.runs.push_back(std::move(run));
+        else
+            src.runs.emplace_back(run.begin() + first, run.begin() + first + n);
+
+        stats.queued += n;
+        stats.peak_queued = std::max(stats.peak_queued, stats.queued);
+        first += n;
+    } // end for
+
+    if (bwaited)
+    {
+        --nwaiting;
+        Queue(source);
+        cv.notify_one();
+    } // end if
+
+    return 0;
+} // end Push
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Tells that a source has no more to hand over; the merge stops waiting on it.
+ *
+ * @param [source] the source
+ *
+ * @return int
+ *  0 on success, -1 on a bad or already finished source
+ */
+int Punch_Merge::Finish(const u32 source)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (source >= sources.size() || sources[source].bfinished)
+        return -1;
+
+    Source &src = sources[source];
+    src.bfinished = true;
+    if (!src.bqueued && src.runs.empty())
+    {
+        --nwaiting;
+        cv.notify_one();
+    } // end if
+
+    return 0;
+} // end Finish
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Takes the next punches in time order; waits while an open source has nothing to offer, since its next
+ *  punch could be the earliest.
+ *
+ * @param [pout] gets the punches
+ * @param [max] room in pout
+ *
+ * @return size_t
+ *  the number of punches taken; 0 once every source is finished and drained
+ */
+size_t Punch_Merge::Pop(Punch_Record *pout, const size_t max)
+{
+    std::unique_lock<std::mutex> guard(lock);
+    size_t n{0};
+
+    // restores the heap after the top changed; a single pass down rather than a pop and a push
+    auto sift_down = [this]() {
+        size_t size = heap.size(), i{0};
+        Head h = heap[0];
+        for (;;)
+        {
+            size_t c = 2 * i + 1;
+            if (c >= size)
+                break;
+            if (c + 1 < size && After(heap[c].att_time, heap[c].source, heap[c + 1].att_time, heap[c + 1].source))
+                ++c;
+            if (!After(h.att_time, h.source, heap[c].att_time, heap[c].source))
+                break;
+            heap[i] = heap[c];
+            i = c;
+        } // end for
+        heap[i] = h;
+    };
+
+    while (n < max)
+    {
+        if (nwaiting)
+        {
+            if (n)
+                break;      // hand over what we have rather than sit on it
+
+            cv.wait(guard);
+            continue;
+        } // end if
+
+        if (heap.empty())
+            break;
+
+        u32 s = heap[0].source;
+        Source &src = sources[s];
+
+        // the runner up; the top source is drained for as long as it stays ahead of it
+        bool bsole = heap.size() == 1;
+        size_t r = heap.size() > 2 && After(heap[1].att_time, heap[1].source, heap[2].att_time, heap[2].source) ?
+            2 : 1;
+        u32 next_time = bsole ? 0 : heap[r].att_time;
+        u32 next_source = bsole ? 0 : heap[r].source;
+
+        while (n < max && !src.runs.empty())
+        {
+            const std::vector<Punch_Record> &run = src.runs.front();
+            const Punch_Record &p = run[src.pos];
+            if (!bsole && After(p.att_time, s, next_time, next_source))
+                break;
+
+            pout[n++] = p;
+            if (++src.pos == run.size())
+            {
+                stats.queued -= run.size();
+                src.runs.pop_front();       // done with it; the memory goes back right away
+                src.pos = 0;
+                Refill(src);
+            } // end if
+        } // end while
+
+        if (!src.runs.empty())
+            heap[0].att_time = src.runs.front()[src.pos].att_time;
+        else
+        {
+            // out it goes; it's waited on if it's still open
+            src.bqueued = false;
+            heap[0] = heap.back();
+            heap.pop_back();
+            if (!src.bfinished)
+                ++nwaiting;
+        } // end else
+
+        if (!heap.empty())
+            sift_down();
+    } // end while
+
+    return n;
+} // end Pop
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the merge counters.
+ */
+Punch_Merge_Stats Punch_Merge::Get_Stats()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return stats;
+} // end Get_Stats
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Writes punches to the back of a source's spill, making the file the first time; caller holds the lock.
+ *
+ * @return int
+ *  0 on success, -1 when the disk fails (nothing is taken)
+ */
+int Punch_Merge::Spill(Source &src, const Punch_Record *ppunches, const size_t count)
+{
+    if (src.spill_fd < 0)
+    {
+        std::string path = config.spill_dir + "/merge-XXXXXX";
+        src.spill_fd = mkstemp(&path[0]);
+        if (src.spill_fd < 0)
+        {
+            Dump_Err("merge: unable to make a spill file in %s", config.spill_dir.c_str());
+            return -1;
+        } // end if
+
+        unlink(path.c_str());       // no one else needs to see it
+    } // end if
+
+    const u8 *p = (const u8*)ppunches;
+    size_t bytes = count * MERGE_RECORD, written{0};
+    off_t off = (off_t)(src.spill_tail * MERGE_RECORD);
+
+    while (written < bytes)
+    {
+        ssize_t r = pwrite(src.spill_fd, p + written, bytes - written, off + (off_t)written);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r <= 0)
+        {
+            Dump_Err("merge: unable to spill");
+            return -1;
+        } // end if
+
+        written += (size_t)r;
+    } // end while
+
+    src.spill_tail += count;
+    stats.spilled += count;
+    stats.spill_writes += count;
+    return 0;
+} // end Spill
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Reads the next piece of a source's spill back once it has nothing left in memory, or the whole spill when
+ *  ball is set; caller holds the lock. A spill read through is cut back to nothing.
+ */
+void Punch_Merge::Refill(Source &src, const bool ball)
+{
+    while (src.spill_head < src.spill_tail && (ball || src.runs.empty()))
+    {
+        size_t n = (size_t)std::min((u64)MERGE_RUN_SIZE, src.spill_tail - src.spill_head);
+        std::vector<Punch_Record> run(n);
+        u8 *p = (u8*)run.data();
+        size_t bytes = n * MERGE_RECORD, got{0};
+        off_t off = (off_t)(src.spill_head * MERGE_RECORD);
+
+        while (got < bytes)
+        {
+            ssize_t r = pread(src.spill_fd, p + got, bytes - got, off + (off_t)got);
+            if (r < 0 && errno == EINTR)
+                continue;
+            if (r <= 0)
+                break;
+            got += (size_t)r;
+        } // end while
+
+        if (got < bytes)
+        {
+            // nothing to be done about it; the rest of the source is lost
+            Dump_Err("merge: unable to read back the spill");
+            stats.spilled -= src.spill_tail - src.spill_head;
+            src.spill_head = src.spill_tail;
+            break;
+        } // end if
+
+        src.spill_head += n;
+        stats.spilled -= n;
+        stats.spill_reads += n;
+        stats.queued += n;
+        stats.peak_queued = std::max(stats.peak_queued, stats.queued);
+        src.runs.push_back(std::move(run));
+    } // end while
+
+    if (src.spill_fd >= 0 && src.spill_head == src.spill_tail && src.spill_tail)
+    {
+        src.spill_head = src.spill_tail = 0;
+        if (ftruncate(src.spill_fd, 0) < 0)
+            Dump_Err("merge: unable to cut back the spill");
+    } // end if
+} // end Refill
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Fan out glue; downloads a device's log, sorts it and hands it to the merge, which keeps or spills it a piece
+ *  at a time; the log is let go once it's handed over.
+ */
+static int Op_Download_Sorted(const int machine_num, const size_t index, void *arg)
+{
+    Punch_Merge *pmerge = ((Merge_Download*)arg)->pmerge;
+    std::vector<Attendance_Entry> entries;
+    std::vector<Punch_Record> run;
+
+    int r = Read_Attendance_Record(machine_num, entries);
+    if (r >= 0)
+    {
+        Punch_From_Entries(machine_num, entries, run);
+        std::vector<Attendance_Entry>().swap(entries);
+        Punch_Radix_Sort(run);
+        pmerge->Push((u32)index, std::move(run));
+    } // end if
+
+    pmerge->Finish((u32)index);
+    return r;
+} // end Op_Download_Sorted
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Downloads the attendance of a set of devices in parallel and hands it to sink as one stream in time order,
+ *  a batch at a time on the caller's thread. The merge gets going as soon as every device has been downloaded
+ *  or given up on; until then what's over config.max_queued waits in the spill, and the device logs are let go
+ *  as they are merged.
+ *
+ * @param [machines] the devices to download
+ * @param [sink] takes the merged stream
+ * @param [arg] passed to sink
+ * @param [results] gets one result per device
+ * @param [opt] fan out options
+ * @param [config] merge settings
+ *
+ * @return int
+ *  the number of devices that failed; their punches are left out
+ */
+int Fleet_Merge_Attendance(const std::vector<int> &machines, pfn_Punch_Sink sink, void *arg,
+    std::vector<Fan_Out_Result> &results, const Fan_Out_Options &opt, const Punch_Merge_Config &config)
+{
+    Punch_Merge merge((u32)machines.size(), config);
+    Merge_Download dl;
+    int failed{0};
+
+    dl.pmerge = &merge;
+    std::thread downloads([&]() { failed = Fan_Out(machines, Op_Download_Sorted, &dl, results, opt); });
+
+    std::vector<Punch_Record> batch(MERGE_BATCH_SIZE);
+    size_t n;
+    while ((n = merge.Pop(batch.data(), batch.size())) > 0)
+    {
+        if (sink)
+            sink(batch.data(), n, arg);
+    } // end while
+
+    downloads.join();
+    return failed;
+} // end Fleet_Merge_Attendance
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
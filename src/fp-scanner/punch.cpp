@@ -0,0 +1,108 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for making punches out of downloaded log entries and realtime events.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "punch.h"
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Makes a punch out of a downloaded log entry.
+ *
+ * @param [machine_num] the device the entry came from
+ * @param [entry] the log entry
+ * @param [punch] gets the punch
+ */
+void Punch_From_Entry(const int machine_num, const Attendance_Entry &entry, Punch_Record &punch)
+{
+    // the user id runs into the pad on devices with wider pins; the two sit back to back
+    const char *pid = (const char*)entry.user_id;
+    size_t len = strnlen(pid, sizeof(entry.user_id) + sizeof(entry.pad));
+    if (len > PUNCH_USER_ID_SIZE - 1)
+        len = PUNCH_USER_ID_SIZE - 1;
+
+    memset(punch.user_id, 0, sizeof(punch.user_id));
+    iCpy(punch.user_id, pid, len);
+
+    punch.att_time = RNTOHL(entry.att_time);
+    punch.machine_num = machine_num;
+    punch.serial = RNTOHS(entry.serial_number);
+    punch.verify_type = entry.verify_type;
+    punch.verify_state = entry.verify_state;
+} // end Punch_From_Entry
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Makes a punch out of a realtime event.
+ *
+ * @param [rec] the event off the bus
+ * @param [punch] gets the punch
+ *
+ * @return bool
+ *  false when the event is not a decoded attendance transaction
+ */
+bool Punch_From_Event(const Event_Record &rec, Punch_Record &punch)
+{
+    if (rec.event != EF_ATTLOG || !rec.bdecoded)
+        return false;
+
+    const Event_Att *patt = (const Event_Att*)rec.data;
+    size_t len = strnlen(patt->user_id, PUNCH_USER_ID_SIZE - 1);
+
+    memset(punch.user_id, 0, sizeof(punch.user_id));
+    iCpy(punch.user_id, patt->user_id, len);
+
+    punch.att_time = patt->att_time;
+    punch.machine_num = rec.machine_num;
+    punch.serial = 0;
+    punch.verify_type = patt->verify_type;
+    punch.verify_state = patt->status;
+
+    return true;
+} // end Punch_From_Event
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Makes punches out of a device's downloaded log; appended to punches.
+ *
+ * @param [machine_num] the device the log came from
+ * @param [entries] what Read_Attendance_Record returned
+ * @param [punches] gets the punches
+ */
+void Punch_From_Entries(const int machine_num, const std::vector<Attendance_Entry> &entries,
+    std::vector<Punch_Record> &punches)
+{
+    size_t base = punches.size();
+    punches.resize(base + entries.size());
+
+    for (size_t i = 0; i < entries.size(); i++)
+        Punch_From_Entry(machine_num, entries[i], punches[base + i]);
+} // end Punch_From_Entries
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
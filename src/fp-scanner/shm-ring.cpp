@@ -0,0 +1,597 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for the shared memory event ring. The receive path has a Run_Select thread per
+//  device, so positions are claimed with a fetch and add on a counter private to the driver; the ring head
+//  is only moved forward after the slot is written, and only ever forward. Readers go by the slot sequence
+//  and look at the head just to move up after an overrun, thus two events finishing out of order hold nobody
+//  up but the reader of the slower one.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "shm-ring.h"
+#include "global-errors.h"
+
+#include <chrono>
+#include <climits>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#if defined(__x86_64__) || defined(__i386__)
+#define CPU_RELAX()     __builtin_ia32_pause()
+#else
+#define CPU_RELAX()     std::atomic_signal_fence(std::memory_order_seq_cst)
+#endif
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+static_assert(sizeof(Shm_Ring_Header) == 192 && sizeof(Shm_Slot) == 128, "the shared layout has moved");
+static_assert(sizeof(std::atomic<u64>) == 8 && sizeof(std::atomic<u32>) == 4,
+    "atomics in shared memory must be plain words");
+
+static std::atomic<Shm_Ring_Header*> ring{nullptr};     // the ring while open
+static std::atomic<u32> publishing{0};      // publishers holding ring right now
+static std::atomic<u64> claim{0};           // the next position handed to a publisher
+static Shm_Slot *slots{nullptr};
+static u64 ring_mask{0};                    // capacity - 1
+static size_t ring_size{0};                 // bytes mapped
+static std::string ring_name;
+static Realtime_Mask ring_filter{RT_NONE};
+static std::atomic<u64> published{0};
+static std::atomic<u64> wakes{0};
+static std::mutex ring_lock;                // guards opening and closing only
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  The futex calls; the ring is shared between processes, thus not the private kind.
+ */
+static inline void Futex_Wake(std::atomic<u32> *paddr)
+{
+    syscall(SYS_futex, (u32*)paddr, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+} // end Futex_Wake
+
+
+static inline void Futex_Wait(std::atomic<u32> *paddr, const u32 val, const u32 timeout_ms)
+{
+    struct timespec ts;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (long)(timeout_ms % 1000) * 1000000;
+    syscall(SYS_futex, (u32*)paddr, FUTEX_WAIT, val, &ts, nullptr, 0);
+} // end Futex_Wait
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Bytes the ring takes for capacity slots.
+ */
+static inline size_t Ring_Bytes(const u64 capacity)
+{
+    return sizeof(Shm_Ring_Header) + capacity * sizeof(Shm_Slot);
+} // end Ring_Bytes
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Tells the readers of a ring left under the name (by an earlier run, say) to go, and takes the name off it.
+ *  They keep their mapping until they detach, thus it's never cut from under them.
+ */
+static void Retire(const std::string &name)
+{
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+        return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(Shm_Ring_Header))
+    {
+        void *p = mmap(nullptr, sizeof(Shm_Ring_Header), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED)
+        {
+            Shm_Ring_Header *pold = (Shm_Ring_Header*)p;
+            __atomic_store_n(&pold->bclosed, 1, __ATOMIC_RELEASE);
+            pold->futex.fetch_add(1);
+            Futex_Wake(&pold->futex);
+            munmap(p, sizeof(Shm_Ring_Header));
+        } // end if
+    } // end if
+
+    close(fd);
+    shm_unlink(name.c_str());
+} // end Retire
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Makes the ring and starts putting events on it; a ring left under the same name is retired first.
+ *
+ * @param [config] settings
+ *
+ * @return int
+ *  0 on success, -1 on fail or if open already
+ */
+int Shm_Ring_Open(const Shm_Ring_Config &config)
+{
+    std::lock_guard<std::mutex> guard(ring_lock);
+
+    if (ring.load())
+        return -1;
+
+    u64 cap{2};
+    while (cap < config.capacity)
+        cap <<= 1;
+
+    Retire(config.name);
+
+    int fd = shm_open(config.name.c_str(), O_CREAT | O_EXCL | O_RDWR, config.mode);
+    if (fd < 0)
+    {
+        Dump_Err("shm ring: unable to create %s", config.name.c_str());
+        return -1;
+    } // end if
+
+    fchmod(fd, config.mode);        // past the umask
+
+    size_t size = Ring_Bytes(cap);
+    void *p = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0)
+        p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (p == MAP_FAILED)
+    {
+        Dump_Err("shm ring: unable to map %s", config.name.c_str());
+        shm_unlink(config.name.c_str());
+        return -1;
+    } // end if
+
+    // fresh from ftruncate it's all zeros; slot seq 0 is never a written one
+    Shm_Ring_Header *phdr = (Shm_Ring_Header*)p;
+    phdr->version = SHM_RING_VERSION;
+    phdr->capacity = (u32)cap;
+    phdr->slot_size = sizeof(Shm_Slot);
+    phdr->producer_pid = (u32)getpid();
+    __atomic_store_n(&phdr->magic, SHM_RING_MAGIC, __ATOMIC_RELEASE);
+
+    slots = (Shm_Slot*)(phdr + 1);
+    ring_mask = cap - 1;
+    ring_size = size;
+    ring_name = config.name;
+    ring_filter = config.mask;
+    claim = 0;
+    published = 0;
+    wakes = 0;
+    ring.store(phdr);
+
+    return 0;
+} // end Shm_Ring_Open
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Stops putting events on the ring and takes it down; readers are told to go.
+ *
+ * @return int
+ *  0 on success, -1 if not open
+ */
+int Shm_Ring_Close()
+{
+    std::lock_guard<std::mutex> guard(ring_lock);
+
+    Shm_Ring_Header *phdr = ring.exchange(nullptr);
+    if (!phdr)
+        return -1;
+
+    // publishers that picked up the pointer before it went are done with it once they are all out
+    while (publishing.load())
+        std::this_thread::yield();
+
+    __atomic_store_n(&phdr->bclosed, 1, __ATOMIC_RELEASE);
+    phdr->futex.fetch_add(1);
+    Futex_Wake(&phdr->futex);
+
+    munmap(phdr, ring_size);
+    shm_unlink(ring_name.c_str());
+    slots = nullptr;
+
+    return 0;
+} // end Shm_Ring_Close
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Tells if the ring is open.
+ */
+bool Shm_Ring_Is_Open()
+{
+    return ring.load(std::memory_order_relaxed) != nullptr;
+} // end Shm_Ring_Is_Open
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  The events the ring takes; RT_NONE while closed. Event_Wanted_Mask counts it in.
+ */
+Realtime_Mask Shm_Ring_Mask()
+{
+    std::lock_guard<std::mutex> guard(ring_lock);
+    return ring.load() ? ring_filter : RT_NONE;
+} // end Shm_Ring_Mask
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Puts an event on the ring if it's open and wants it; never blocks. Called by Event_Publish.
+ */
+void Shm_Ring_Publish(const Event_Record &rec)
+{
+    if (!ring.load(std::memory_order_relaxed))
+        return;
+
+    ++publishing;
+    Shm_Ring_Header *phdr = ring.load();
+    if (!phdr || !(ring_filter & rec.event))
+    {
+        --publishing;
+        return;
+    } // end if
+
+    u64 pos = claim.fetch_add(1, std::memory_order_relaxed);
+    Shm_Slot &slot = slots[pos & ring_mask];
+
+    // odd first and the record after; a reader that sees the same even seq either side of its read had it whole
+    slot.seq.store(2 * pos + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.rec = rec;
+    slot.seq.store(2 * pos + 2, std::memory_order_release);
+
+    u64 head = phdr->head.load(std::memory_order_relaxed);
+    while (head < pos + 1 && !phdr->head.compare_exchange_weak(head, pos + 1, std::memory_order_release))
+        ;
+
+    // pairs up with the waiters bump in Shm_Reader::Wait; one of us sees the other
+    phdr->futex.fetch_add(1);
+    if (phdr->waiters.load())
+    {
+        Futex_Wake(&phdr->futex);
+        ++wakes;
+    } // end if
+
+    ++published;
+    --publishing;
+} // end Shm_Ring_Publish
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the driver side counters.
+ */
+void Shm_Ring_Get_Stats(Shm_Ring_Stats *pstats)
+{
+    if (!pstats)
+        return;
+
+    pstats->published = published;
+    pstats->wakes = wakes;
+} // end Shm_Ring_Get_Stats
+
+
+
+//==============================================================================================================|
+// CLASS
+//==============================================================================================================|
+/**
+ * @brief Construct a new Shm_Reader object; detached.
+ */
+Shm_Reader::Shm_Reader()
+    : pring{nullptr}, pslots{nullptr}, size{0}, mask{0}, next{0}, polled{0}
+{
+} // end constructor
+
+
+//==============================================================================================================|
+/**
+ * @brief Destroy the Shm_Reader object; detaches it first.
+ */
+Shm_Reader::~Shm_Reader()
+{
+    Detach();
+} // end destructor
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Maps the ring; writable, though only the futex words are ever written.
+ *
+ * @param [name] the ring's name
+ * @param [boldest] start from the oldest event still on the ring rather than the next one published
+ *
+ * @return int
+ *  0 on success, -1 if there's no such ring (or not yet a ready one), -2 if it's not a ring this reader knows
+ */
+int Shm_Reader::Attach(const std::string &name, const bool boldest)
+{
+    Detach();
+
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+        return -1;
+
+    struct stat st;
+    void *p = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(Shm_Ring_Header))
+        p = mmap(nullptr, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (p == MAP_FAILED)
+        return -1;
+
+    Shm_Ring_Header *phdr = (Shm_Ring_Header*)p;
+    if (__atomic_load_n(&phdr->magic, __ATOMIC_ACQUIRE) != SHM_RING_MAGIC)
+    {
+        munmap(p, (size_t)st.st_size);
+        return -1;
+    } // end if
+
+    if (phdr->version != SHM_RING_VERSION || phdr->slot_size != sizeof(Shm_Slot) ||
+        (size_t)st.st_size < Ring_Bytes(phdr->capacity))
+    {
+        munmap(p, (size_t)st.st_size);
+        return -2;
+    } // end if
+
+    pring = phdr;
+    pslots = (Shm_Slot*)(phdr + 1);
+    size = (size_t)st.st_size;
+    mask = phdr->capacity - 1;
+
+    u64 head = phdr->head.load(std::memory_order_acquire);
+    next = boldest && head > mask ? head - mask : boldest ? 0 : head;
+    stats = Shm_Reader_Stats();
+
+    return 0;
+} // end Attach
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Unmaps the ring.
+ */
+void Shm_Reader::Detach()
+{
+    if (!pring)
+        return;
+
+    munmap(pring, size);
+    pring = nullptr;
+    pslots = nullptr;
+} // end Detach
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Hands out the next event where it lies in the ring; it's only good once Confirm says so.
+ *
+ * @param [prec] gets the event
+ *
+ * @return int
+ *  1 with an event, 0 if there's none yet, -1 if the reader was lapped (it has moved up; poll again), -2 if the
+ *  ring is gone or was never attached
+ */
+int Shm_Reader::Poll(const Event_Record *&prec)
+{
+    if (!pring || __atomic_load_n(&pring->bclosed, __ATOMIC_ACQUIRE))
+        return -2;
+
+    const Shm_Slot &slot = pslots[next & mask];
+    u64 seq = slot.seq.load(std::memory_order_acquire);
+    u64 want = 2 * next + 2;
+
+    if (seq == want)
+    {
+        polled = seq;
+        prec = &slot.rec;
+        return 1;
+    } // end if
+
+    if (seq > want)
+    {
+        Skip();
+        return -1;
+    } // end if
+
+    return 0;
+} // end Poll
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Tells if the event Poll handed out is still the one that was there, and moves on to the next. When it
+ *  isn't the reader was lapped while looking at it; it moves up, and what it read is to be thrown away.
+ */
+bool Shm_Reader::Confirm()
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (pslots[next & mask].seq.load(std::memory_order_relaxed) != polled)
+    {
+        Skip();
+        return false;
+    } // end if
+
+    ++next;
+    ++stats.read;
+    return true;
+} // end Confirm
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Waits for the next event; spins for a while first, as a futex wake costs microseconds.
+ *
+ * @param [timeout_ms] the longest wait
+ * @param [spin_us] how long to spin before sleeping
+ *
+ * @return int
+ *  1 when there's something to poll, 0 on timeout, -2 if the ring is gone
+ */
+int Shm_Reader::Wait(const u32 timeout_ms, const u32 spin_us)
+{
+    if (!pring)
+        return -2;
+
+    auto start = std::chrono::steady_clock::now();
+    auto spin_end = start + std::chrono::microseconds(spin_us);
+    auto end = start + std::chrono::milliseconds(timeout_ms);
+
+    for (;;)
+    {
+        if (Ready())
+            return 1;
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= end)
+            return 0;
+
+        if (now < spin_end)
+        {
+            CPU_RELAX();
+            continue;
+        } // end if
+
+        // bumping waiters first and looking again after; the driver bumps futex then looks at waiters
+        pring->waiters.fetch_add(1);
+        u32 val = pring->futex.load();
+        if (!Ready())
+        {
+            u32 left = (u32)std::chrono::duration_cast<std::chrono::milliseconds>(end - now).count();
+            Futex_Wait(&pring->futex, val, left ? left : 1);
+            ++stats.sleeps;
+        } // end if
+        pring->waiters.fetch_sub(1);
+    } // end for
+} // end Wait
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Copies the next event out, waiting for it as long as timeout_ms.
+ *
+ * @param [rec] gets the event
+ * @param [timeout_ms] the longest wait
+ *
+ * @return int
+ *  1 with an event, 0 on timeout, -2 if the ring is gone
+ */
+int Shm_Reader::Read(Event_Record &rec, const u32 timeout_ms)
+{
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    for (;;)
+    {
+        const Event_Record *prec;
+        int r = Poll(prec);
+
+        if (r == 1)
+        {
+            rec = *prec;
+            if (Confirm())
+                return 1;
+            continue;
+        } // end if
+
+        if (r == -1)
+            continue;
+        if (r == -2)
+            return -2;
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= end)
+            return 0;
+
+        r = Wait((u32)std::chrono::duration_cast<std::chrono::milliseconds>(end - now).count());
+        if (r == -2)
+            return -2;
+    } // end for
+} // end Read
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Tells if the next slot is written, or written over; either way Poll has something to say. A ring that's
+ *  gone counts too.
+ */
+bool Shm_Reader::Ready() const
+{
+    return pslots[next & mask].seq.load(std::memory_order_acquire) >= 2 * next + 2 ||
+        __atomic_load_n(&pring->bclosed, __ATOMIC_ACQUIRE);
+} // end Ready
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Moves a lapped reader up to a quarter of a lap behind the head, giving it some room before it's caught
+ *  again, and counts what it lost.
+ */
+void Shm_Reader::Skip()
+{
+    u64 head = pring->head.load(std::memory_order_acquire);
+    u64 room = (mask + 1) - ((mask + 1) >> 2);
+    u64 to = head > room ? head - room : 0;
+
+    if (to <= next)
+        to = next + 1;
+
+    stats.lost += to - next;
+    ++stats.overruns;
+    next = to;
+} // end Skip
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
@@ -0,0 +1,489 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for the status driven sync scheduler. Two threads do the work; the poller hands the
+//  devices that are due to the shared job pool (see job-pool.h) as status polls, max_polling at a time, and the
+//  dispatcher does the same with whatever syncs those polls queued. Thus a dead terminal sitting out its receive
+//  timeout holds up only its own poll. A device is never polled while it has a poll or sync on the go, so the
+//  driver only ever sees one request at a time per device from here.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "sync-scheduler.h"
+#include "job-pool.h"
+
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <random>
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+// where a device is in its poll/sync cycle
+enum Sched_State {DEV_IDLE, DEV_POLLING, DEV_QUEUED, DEV_RUNNING};
+
+
+
+/**
+ * @brief
+ *  Book keeping for a single device
+ */
+typedef struct Sched_Device_Info
+{
+    Sched_State state{DEV_IDLE};
+    u64 next_due{0};            // when to poll next (ms, steady clock)
+    u64 queued_at{0};           // when the pending jobs were queued
+    u8 pending{0};              // SYNC_USERS | SYNC_ATTENDANCE
+    bool bbaseline{false};      // have we seen the counters at least once
+    bool bremoved{false};       // removed while busy; drop it when done
+    Sched_Stats stats;
+} Sched_Device;
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+static Sched_Config sched_cfg;                  // the running config
+static std::map<int, Sched_Device> devices;     // machine_num : state
+static std::deque<int> jobs;                    // devices with pending syncs in order of arrival
+static std::mutex sched_lock;                   // guards all of the above
+static std::condition_variable poll_cv;         // wakes the poller (new device or stop)
+static std::condition_variable job_cv;          // wakes the dispatcher (new job, sync done or stop)
+static std::thread *ppoller{nullptr};
+static std::thread *pdispatcher{nullptr};
+static bool bsched_running{false};
+static u32 sched_running{0};                    // syncs handed to the job pool and not yet done
+static u32 sched_polling{0};                    // polls likewise
+static std::mt19937 jitter_rng{std::random_device{}()};
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Milliseconds on the monotonic clock
+ */
+static u64 Now_Ms()
+{
+    return (u64)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+} // end Now_Ms
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns a random wait in the range [0, upto]; caller must hold the lock.
+ */
+static u64 Jitter(const u32 upto)
+{
+    if (!upto)
+        return 0;
+
+    std::uniform_int_distribution<u32> dist(0, upto);
+    return dist(jitter_rng);
+} // end Jitter
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Compares the fresh counters with the last ones and returns the syncs that are called for. On the very
+ *  first poll there is nothing to compare against, thus both are called for.
+ */
+static u8 Changed(const Sched_Device &dev, const Machine_Status &stat)
+{
+    u8 what{0};
+
+    if (!dev.bbaseline)
+        return SYNC_USERS | SYNC_ATTENDANCE;
+
+    if (stat.user_count != dev.stats.last.user_count || stat.fp_template != dev.stats.last.fp_template ||
+        stat.pwd_count != dev.stats.last.pwd_count)
+        what |= SYNC_USERS;
+
+    if (stat.att_count != dev.stats.last.att_count)
+        what |= SYNC_ATTENDANCE;
+
+    return what;
+} // end Changed
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Polls the status of a single device as a job on the shared pool and queues syncs if its counters moved.
+ */
+static void Run_Poll(const int machine_num)
+{
+    Machine_Status stat;
+    int ret = Get_Device_Status(machine_num, &stat);
+    std::lock_guard<std::mutex> guard(sched_lock);
+
+    --sched_polling;
+    poll_cv.notify_all();
+
+    auto it = devices.find(machine_num);
+    if (it == devices.end())
+        return;
+
+    if (it->second.bremoved)
+    {
+        devices.erase(it);
+        return;
+    } // end if
+
+    Sched_Device &dev = it->second;
+    u64 now = Now_Ms();
+    ++dev.stats.polls;
+    dev.next_due = now + sched_cfg.poll_interval_ms + Jitter(sched_cfg.jitter_ms);
+
+    u8 what = (ret < 0 ? 0 : Changed(dev, stat));
+    if (ret < 0)
+        ++dev.stats.errors;
+
+    if (what)
+    {
+        dev.pending = what;
+        dev.queued_at = now;
+        dev.state = DEV_QUEUED;
+        dev.stats.queue_depth = (what & SYNC_USERS ? 1 : 0) + (what & SYNC_ATTENDANCE ? 1 : 0);
+        dev.stats.last = stat;
+        dev.bbaseline = true;
+        jobs.push_back(machine_num);
+        job_cv.notify_one();
+    } // end if
+    else
+    {
+        if (ret == 0)
+            dev.stats.last = stat;
+        dev.state = DEV_IDLE;
+    } // end else
+} // end Run_Poll
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Poller thread; hands every idle device that is due to the job pool as a poll, keeping no more than
+ *  max_polling of them going at once. Those left over are taken up as the polls on the go complete.
+ */
+static void Run_Poller()
+{
+    std::unique_lock<std::mutex> lock(sched_lock);
+
+    while (bsched_running)
+    {
+        u64 now = Now_Ms();
+        u64 wake = now + sched_cfg.poll_interval_ms;
+
+        for (auto &d : devices)
+        {
+            if (d.second.state != DEV_IDLE || d.second.bremoved)
+                continue;
+
+            if (d.second.next_due <= now)
+            {
+                if (sched_polling >= sched_cfg.max_polling)
+                    continue;
+
+                int machine_num = d.first;
+                d.second.state = DEV_POLLING;
+                ++sched_polling;
+                Default_Job_Pool().Submit([machine_num]() { Run_Poll(machine_num); });
+            } // end if
+            else if (d.second.next_due < wake)
+                wake = d.second.next_due;
+        } // end for
+
+        // a poll coming back wakes us too, so that its next due time and the leftovers get looked at
+        poll_cv.wait_for(lock, std::chrono::milliseconds(wake - now));
+    } // end while
+} // end Run_Poller
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Runs the syncs queued for a single device as a job on the shared pool, then re-reads the counters so that
+ *  whatever the sync itself did (clearing the log for example) does not count as a change.
+ */
+static void Run_Sync(const int machine_num, const u8 what, Machine_Status stat)
+{
+    int uret{0}, aret{0};
+
+    if ((what & SYNC_USERS) && sched_cfg.user_sync)
+        uret = sched_cfg.user_sync(machine_num, stat, sched_cfg.arg);
+    if ((what & SYNC_ATTENDANCE) && sched_cfg.att_sync)
+        aret = sched_cfg.att_sync(machine_num, stat, sched_cfg.arg);
+
+    int sret = Get_Device_Status(machine_num, &stat);
+    std::lock_guard<std::mutex> guard(sched_lock);
+
+    --sched_running;
+    job_cv.notify_all();
+
+    auto it = devices.find(machine_num);
+    if (it == devices.end())
+        return;
+
+    Sched_Device &dev = it->second;
+    if (what & SYNC_USERS)
+        ++dev.stats.user_syncs;
+    if (what & SYNC_ATTENDANCE)
+        ++dev.stats.att_syncs;
+
+    if (uret < 0 || aret < 0)
+    {
+        // forget the baseline so that the next poll tries the lot again
+        ++dev.stats.errors;
+        dev.bbaseline = false;
+    } // end if
+    else if (sret == 0)
+        dev.stats.last = stat;
+
+    dev.pending = 0;
+    dev.queued_at = 0;
+    dev.stats.queue_depth = 0;
+    dev.state = DEV_IDLE;
+
+    if (dev.bremoved)
+        devices.erase(it);
+} // end Run_Sync
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Dispatcher thread; hands the queued devices to the job pool in order of arrival, keeping no more than
+ *  max_running syncs going at once. A long log download on one device no longer holds up the rest.
+ */
+static void Run_Dispatcher()
+{
+    std::unique_lock<std::mutex> lock(sched_lock);
+
+    while (bsched_running)
+    {
+        if (jobs.empty() || sched_running >= sched_cfg.max_running)
+        {
+            job_cv.wait(lock);
+            continue;
+        } // end if
+
+        int machine_num = jobs.front();
+        jobs.pop_front();
+
+        auto it = devices.find(machine_num);
+        if (it == devices.end())
+            continue;
+
+        it->second.state = DEV_RUNNING;
+        u8 what = it->second.pending;
+        Machine_Status stat = it->second.stats.last;
+
+        ++sched_running;
+        Default_Job_Pool().Submit([machine_num, what, stat]() { Run_Sync(machine_num, what, stat); });
+    } // end while
+} // end Run_Dispatcher
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Starts the scheduler threads with the given config; devices added before or after are picked up.
+ *
+ * @param [config] the scheduler config
+ *
+ * @return int
+ *  0 on success, -1 if already running or config is not sane
+ */
+int Sched_Start(const Sched_Config &config)
+{
+    std::lock_guard<std::mutex> guard(sched_lock);
+
+    if (bsched_running || !config.poll_interval_ms || !config.max_running || !config.max_polling)
+        return -1;
+
+    sched_cfg = config;
+    bsched_running = true;
+
+    // spread the first round of polls over one interval so the fleet doesn't get hit at once
+    u64 now = Now_Ms();
+    for (auto &d : devices)
+        d.second.next_due = now + Jitter(sched_cfg.poll_interval_ms);
+
+    ppoller = new std::thread(Run_Poller);
+    pdispatcher = new std::thread(Run_Dispatcher);
+
+    return 0;
+} // end Sched_Start
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Stops the scheduler; waits for any running sync to finish.
+ *
+ * @return int
+ *  0 on success, -1 if not running
+ */
+int Sched_Stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(sched_lock);
+        if (!bsched_running)
+            return -1;
+
+        bsched_running = false;
+        poll_cv.notify_all();
+        job_cv.notify_all();
+    }
+
+    ppoller->join();
+    pdispatcher->join();
+    delete ppoller;
+    delete pdispatcher;
+    ppoller = pdispatcher = nullptr;
+
+    // polls and syncs already on the pool are let to finish; whatever was queued is dropped and the next start
+    //  begins from a clean baseline
+    std::unique_lock<std::mutex> lock(sched_lock);
+    poll_cv.wait(lock, []() { return sched_polling == 0; });
+    job_cv.wait(lock, []() { return sched_running == 0; });
+    jobs.clear();
+    for (auto &d : devices)
+    {
+        d.second.state = DEV_IDLE;
+        d.second.pending = 0;
+        d.second.bbaseline = false;
+        d.second.stats.queue_depth = 0;
+    } // end for
+
+    return 0;
+} // end Sched_Stop
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Adds a connected device to the schedule; its first poll is at a random point within the poll interval.
+ *
+ * @param [machine_num] the machine identifier
+ *
+ * @return int
+ *  0 on success, -1 if device is already scheduled
+ */
+int Sched_Add_Device(const int machine_num)
+{
+    std::lock_guard<std::mutex> guard(sched_lock);
+
+    auto it = devices.find(machine_num);
+    if (it != devices.end())
+    {
+        if (!it->second.bremoved)
+            return -1;
+
+        it->second.bremoved = false;
+        return 0;
+    } // end if
+
+    Sched_Device dev;
+    dev.next_due = Now_Ms() + Jitter(sched_cfg.poll_interval_ms);
+    devices[machine_num] = dev;
+    poll_cv.notify_one();
+
+    return 0;
+} // end Sched_Add_Device
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Removes the device from the schedule; if busy it's dropped once its current poll or sync is done.
+ *
+ * @param [machine_num] the machine identifier
+ *
+ * @return int
+ *  0 on success, -1 if not scheduled
+ */
+int Sched_Remove_Device(const int machine_num)
+{
+    std::lock_guard<std::mutex> guard(sched_lock);
+
+    auto it = devices.find(machine_num);
+    if (it == devices.end())
+        return -1;
+
+    if (it->second.state == DEV_IDLE)
+        devices.erase(it);
+    else if (it->second.state == DEV_QUEUED)
+    {
+        jobs.erase(std::remove(jobs.begin(), jobs.end(), machine_num), jobs.end());
+        devices.erase(it);
+    } // end else if
+    else
+        it->second.bremoved = true;
+
+    return 0;
+} // end Sched_Remove_Device
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the numbers for a device.
+ *
+ * @param [machine_num] the machine identifier
+ * @param [pstats] gets the stats
+ *
+ * @return int
+ *  0 on success, -1 if not scheduled
+ */
+int Sched_Get_Stats(const int machine_num, Sched_Stats *pstats)
+{
+    std::lock_guard<std::mutex> guard(sched_lock);
+
+    auto it = devices.find(machine_num);
+    if (it == devices.end() || !pstats)
+        return -1;
+
+    *pstats = it->second.stats;
+    pstats->lag_ms = (it->second.queued_at ? Now_Ms() - it->second.queued_at : 0);
+
+    return 0;
+} // end Sched_Get_Stats
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Returns the number of devices waiting on the dispatcher across the fleet.
+ */
+u32 Sched_Queue_Depth()
+{
+    std::lock_guard<std::mutex> guard(sched_lock);
+    return (u32)jobs.size();
+} // end Sched_Queue_Depth
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
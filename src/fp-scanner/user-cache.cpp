@@ -0,0 +1,447 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for the per device user cache. The indexes are plain arrays of slots holding the
+//  row number plus one (0 marks an empty slot) and are probed linearly; they are kept at most half full, thus
+//  a lookup rarely goes past the second slot.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "user-cache.h"
+#include "fleet-index.h"
+
+#include <mutex>
+
+
+
+//==============================================================================================================|
+// MACROS
+//==============================================================================================================|
+#define MIN_SLOTS       16          // smallest index we bother with
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  The cached user table of a single device
+ */
+typedef struct User_Cache_Struct
+{
+    std::vector<User_Entry> users;      // the flat array of users
+    std::vector<u32> sn_index;          // serial_number -> row + 1
+    std::vector<u32> id_index;          // user_id -> row + 1
+    u32 mask{0};                        // index size - 1
+    u32 generation{0};                  // bumped on every invalidation
+    u64 hash{0};                        // fingerprint of the table as last downloaded
+    bool bvalid{false};                 // false until loaded or after invalidation
+} User_Cache;
+
+
+
+//==============================================================================================================|
+// GLOBALS
+//==============================================================================================================|
+static std::unordered_map<int, User_Cache> caches;     // machine_num : cache
+static std::mutex cache_lock;                           // guards the lot
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  Hashes the 16-bit serial; a multiplicative hash spreads consecutive serials over the slots.
+ */
+static inline u32 Hash_Serial(const u16 serial)
+{
+    return (u32)serial * 0x9E3779B1;
+} // end Hash_Serial
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  FNV-1a hash over the user id; the id is at most 9 chars and may not be null terminated.
+ */
+static inline u32 Hash_UserID(const char *user_id)
+{
+    u32 hash = 0x811C9DC5;
+    for (size_t i = 0; i < sizeof(User_Entry::user_id) && user_id[i]; i++)
+    {
+        hash ^= (u8)user_id[i];
+        hash *= 0x01000193;
+    } // end for
+
+    return hash;
+} // end Hash_UserID
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Rebuilds both indexes from the flat array; called after loads and deletes.
+ */
+static void Build_Index(User_Cache &cache)
+{
+    u32 slots = MIN_SLOTS;
+    while (slots < cache.users.size() * 2)
+        slots <<= 1;
+
+    cache.mask = slots - 1;
+    cache.sn_index.assign(slots, 0);
+    cache.id_index.assign(slots, 0);
+
+    for (u32 row = 0; row < cache.users.size(); row++)
+    {
+        u32 i = Hash_Serial(cache.users[row].serial_number) & cache.mask;
+        while (cache.sn_index[i])
+            i = (i + 1) & cache.mask;
+        cache.sn_index[i] = row + 1;
+
+        i = Hash_UserID(cache.users[row].user_id) & cache.mask;
+        while (cache.id_index[i])
+            i = (i + 1) & cache.mask;
+        cache.id_index[i] = row + 1;
+    } // end for
+} // end Build_Index
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Probes the serial index; returns the row or -1
+ */
+static int Probe_Serial(const User_Cache &cache, const u16 serial)
+{
+    if (cache.sn_index.empty())
+        return -1;
+
+    u32 i = Hash_Serial(serial) & cache.mask;
+    while (cache.sn_index[i])
+    {
+        u32 row = cache.sn_index[i] - 1;
+        if (cache.users[row].serial_number == serial)
+            return (int)row;
+
+        i = (i + 1) & cache.mask;
+    } // end while
+
+    return -1;
+} // end Probe_Serial
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Probes the user id index; returns the row or -1
+ */
+static int Probe_UserID(const User_Cache &cache, const char *user_id)
+{
+    if (cache.id_index.empty())
+        return -1;
+
+    u32 i = Hash_UserID(user_id) & cache.mask;
+    while (cache.id_index[i])
+    {
+        u32 row = cache.id_index[i] - 1;
+        if (!strncmp(cache.users[row].user_id, user_id, sizeof(User_Entry::user_id)))
+            return (int)row;
+
+        i = (i + 1) & cache.mask;
+    } // end while
+
+    return -1;
+} // end Probe_UserID
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Loads the user table of the device into the cache; does nothing if the cache is already valid unless forced.
+ *  This is the only call in here that talks to the device.
+ *
+ * @param [machine_num] the machine identifier
+ * @param [bforce] reload even if the cache is valid
+ *
+ * @return int
+ *  0 on success, -ve on fail (see Read_All_UserIDs)
+ */
+int Cache_Load_Users(const int machine_num, const bool bforce)
+{
+    u32 gen;
+    u64 hash;
+    {
+        std::lock_guard<std::mutex> guard(cache_lock);
+        User_Cache &cache = caches[machine_num];
+        if (cache.bvalid && !bforce)
+            return 0;
+
+        gen = cache.generation;
+        hash = cache.hash;
+    }
+
+    std::vector<User_Entry> users;
+    int ret = Read_Changed_UserIDs(machine_num, users, hash);
+    if (ret < 0)
+        return ret;
+
+    std::lock_guard<std::mutex> guard(cache_lock);
+    User_Cache &cache = caches[machine_num];
+    if (ret == 0)
+    {
+        cache.users.swap(users);
+        Build_Index(cache);
+        Fleet_Index_Update(machine_num, cache.users);
+    } // end if
+
+    // same fingerprint means what we hold is still the device table, nothing to rebuild
+    cache.hash = hash;
+
+    // an enroll event that came in during the download may or may not be in there
+    cache.bvalid = (cache.generation == gen);
+
+    return 0;
+} // end Cache_Load_Users
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Looks up a user by serial number.
+ *
+ * @param [machine_num] the machine identifier
+ * @param [serial] the user serial number
+ * @param [puser] gets the user info when found
+ *
+ * @return int
+ *  0 when found, -1 when not, -2 if the cache is not loaded or is stale (see Cache_Load_Users)
+ */
+int Cache_Find_Serial(const int machine_num, const u16 serial, User_Entry *puser)
+{
+    std::lock_guard<std::mutex> guard(cache_lock);
+
+    auto it = caches.find(machine_num);
+    if (it == caches.end() || !it->second.bvalid)
+        return -2;
+
+    int row = Probe_Serial(it->second, serial);
+    if (row < 0)
+        return -1;
+
+    if (puser)
+        *puser = it->second.users[row];
+
+    return 0;
+} // end Cache_Find_Serial
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Looks up a user by user id.
+ *
+ * @param [machine_num] the machine identifier
+ * @param [user_id] the user id string
+ * @param [puser] gets the user info when found
+ *
+ * @return int
+ *  0 when found, -1 when not, -2 if the cache is not loaded or is stale (see Cache_Load_Users)
+ */
+int Cache_Find_UserID(const int machine_num, const char *user_id, User_Entry *puser)
+{
+    std::lock_guard<std::mutex> guard(cache_lock);
+
+    auto it = caches.find(machine_num);
+    if (it == caches.end() || !it->second.bvalid)
+        return -2;
+
+    int row = Probe_UserID(it->second, user_id);
+    if (row < 0)
+        return -1;
+
+    if (puser)
+        *puser = it->second.users[row];
+
+    return 0;
+} // end Cache_Find_UserID
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Copies out the whole cached table.
+ *
+ * @param [machine_num] the machine identifier
+ * @param [users] gets the users
+ *
+ * @return int
+ *  0 on success, -2 if the cache is not loaded or is stale
+ */
+int Cache_Get_Users(const int machine_num, std::vector<User_Entry> &users)
+{
+    std::lock_guard<std::mutex> guard(cache_lock);
+
+    auto it = caches.find(machine_num);
+    if (it == caches.end() || !it->second.bvalid)
+        return -2;
+
+    users = it->second.users;
+    return 0;
+} // end Cache_Get_Users
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Tells if the cache for the device can be used as is.
+ */
+bool Cache_Is_Valid(const int machine_num)
+{
+    std::lock_guard<std::mutex> guard(cache_lock);
+
+    auto it = caches.find(machine_num);
+    return (it != caches.end() && it->second.bvalid);
+} // end Cache_Is_Valid
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Inserts or overwrites a user in the cache; called after the device accepted the same write. Devices that
+ *  have no cache loaded are left alone.
+ *
+ * @param [machine_num] the machine identifier
+ * @param [user] the user info as written to the device
+ */
+void Cache_Put_User(const int machine_num, const User_Entry &user)
+{
+    std::lock_guard<std::mutex> guard(cache_lock);
+
+    auto it = caches.find(machine_num);
+    if (it == caches.end())
+        return;
+
+    User_Cache &cache = it->second;
+    int row = Probe_Serial(cache, user.serial_number);
+    if (row >= 0)
+    {
+        // the id may have changed with it, so a rebuild keeps the id index honest
+        bool bsame_id = !strncmp(cache.users[row].user_id, user.user_id, sizeof(User_Entry::user_id));
+        if (!bsame_id)
+        {
+            Fleet_Index_Remove(machine_num, cache.users[row].user_id);
+            Fleet_Index_Add(machine_num, user.user_id);
+        } // end if
+
+        cache.users[row] = user;
+        if (!bsame_id)
+            Build_Index(cache);
+
+        return;
+    } // end if
+
+    Fleet_Index_Add(machine_num, user.user_id);
+    cache.users.push_back(user);
+    if (cache.users.size() * 2 > cache.mask + 1)
+    {
+        Build_Index(cache);
+        return;
+    } // end if
+
+    u32 r = (u32)cache.users.size();
+    u32 i = Hash_Serial(user.serial_number) & cache.mask;
+    while (cache.sn_index[i])
+        i = (i + 1) & cache.mask;
+    cache.sn_index[i] = r;
+
+    i = Hash_UserID(user.user_id) & cache.mask;
+    while (cache.id_index[i])
+        i = (i + 1) & cache.mask;
+    cache.id_index[i] = r;
+} // end Cache_Put_User
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Removes a user from the cache after the device deleted it.
+ *
+ * @param [machine_num] the machine identifier
+ * @param [serial] the user serial number
+ */
+void Cache_Drop_User(const int machine_num, const u16 serial)
+{
+    std::lock_guard<std::mutex> guard(cache_lock);
+
+    auto it = caches.find(machine_num);
+    if (it == caches.end())
+        return;
+
+    User_Cache &cache = it->second;
+    int row = Probe_Serial(cache, serial);
+    if (row < 0)
+        return;
+
+    Fleet_Index_Remove(machine_num, cache.users[row].user_id);
+
+    // swap with the last one and pop, then reindex; deletes are rare enough
+    cache.users[row] = cache.users.back();
+    cache.users.pop_back();
+    Build_Index(cache);
+} // end Cache_Drop_User
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Marks the cache stale; called from the receive path when the device reports an enrollment. The contents are
+ *  kept around until the next load but lookups refuse to use them.
+ *
+ * @param [machine_num] the machine identifier
+ */
+void Cache_Invalidate(const int machine_num)
+{
+    std::lock_guard<std::mutex> guard(cache_lock);
+
+    auto it = caches.find(machine_num);
+    if (it == caches.end())
+        return;
+
+    it->second.bvalid = false;
+    ++it->second.generation;
+} // end Cache_Invalidate
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Drops the cache of the device altogether; called on disconnect.
+ *
+ * @param [machine_num] the machine identifier
+ */
+void Cache_Clear(const int machine_num)
+{
+    std::lock_guard<std::mutex> guard(cache_lock);
+    caches.erase(machine_num);
+} // end Cache_Clear
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
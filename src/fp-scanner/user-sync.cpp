@@ -0,0 +1,284 @@
+//==============================================================================================================|
+// File Desc:
+//  contains implementation for the diff and push user synchronization engine. Users are matched by their user
+//  id, the one thing that stays put across devices; serial numbers are slots the device hands out and the same
+//  person may well sit in different slots on different devices. A user is pushed, into the slot the device has
+//  it in, only when any of its fields differ from what the device holds.
+//
+// Program Authors:
+//  Rediet Worku, Dr. aka Aethiopis II ben Zahab       PanaceaSolutionsEth@gmail.com, aethiopis2rises@gmail.com
+//
+// Date Created:
+//  18th of October 2026, Sunday
+//
+// Last Updated:
+//  18th of October 2026, Sunday
+//==============================================================================================================|
+
+
+
+//==============================================================================================================|
+// INCLUDES
+//==============================================================================================================|
+#include "user-sync.h"
+#include "user-cache.h"
+#include "device-session.h"
+#include "fan-out.h"
+
+#include <chrono>
+#include <cstring>
+#include <unordered_set>
+
+
+
+//==============================================================================================================|
+// TYPES
+//==============================================================================================================|
+/**
+ * @brief
+ *  What a Sync_Users run hands to each device
+ */
+typedef struct Sync_Job_Info
+{
+    const std::vector<User_Entry> &master;
+    std::vector<User_Sync_Result> &results;
+    const User_Sync_Options &opt;
+} Sync_Job;
+
+
+
+//==============================================================================================================|
+// FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief
+ *  The user id as a string; the field isn't always nul terminated.
+ */
+static inline std::string User_Key(const User_Entry &u)
+{
+    return std::string(u.user_id, strnlen(u.user_id, sizeof(u.user_id)));
+} // end User_Key
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Tells if two entries for the same user say the same thing; the char fields are compared up to their nul,
+ *  whatever garbage follows it doesn't count.
+ */
+static bool Same_User(const User_Entry &a, const User_Entry &b)
+{
+    return a.permissions == b.permissions &&
+        !strncmp(a.password, b.password, sizeof(a.password)) &&
+        !strncmp(a.name, b.name, sizeof(a.name)) &&
+        a.card_number == b.card_number &&
+        a.group_number == b.group_number &&
+        a.user_tzs == b.user_tzs &&
+        a.tz1 == b.tz1 && a.tz2 == b.tz2 && a.tz3 == b.tz3;
+} // end Same_User
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Computes what it takes to turn the device table into the master list. Users are matched by user id; a
+ *  changed user is written back into the slot the device has it in, a new one into its master serial when
+ *  that's free on the device, else the next free serial.
+ *
+ * @param [master] the users as they should be
+ * @param [device] the users as the device has them
+ * @param [upserts] gets the users to be written
+ * @param [deletes] gets the serials to be deleted
+ * @param [bdelete_extra] when true users missing from master are deleted off the device
+ */
+void Diff_Users(const std::vector<User_Entry> &master, const std::vector<User_Entry> &device,
+    std::vector<User_Entry> &upserts, std::vector<u16> &deletes, const bool bdelete_extra)
+{
+    std::unordered_map<std::string, const User_Entry*> have;
+    std::unordered_set<u16> taken;
+    std::vector<const User_Entry*> fresh;
+    u16 next_serial{1};
+
+    have.reserve(device.size());
+    taken.reserve(device.size() + master.size());
+    for (auto &u : device)
+    {
+        have[User_Key(u)] = &u;
+        taken.insert(u.serial_number);
+    } // end for
+
+    for (auto &u : master)
+    {
+        auto it = have.find(User_Key(u));
+        if (it == have.end())
+            fresh.push_back(&u);
+        else
+        {
+            if (!Same_User(u, *it->second))
+            {
+                upserts.push_back(u);
+                upserts.back().serial_number = it->second->serial_number;
+            } // end if
+
+            have.erase(it);
+        } // end else
+    } // end for
+
+    // new users go in last, so they don't land in a slot a matched user is already in; slots of users about
+    //  to be deleted aren't reused either, the deletes go out after the writes
+    for (auto pu : fresh)
+    {
+        upserts.push_back(*pu);
+        User_Entry &u = upserts.back();
+        if (!u.serial_number || !taken.insert(u.serial_number).second)
+        {
+            while (taken.count(next_serial))
+                ++next_serial;
+
+            u.serial_number = next_serial;
+            taken.insert(next_serial);
+        } // end if
+    } // end for
+
+    // what's left over is on the device but not in master
+    if (bdelete_extra)
+    {
+        for (auto &h : have)
+            deletes.push_back(h.second->serial_number);
+
+        std::sort(deletes.begin(), deletes.end());
+    } // end if
+} // end Diff_Users
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Brings a single device in line with the master list; the device is disabled once, the writes and deletes are
+ *  sent pipelined, then a single refresh and enable close it off.
+ *
+ * @param [machine_num] the machine identifier
+ * @param [master] the users as they should be
+ * @param [result] gets what happened
+ * @param [opt] sync options
+ *
+ * @return int
+ *  0 on success, -ve on fail
+ */
+int Sync_Device_Users(const int machine_num, const std::vector<User_Entry> &master, User_Sync_Result &result,
+    const User_Sync_Options &opt)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<User_Entry> device, upserts;
+    std::vector<u16> deletes;
+    std::vector<int> status;
+    int ret{0};
+
+    result = User_Sync_Result();
+    result.machine_num = machine_num;
+
+    if ( (ret = Cache_Load_Users(machine_num)) < 0 || (ret = Cache_Get_Users(machine_num, device)) < 0)
+    {
+        result.status = ret;
+        result.err = Whats_Last_Error(machine_num);
+        return ret;
+    } // end if
+
+    Diff_Users(master, device, upserts, deletes, opt.bdelete_extra);
+    if (upserts.empty() && deletes.empty())
+        return 0;       // already in line
+
+    // one disable for the lot; the batch calls below see the hold and leave the device alone
+    Maintenance_Session session(machine_num);
+    if (!session.Is_Held())
+    {
+        result.status = -1;
+        result.err = Whats_Last_Error(machine_num);
+        return -1;
+    } // end if
+
+    int failed = Set_User_Info_Batch(machine_num, upserts, status, false);
+    if (failed < 0)
+        ret = -1;
+    else
+    {
+        result.failed += failed;
+        result.upserts = (u32)std::count(status.begin(), status.end(), 0);
+    } // end else
+
+    if (ret == 0)
+    {
+        // the refresh after the deletes covers the writes as well
+        failed = Delete_User_Batch(machine_num, deletes, status, true);
+        if (failed < 0)
+            ret = -1;
+        else
+        {
+            result.failed += failed;
+            result.deletes = (u32)std::count(status.begin(), status.end(), 0);
+        } // end else
+    } // end if
+
+    if (ret == 0 && deletes.empty() && result.upserts)
+        ret = Refresh(machine_num);
+
+    // always try and give the device back to its users
+    if (session.Release() < 0 && ret == 0)
+        ret = -1;
+
+    if (ret == 0 && result.failed)
+        ret = -2;
+
+    result.status = ret;
+    if (ret < 0)
+        result.err = Whats_Last_Error(machine_num);
+    result.elapsed_ms = (u64)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    return ret;
+} // end Sync_Device_Users
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Fan out glue for Sync_Users
+ */
+static int Op_Sync_Device(const int machine_num, const size_t index, void *arg)
+{
+    Sync_Job *pjob = (Sync_Job*)arg;
+    return Sync_Device_Users(machine_num, pjob->master, pjob->results[index], pjob->opt);
+} // end Op_Sync_Device
+
+
+//==============================================================================================================|
+/**
+ * @brief
+ *  Brings every device in machines in line with the master list; up to max_parallel devices are worked on at
+ *  once. All devices must already be connected.
+ *
+ * @param [master] the users as they should be
+ * @param [machines] the devices to sync
+ * @param [results] gets one result per device, in the same order as machines
+ * @param [opt] sync options
+ *
+ * @return int
+ *  the number of devices that failed
+ */
+int Sync_Users(const std::vector<User_Entry> &master, const std::vector<int> &machines,
+    std::vector<User_Sync_Result> &results, const User_Sync_Options &opt)
+{
+    std::vector<Fan_Out_Result> fan;
+    Fan_Out_Options fopt;
+    Sync_Job job{master, results, opt};
+
+    results.assign(machines.size(), User_Sync_Result());
+    fopt.max_parallel = opt.max_parallel;
+
+    return Fan_Out(machines, Op_Sync_Device, &job, fan, fopt);
+} // end Sync_Users
+
+
+//==============================================================================================================|
+//          THE END
+//==============================================================================================================|
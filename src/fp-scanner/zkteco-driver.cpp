@@ -21,8 +21,14 @@
 // INCLUDES
 //==============================================================================================================|
 #include "zkteco-driver.h"
+#include "user-cache.h"
+#include "admission.h"
+#include "event-bus.h"
 #include "utils.h"
 
+#include <mutex>
+#include <chrono>
+
 
 
 //==============================================================================================================|
@@ -51,8 +57,8 @@
 // used for sending requestes requiring nothing more than an OK response.
 #define ACT_NODATA(machine_num, cmdid) { \
     Zkt_Packet snd, rcv; \
-    u16 rnum{rq[machine_num].reply_num++}; \
-    ACT(machine_num, snd, rcv, cmdid, rq[machine_num].session_id, rnum, Checksum(&snd.payload), 0); \
+    u16 rnum{Dev(machine_num).reply_num++}; \
+    ACT(machine_num, snd, rcv, cmdid, Dev(machine_num).session_id, rnum, Checksum(&snd.payload), 0); \
     RSP_OK(rcv.payload.command_id, machine_num); \
 } // end NODATA_ACT
 
@@ -65,8 +71,8 @@
     SET_PACKET(snd, chksum, PAYLOAD_SIZE + dlen); \
     /*Dump_Hex((char*)&snd, PACKET_SIZE); \
     Dump_Hex((char*)snd.payload.data, dlen);*/\
-    if (rq[machine_num].cli.Send(&snd, PACKET_SIZE) < 0) return -1; \
-    if (dlen > 0) { if (rq[machine_num].cli.Send(snd.payload.data, dlen) < 0) return -1; } \
+    if (Dev(machine_num).cli.Send(&snd, PACKET_SIZE) < 0) return -1; \
+    if (dlen > 0) { if (Dev(machine_num).cli.Send(snd.payload.data, dlen) < 0) return -1; } \
     if (Get_Response(machine_num, rnum, rcv) < 0) return -1; \
     /*Dump_Hex((char*)&rcv, PACKET_SIZE); \
     Dump_Hex((char*)rcv.payload.data, rcv.payload_size - PAYLOAD_SIZE); */\
@@ -79,9 +85,9 @@
 //  than an OK response; CMD_AUTH for example.
 #define ACT_INDATA(machine_num, cmd_id, dat, dlen) { \
     Zkt_Packet snd, rcv; \
-    u16 rnum{rq[machine_num].reply_num++}; \
+    u16 rnum{Dev(machine_num).reply_num++}; \
     snd.payload.data = (u8*)dat; \
-    ACT(machine_num, snd, rcv, cmd_id, rq[machine_num].session_id, rnum, \
+    ACT(machine_num, snd, rcv, cmd_id, Dev(machine_num).session_id, rnum, \
         Checksum(&snd.payload, (u16*)dat, dlen >> 1), dlen); \
     RSP_OK(rcv.payload.command_id, machine_num); \
 } // end ACT_INDATA
@@ -93,9 +99,9 @@
 //  besides an OK
 #define ACT_OUTDATA(machine_num, cmd_id, dat_in, in_len, dat_out, out_len) { \
     Zkt_Packet snd, rcv;    \
-    u16 rnum{rq[machine_num].reply_num++}; \
+    u16 rnum{Dev(machine_num).reply_num++}; \
     snd.payload.data = (u8*)dat_in; \
-    ACT(machine_num, snd, rcv, cmd_id, rq[machine_num].session_id, rnum, \
+    ACT(machine_num, snd, rcv, cmd_id, Dev(machine_num).session_id, rnum, \
         Checksum(&snd.payload, (u16*)dat_in, in_len >> 1), in_len); \
     if (rcv.payload.data) { \
         out_len = rcv.payload_size - PAYLOAD_SIZE; \
@@ -109,7 +115,7 @@
 
 
 // tests response if being ok or not, and set's the global error string returns -2
-#define RSP_OK(cid, mnum) { if (RNTOHS(cid) != CMD_ACK_OK) { rq[mnum].err = "Device returned code: " + std::to_string(cid); \
+#define RSP_OK(cid, mnum) { if (RNTOHS(cid) != CMD_ACK_OK) { Dev(mnum).err = "Device returned code: " + std::to_string(cid); \
     return -2; } \
 } // end RSP_OK
 
@@ -123,7 +129,7 @@
     hr = (f / 3600) % 24; \
     day = ((f / (3600 * 24)) % 31) + 1; \
     mon = ((f / (3600 * 24 * 31)) % 12 ) + 1; \
-    yr = ((f / (3600 * 24)) / 365) + 2000; \
+    yr = (f / (3600 * 24 * 31 * 12)) + 2000; \
 } // end Decode_Date
 
 
@@ -134,13 +140,22 @@
 
 
 
+// serializes the commands to a device for the rest of the scope; a hold (see Hold_Device) keeps it until released
+#define DEVICE_LOCK(machine_num) std::lock_guard<std::recursive_mutex> device_guard(*Dev(machine_num).pop_lock)
+
+
+
 //==============================================================================================================|
 // GLOBALS
 //==============================================================================================================|
 // Key value pair of client connections plus a couple of more info; i.e. mapped with machine num to response info.
+//  Entries are only ever added, under rq_lock, and never erased; unordered_map nodes don't move on a rehash, thus
+//  a reference got through Dev stays good for as long as the driver runs, whatever other threads connect.
 std::unordered_map<int, Driver_Info> rq;
-std::thread *ps_thread;                         // c++11 thread (makes it nice since its cross-platform)
-MUTEX mutex;                                    // memory protection in case we need any
+std::mutex rq_lock;                             // guards the structure of rq; not the entries
+std::thread *ps_thread;                         // the select thread started last; set under rq_lock
+std::mutex reply_lock;                          // guards the reply queues and bconnected of every connection
+std::once_flag init_once;                       // the event subscriber is set up once
 
 // states
 u32 connenction_count{0};           // tracks active connections
@@ -158,51 +173,139 @@ bool brunning{true};                // controls the life-time of Run_Select loop
 //==============================================================================================================|
 /**
  * @brief 
- *  Device response; simply bundles the sending and receving stages in one go
+ *  Looks up (or makes) the entry for a connection; the only way into rq, so that connections made and dropped
+ *  on pool workers never race the lookups of other threads.
  * 
- * @param [len] length of packet for the sending stage
+ * @param [machine_num] the machine identifer
+ * 
+ * @return Driver_Info& 
+ *  the entry; good for the life of the driver
+ */
+Driver_Info &Dev(const int machine_num)
+{
+    std::lock_guard<std::mutex> guard(rq_lock);
+    return rq[machine_num];
+} // end Dev
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Steady clock milliseconds; for the reply deadlines.
+ */
+static inline u64 Now_Ms()
+{
+    return (u64)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+} // end Now_Ms
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Device response; waits for the reply to reply_num as filed by Run_Select. Replies are filed by their reply
+ *  number, so we wait for ours in particular; that way any number of requests can be in flight at once (see
+ *  Send_Pipelined). The wait is as long as the connection's receive timeout, counted from the last bytes that
+ *  came in, thus a large transfer still on its way doesn't time out half way.
+ * 
+ * @param [machine_num] the machine identifer
+ * @param [reply_num] the reply number of the request
+ * @param [zkt] gets the reply; the caller frees its data
  * 
  * @return int 
- *  a 0 on success alas -1
+ *  a 0 on success alas -1 on timeout or if the connection went down
  */
 int Get_Response(const int machine_num, const int reply_num, Zkt_Packet &zkt)
 {
-    // note: this could be a bad approach, since under unforseen extreme cases our loop
-    //  may never exit; a better approach would have been to use signaling and wake the 
-    //  process up whenever things are ready; however in the real world, I've got no time
+    Driver_Info &dev = Dev(machine_num);
+    std::shared_ptr<Reply_Signal> psignal = dev.psignal;
+    int secs = dev.cli.Get_Recv_Timeout();
+    u64 timeout_ms = (u64)(secs > 0 ? secs : ZKT_REPLY_TIMEOUT) * 1000;
+    u64 start = Now_Ms();
+
+    std::unique_lock<std::mutex> lock(reply_lock);
+    dev.abandoned.erase((u16)reply_num);        // the number came around again; its reply is wanted
+    for (;;)
+    {
+        auto it = dev.que.find((u16)reply_num);
+        if (it != dev.que.end() && !it->second.empty())
+        {
+            // hand over the packet along with its data; caller frees it
+            zkt = it->second.front();
+            it->second.pop_front();
+            if (it->second.empty())
+                dev.que.erase(it);
 
-    while (!rq[machine_num].bok);
-    
-    //Mutex_Lock(&mutex);
+            return 0;
+        } // end if
 
-    // iterate thru the rcvers and get me the message 
-    auto it = rq[machine_num].que.find(reply_num);
-    if (it != rq[machine_num].que.end())
-    {
-        iCpy((void*)&zkt, (void*)&it->second, PACKET_SIZE);
-        if (it->second.payload_size - PAYLOAD_SIZE > 0) {
-            if ( !(zkt.payload.data = (u8*)malloc(it->second.payload_size - PAYLOAD_SIZE)))
-                return -1;
-            iCpy(zkt.payload.data, it->second.payload.data, it->second.payload_size - PAYLOAD_SIZE);
+        if (!dev.bconnected)
+        {
+            dev.err = "Connection lost waiting on a reply";
+            return -1;
         } // end if
 
-        rq[machine_num].que.erase(it);
-        rq[machine_num].bok = false;
-        return 0;
-    } // end if
+        u64 last = std::max(start, psignal->last_rx_ms.load(std::memory_order_relaxed));
+        u64 now = Now_Ms();
+        if (now >= last + timeout_ms)
+        {
+            dev.err = "Timed out waiting on a reply";
+            return -1;
+        } // end if
 
-    //Mutex_Unlock(&mutex);
-    return -1;
+        psignal->cv.wait_for(lock, std::chrono::milliseconds(last + timeout_ms - now));
+    } // end for
 } // end Get_Response
 
 
+//==============================================================================================================|
+/**
+ * @brief 
+ *  The driver's own event subscriber (see event-bus.h); enrollments at the device invalidate the cached user
+ *  table. Attendance is left to the subscribers that want it.
+ * 
+ * @param [precs] a batch of events
+ * @param [count] the number of events in the batch
+ * @param [arg] unused
+ */
+static void Handle_Events(const Event_Record *precs, const size_t count, void *arg)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        const Event_Record &rec = precs[i];
+        if (rec.event == EF_ENROLLUSER || rec.event == EF_ENROLLFINGER)
+        {
+            // someone got enrolled at the device itself; our cached copy of users is no longer the truth
+            Cache_Invalidate(rec.machine_num);
+        } // end if enrollment
+    } // end for
+} // end Handle_Events
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Publishes a realtime packet on the event bus; the data stays with the caller. Events that come in on a
+ *  dedicated event channel are filed under the device the channel serves.
+ * 
+ * @param [machine_num] the connection the packet came in on
+ * @param [ppack] the event packet
+ */
+static void Post_Event(const int machine_num, const Driver_Info &dev, Zkt_Packet_Ptr ppack)
+{
+    int owner = dev.owner >= 0 ? dev.owner : machine_num;
+    u32 len = ppack->payload.data ? ppack->payload_size - PAYLOAD_SIZE : 0;
+
+    Event_Publish(owner, RNTOHS(ppack->payload.session_id), ppack->payload.data, len);
+} // end Post_Event
+
+
 //==============================================================================================================|
 /**
  * @brief 
  *  handles the response into one of the following classes; realtime and non-realtime (on demand) packets; these
  *  are distingushed by their command id. For non realtime packets we add the whole package into a map as a form
- *  of queue and let caller worry about it. For realtime we invoke its handler by passing the data as a Attendance
- *  transaction log; all other realtime packets remain unimplemented.
+ *  of queue and let caller worry about it. Realtime packets are published on the event bus (see event-bus.h).
  * 
  * @param [machine_num] a descriptor that identifies the machine we are connecting with
  * @param [ppack] pointer to the ZKT packet format containing the device responses 
@@ -212,34 +315,21 @@ void Process_Response(const int machine_num, Zkt_Packet_Ptr ppack)
     if (ppack->payload.command_id != CMD_REG_EVENT)
     {
         // this is not a realtime packet add it to the global map so that
-        //  its caller can find it.
-        //rq[machine_num].que[ppack->payload.reply_number] = *ppack;
-        iCpy((void*)&rq[machine_num].que[ppack->payload.reply_number], 
-            ppack, PACKET_SIZE);
-
-        if ( !(rq[machine_num].que[ppack->payload.reply_number].payload.data = (u8*)malloc(
-            ppack->payload_size - PAYLOAD_SIZE)))
+        //  its caller can find it; the data is handed over as is.
+        Driver_Info &dev = Dev(machine_num);
+        if (dev.abandoned.erase(ppack->payload.reply_number))
+        {
+            FREE_BUF(ppack->payload.data);     // a late reply to a request given up on
             return;
+        } // end if
 
-        iCpy(rq[machine_num].que[ppack->payload.reply_number].payload.data, 
-            ppack->payload.data, ppack->payload_size - PAYLOAD_SIZE);
-        rq[machine_num].bok = true;
+        dev.que[ppack->payload.reply_number].push_back(*ppack);
+        ppack->payload.data = nullptr;
+        dev.bok = true;
+        dev.psignal->cv.notify_all();
     } // end if not real
-    else {
-        // this is a realtime packet; invoke its handler pronto, i.e. the callback
-        //  and make sure its an attendance data; other types, sorry no can do ...
-        if (RNTOHS(ppack->payload.session_id) == 1)      // attendance
-        {
-            Att_Realtime_Log att;
-            iCpy(&att, ppack->payload.data, sizeof(att));
-            att.user_id[8] = '\0';
-            fputs(att.user_id, stdout);
-            printf("\nTime: 20%d/%d/%d %d:%d:%d\n", (u8)att.att_time[0], (u8)att.att_time[1],
-                (u8)att.att_time[2], (u8)att.att_time[3], (u8)att.att_time[4], (u8)att.att_time[5]);
-        } // end if attendance
-
-        // igonre all others
-    } // end else
+    else
+        Post_Event(machine_num, Dev(machine_num), ppack);
 
     // a little house cleaning ...
     if (ppack->payload.data) {
@@ -263,15 +353,18 @@ void Run_Select(const int machine_num)
 {
     // here we re-tailor the select sys call to meet the needs of our app; we want to allocate enough
     //  memory for our response since I don't wanna go back and forth for more data.
+    Driver_Info &dev = Dev(machine_num);     // taken once; the loop never goes back to rq
+    Reply_Signal *psignal = dev.psignal.get();
     fd_set rset;        // reading set
+    u8 evbuf[ZKT_DATA_SIZE];    // takes in realtime event data
     FD_ZERO(&rset);
 
     while (brunning)
     {
         Zkt_Packet rcv;
 
-        FD_SET(rq[machine_num].cli.Get_Socket(), &rset);
-        int maxfdp1 = rq[machine_num].cli.Get_Socket() + 1;
+        FD_SET(dev.cli.Get_Socket(), &rset);
+        int maxfdp1 = dev.cli.Get_Socket() + 1;
 
         // block on select sys call instead of plain recieve, this allows a form of robustness for our thread
         //  since the waiting is handled by the kernel
@@ -279,47 +372,178 @@ void Run_Select(const int machine_num)
         {
             // our receving end is ready for reading (after about infity time wait...), but
             //  make sure it is, since this is the way to go.
-            if (FD_ISSET(rq[machine_num].cli.Get_Socket(), &rset))
+            if (FD_ISSET(dev.cli.Get_Socket(), &rset))
             {
                 // first up read in the header + payload info without the data; that should tell
                 //  us everything we need...
                 int bytes;
-                if ( (bytes = rq[machine_num].cli.Recv(&rcv, PACKET_SIZE)) < 0)
-                    break;
+                if ( (bytes = dev.cli.Recv(&rcv, PACKET_SIZE)) <= 0)
+                    break;      // gone; or shut down by Disconnect_Net
+                psignal->last_rx_ms.store(Now_Ms(), std::memory_order_relaxed);
 
                 // test if we got more data, that info should be stored in payload_size feild
                 //  of our little packet description
                 if (rcv.payload_size > PAYLOAD_SIZE)
                 {
-                    // compute the data length
+                    // compute the data length; realtime events are small and go onto the stack so that the
+                    //  event path never allocates
                     u32 len = rcv.payload_size - PAYLOAD_SIZE;
-                    if ( !(rcv.payload.data = (u8*)malloc(len)))
+                    if (rcv.payload.command_id == CMD_REG_EVENT && len <= sizeof(evbuf))
+                        rcv.payload.data = evbuf;
+                    else if ( !(rcv.payload.data = (u8*)malloc(len)))
                          break;
 
                     u8 *alias = rcv.payload.data;
                     //u32 llen = len;
                     iZero(rcv.payload.data, len);
                     do {
-                        if ( (bytes = rq[machine_num].cli.Recv(alias, len)) < 0)
+                        if ( (bytes = dev.cli.Recv(alias, len)) <= 0)
                             break;
 
+                        psignal->last_rx_ms.store(Now_Ms(), std::memory_order_relaxed);
                         alias += bytes;
                         len -= bytes;
                     } while (len > 0);
                     //Dump_Hex((char *)rcv.payload.data, llen);
+
+                    // cut off half way; the packet is no reply at all and the connection is done with
+                    if (len > 0)
+                    {
+                        if (rcv.payload.data != evbuf)
+                            FREE_BUF(rcv.payload.data);
+                        break;
+                    } // end if
                 } // end if more data
 
-                Mutex_Lock(&mutex);
-                Process_Response(machine_num, &rcv);
-                Mutex_Unlock(&mutex);
+                // realtime events take the fast lane; the lock is for the reply queue only
+                if (rcv.payload.command_id == CMD_REG_EVENT)
+                {
+                    Post_Event(machine_num, dev, &rcv);
+                    if (rcv.payload.data != evbuf)
+                        FREE_BUF(rcv.payload.data);
+                } // end if
+                else
+                {
+                    std::lock_guard<std::mutex> guard(reply_lock);
+                    Process_Response(machine_num, &rcv);
+                } // end else
             } // end if set
         } // end if selecting
         else
             break;
     } // end while
+
+    // whoever waits on a reply from here on gets -1 rather than a wait to the timeout
+    std::lock_guard<std::mutex> guard(reply_lock);
+    dev.bconnected = false;
+    psignal->cv.notify_all();
 } // end Run_Select
 
 
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Gives up on requests still in flight; replies already in are freed and those that come in later are
+ *  dropped by Process_Response, so that none of them piles up in the reply queue. Their status stays -1.
+ * 
+ * @param [dev] the connection
+ * @param [inflight] request index : reply number of the requests given up on
+ * @param [status] the per request status
+ */
+static void Abandon_Inflight(Driver_Info &dev, const std::deque<std::pair<u32, u16>> &inflight, 
+    std::vector<int> &status)
+{
+    std::lock_guard<std::mutex> guard(reply_lock);
+    for (auto &req : inflight)
+    {
+        status[req.first] = -1;
+        auto it = dev.que.find(req.second);
+        if (it == dev.que.end())
+        {
+            dev.abandoned.insert(req.second);
+            continue;
+        } // end if
+
+        for (Zkt_Packet &pack : it->second)
+            FREE_BUF(pack.payload.data);
+        dev.que.erase(it);
+    } // end for
+} // end Abandon_Inflight
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Sends count requests of the same kind back to back without waiting on each reply in turn; up to window of
+ *  them are kept in flight and the replies are collected as they come in (Get_Response picks them out by reply
+ *  number). Each request carries dlen bytes taken in order from dat, e.g. an array of User_Entry for
+ *  CMD_USER_WRQ. The whole run costs about one round trip per window instead of one per request.
+ * 
+ * @param [machine_num] the machine identifier
+ * @param [cmd_id] the request code used for all of them
+ * @param [dat] the request data laid back to back
+ * @param [dlen] the length of data per request in bytes
+ * @param [count] number of requests
+ * @param [status] gets per request 0 for CMD_ACK_OK, -2 if the device said otherwise or -1 if it never replied
+ * @param [window] the most requests in flight at once
+ * 
+ * @return int 
+ *  the number of requests the device refused, -1 if the connection failed half way; the requests still in
+ *  flight are then given up on (see Abandon_Inflight)
+ */
+int Send_Pipelined(const int machine_num, const u16 cmd_id, const void *dat, const u32 dlen, const u32 count,
+    std::vector<int> &status, const u32 window)
+{
+    DEVICE_LOCK(machine_num);
+    std::deque<std::pair<u32, u16>> inflight;       // request index : reply number
+    u32 next{0};
+    int failed{0};
+
+    status.assign(count, -1);
+    while (next < count || !inflight.empty())
+    {
+        while (next < count && inflight.size() < (window ? window : 1))
+        {
+            Zkt_Packet snd;
+            u8 *p = (u8 *)dat + (size_t)next * dlen;
+            u16 rnum = Dev(machine_num).reply_num++;
+
+            snd.payload.data = p;
+            SET_PAYLOAD(snd.payload, cmd_id, Dev(machine_num).session_id, rnum);
+            SET_PACKET(snd, Checksum(&snd.payload, (u16*)p, dlen >> 1), PAYLOAD_SIZE + dlen);
+            inflight.push_back(std::make_pair(next++, rnum));
+            if (Dev(machine_num).cli.Send(&snd, PACKET_SIZE) < 0 ||
+                (dlen > 0 && Dev(machine_num).cli.Send(p, dlen) < 0))
+            {
+                Abandon_Inflight(Dev(machine_num), inflight, status);
+                return -1;
+            } // end if
+        } // end while
+
+        Zkt_Packet rcv;
+        if (Get_Response(machine_num, inflight.front().second, rcv) < 0)
+        {
+            Abandon_Inflight(Dev(machine_num), inflight, status);
+            return -1;
+        } // end if
+
+        if (RNTOHS(rcv.payload.command_id) == CMD_ACK_OK)
+            status[inflight.front().first] = 0;
+        else
+        {
+            status[inflight.front().first] = -2;
+            Dev(machine_num).err = "Device returned code: " + std::to_string(RNTOHS(rcv.payload.command_id));
+            ++failed;
+        } // end else
+
+        FREE_BUF(rcv.payload.data);
+        inflight.pop_front();
+    } // end while
+
+    return failed;
+} // end Send_Pipelined
+
+
 //==============================================================================================================|
 /**
  * @brief 
@@ -332,7 +556,7 @@ void Run_Select(const int machine_num)
  */
 std::string Whats_Last_Error(const int machine_num)
 {
-    return rq[machine_num].err;
+    return Dev(machine_num).err;
 } // end Set_Request
 
 
@@ -361,23 +585,42 @@ std::string Whats_Last_Error(const int machine_num)
 int Connect_Net(const int machine_num, const std::string &ip, const std::string &port, const int password)
 {
     Zkt_Packet snd, rcv;    // sending and rcving packets
-    Driver_Info di;         // some driver info
+    Driver_Info &dev = Dev(machine_num);
+
+    // the event subscriber is shared by all connections, so it's only set up once; connects run side by side on
+    //  pool workers
+    std::call_once(init_once, []() {
+        Event_Subscribe(Handle_Events, nullptr, RT_ENROLLUSER | RT_ENROLLFINGER);
+    });
+
+    // a live connection still has its select thread on the entry; it must be let go of first
+    if (dev.pselect)
+    {
+        dev.err = "Already connected";
+        return -1;
+    } // end if
 
-    rq[machine_num] = di;
-    if ( (rq[machine_num].cli.Tcp_Connect(ip, port)) < 0)
+    dev = Driver_Info();
+    dev.ip = ip;
+    if ( (dev.cli.Tcp_Connect(ip, port)) < 0)
         return -1;
 
-    rq[machine_num].cli.Toggle_TcpDelay();
-    rq[machine_num].cli.Set_Recv_Timeout();
-    rq[machine_num].cli.Toggle_KeepAlive();
+    dev.cli.Toggle_TcpDelay();
+    dev.cli.Set_Recv_Timeout();
+    dev.cli.Toggle_KeepAlive();
+    dev.bconnected = true;
 
     // fire up select thread; which reterives our response in async
-    ps_thread = new std::thread(Run_Select, machine_num);
-    Mutex_Init(&mutex);
+    dev.pselect = new std::thread(Run_Select, machine_num);
+    {
+        std::lock_guard<std::mutex> guard(rq_lock);
+        ps_thread = dev.pselect;
+    }
+
     ACT(machine_num, snd, rcv, CMD_CONNECT, 0, 0, Checksum(&snd.payload), 0);
 
     // save session id and all 
-    rq[machine_num].session_id = RNTOHS(rcv.payload.session_id);
+    Dev(machine_num).session_id = RNTOHS(rcv.payload.session_id);
 
     // when the device allows for unauthorized connections, it simply responds with
     //  CMD_ACK_OK message, if that's the case we done, end exit here; however mostly
@@ -385,12 +628,12 @@ int Connect_Net(const int machine_num, const std::string &ip, const std::string
     //  using CMD_AUTH command id, and if all goes well device should respond with CMD_ACK_OK.
     if (RNTOHS(rcv.payload.command_id) == CMD_ACK_UNAUTH)
     {
-        u32 hash = Commkey(rq[machine_num].session_id, password);      
+        u32 hash = Commkey(Dev(machine_num).session_id, password);      
         ACT_INDATA(machine_num, CMD_AUTH, &hash, sizeof(hash));
 
         // test response; plz don't be CMD_ACK_UNAUTH again; it means we don't know
         //  the freaking password ...
-        rq[machine_num].reply_num = 3;
+        Dev(machine_num).reply_num = 3;
     } // end if unauthorized
 
     return 0;
@@ -400,8 +643,21 @@ int Connect_Net(const int machine_num, const std::string &ip, const std::string
 //==============================================================================================================|
 /**
  * @brief 
- *  Disconnect's the connected session; removes the item from the que map; if on the last connection sets brunning
- *  to false to exit the Run_Select thread.
+ *  Says good bye to the device; split out of Disconnect_Net, which goes on tearing down whatever this returns.
+ */
+static int Send_Exit(const int machine_num)
+{
+    ACT_NODATA(machine_num, CMD_EXIT);
+    return 0;
+} // end Send_Exit
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Disconnect's the connected session; the socket is shut down, which lets the connection's Run_Select thread
+ *  out, and the thread is joined before the socket is closed. The entry stays in rq (see Dev) and replies left
+ *  on it are freed; the connection is torn down even when the device doesn't answer the good bye.
  * 
  * @param [machine_num] the machine identifer
  * 
@@ -410,21 +666,90 @@ int Connect_Net(const int machine_num, const std::string &ip, const std::string
  */
 int Disconnect_Net(const int machine_num)
 {
-    ACT_NODATA(machine_num, CMD_EXIT);
-    if (rq[machine_num].cli.Disconnect() < 0)
+    Driver_Info &dev = Dev(machine_num);
+    if (!dev.pselect)
         return -1;
-    
-    rq.erase(machine_num);
-    if (rq.size() == 0)
+
+    int ret = Send_Exit(machine_num);
+
+    shutdown(dev.cli.Get_Socket(), SHUT_RDWR);
+    if (dev.pselect->joinable())
+        dev.pselect->join();
+
     {
-        brunning = false;
-        //ps_thread->join();  // wait for it
-    } // end if
+        std::lock_guard<std::mutex> guard(rq_lock);
+        if (ps_thread == dev.pselect)
+            ps_thread = nullptr;
+    }
+    delete dev.pselect;
+    dev.pselect = nullptr;
 
-    return 0;
+    if (dev.cli.Disconnect() < 0)
+        ret = -1;
+
+    {
+        std::lock_guard<std::mutex> guard(reply_lock);
+        for (auto &it : dev.que)
+        {
+            for (Zkt_Packet &pack : it.second)
+                FREE_BUF(pack.payload.data);
+        } // end for
+        dev.que.clear();
+        dev.abandoned.clear();
+    }
+
+    Cache_Clear(machine_num);
+    return ret < 0 ? -1 : 0;
 } // end Disconnect
 
 
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Opens a second connection to the device that carries nothing but its realtime events; with events off the
+ *  main connection they are never framed behind a large CMD_DATA transfer. The channel lives in rq under
+ *  EVENT_CHANNEL(machine_num) and its events are filed under machine_num. The device must allow more than one
+ *  session at a time.
+ * 
+ * @param [machine_num] the device the channel serves (connected or not)
+ * @param [ip] the device address
+ * @param [port] the device port
+ * @param [password] the device comm key
+ * @param [mask] the events to register for (see Init_Realtime)
+ * 
+ * @return int 
+ *  0 on success, -ve on fail
+ */
+int Connect_Event_Channel(const int machine_num, const std::string &ip, const std::string &port, 
+    const int password, const Realtime_Mask mask)
+{
+    int ev = EVENT_CHANNEL(machine_num);
+
+    if (Connect_Net(ev, ip, port, password) < 0)
+        return -1;
+
+    // no events are registered for yet, so nothing has come in under the wrong owner
+    Dev(ev).owner = machine_num;
+    return Init_Realtime(ev, mask);
+} // end Connect_Event_Channel
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Closes the event channel opened by Connect_Event_Channel.
+ * 
+ * @param [machine_num] the device the channel serves
+ * 
+ * @return int 
+ *  0 on success, -1 on fail.
+ */
+int Disconnect_Event_Channel(const int machine_num)
+{
+    return Disconnect_Net(EVENT_CHANNEL(machine_num));
+} // end Disconnect_Event_Channel
+
+
 //==============================================================================================================|
 /**
  * @brief 
@@ -438,10 +763,24 @@ int Disconnect_Net(const int machine_num)
  */
 int Get_Device_Status(const int machine_num, Machine_Status *pstat)
 {
-    u32 len;        // length in bytes
-    void *palias = (void *)pstat;
+    DEVICE_LOCK(machine_num);
+    u32 len{0};             // length in bytes
+    void *pout{nullptr};    // gets the raw reply
 
-    ACT_OUTDATA(machine_num, CMD_GET_FREE_SIZES, nullptr, 0, palias, len);
+    if (!pstat)
+        return -1;
+
+    iZero(pstat, sizeof(Machine_Status));
+    ACT_OUTDATA(machine_num, CMD_GET_FREE_SIZES, nullptr, 0, pout, len);
+    if (!pout)
+    {
+        Dev(machine_num).err = "Device returned no status info";
+        return -2;
+    } // end if
+
+    // older firmwares send a shorter reply; take in what's there
+    iCpy(pstat, pout, len < sizeof(Machine_Status) ? len : sizeof(Machine_Status));
+    free(pout);
 
     return 0;  
 } // end Get_Device_Status
@@ -460,10 +799,25 @@ int Get_Device_Status(const int machine_num, Machine_Status *pstat)
  */
 int Get_Time(const int machine_num, u32* ptime)
 {
-    void *palias = (void*)ptime;
-    u32 len;
-    ACT_OUTDATA(machine_num, CMD_GET_TIME, nullptr, 0, palias, len);
-    
+    DEVICE_LOCK(machine_num);
+    void *pout{nullptr};
+    u32 len{0};
+
+    if (!ptime)
+        return -1;
+
+    ACT_OUTDATA(machine_num, CMD_GET_TIME, nullptr, 0, pout, len);
+    if (!pout || len < sizeof(u32))
+    {
+        if (pout)
+            free(pout);
+        Dev(machine_num).err = "Device returned no time";
+        return -2;
+    } // end if
+
+    iCpy(ptime, pout, sizeof(u32));
+    free(pout);
+
     return 0;  
 } // end Get_Device_Time
 
@@ -480,6 +834,7 @@ int Get_Time(const int machine_num, u32* ptime)
  */
 int Refresh(const int machine_num, const u16 command_id)
 {
+    DEVICE_LOCK(machine_num);
     ACT_NODATA(machine_num, command_id);
     return 0;  
 } // end REferesh
@@ -498,6 +853,7 @@ int Refresh(const int machine_num, const u16 command_id)
  */
 int Set_Time(const int machine_num, const u32 _time1)
 {
+    DEVICE_LOCK(machine_num);
     ACT_INDATA(machine_num, CMD_SET_TIME, &_time1, sizeof(_time1));
     if (Refresh(machine_num) < 0)
         return -1;
@@ -513,46 +869,105 @@ int Set_Time(const int machine_num, const u32 _time1)
 //==============================================================================================================|
 /**
  * @brief 
- *  Returns the entire she-bang of users stored in the device.
+ *  Walks the raw user table blob as sent by the device; the first four bytes tell the length of the table in
+ *  bytes followed by the user entries back to back.
+ * 
+ * @param [blob] the raw table
+ * @param [users] gets the user infos
+ */
+static void Parse_Users(const u8 *blob, std::vector<User_Entry> &users)
+{
+    u32 len = *((u32*)blob) / sizeof(User_Entry);
+    const u8 *p = blob + 4;
+
+    users.reserve(users.size() + len);
+    for (u32 i = 0; i < len; i++, p += sizeof(User_Entry)) 
+    {
+        User_Entry user;
+        iCpy(&user, p, sizeof(User_Entry));
+        users.push_back(user);
+    } // end for
+} // end Parse_Users
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Waits for room on the uplink for a bulk download, before the device is disabled; a device queued behind
+ *  the admission limits thus keeps serving its users while it waits. The size of the download is worked out
+ *  from the record counts of Get_Device_Status.
+ * 
+ * @param [machine_num] the device identifer 
+ * @param [busers] true for the user table, false for the attendance log
+ * @param [ticket] gets the admission; let go of it once the download is done
+ *  
+ * @return int 
+ *  0 when let in alas -ve on fail
+ */
+static int Admit_Transfer(const int machine_num, const bool busers, std::unique_ptr<Adm_Ticket> &ticket)
+{
+    Machine_Status st;
+    int ret;
+
+    if ( (ret = Get_Device_Status(machine_num, &st)) < 0)
+        return ret;
+
+    u32 bytes = busers ? st.user_count * (u32)sizeof(User_Entry) : st.att_count * (u32)sizeof(Attendance_Entry);
+    ticket.reset(new Adm_Ticket(Dev(machine_num).ip, bytes));
+    if (!ticket->Is_Admitted())
+    {
+        Dev(machine_num).err = "Timed out waiting for admission of a " + std::to_string(bytes) + " byte transfer";
+        return -2;
+    } // end if
+
+    return 0;
+} // end Admit_Transfer
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Downloads the user table and fingerprints the raw blob with Hash_Block before anything gets parsed. When the
+ *  fingerprint matches known_hash the parsing is skipped altogether; otherwise the users are appended to users.
+ *  Only a table that came whole goes anywhere: on fail users and the fingerprint are left as they were.
+ *  Admission (see Admit_Transfer) and the disabling and enabling of the device are left to the caller.
  * 
  * @param [machine_num] the device identifer 
  * @param [users] vector of user infos
+ * @param [known_hash] the fingerprint the caller already has; 0 for none
+ * @param [phash] gets the fingerprint of the table just downloaded
  *  
  * @return int 
- *  0 on success alas -1 on fail
+ *  0 when parsed, 1 when unchanged (nothing parsed) alas -ve on fail
  */
-int Read_All_UserIDs(const int machine_num, std::vector<User_Entry> &users)
+static int Fetch_Users(const int machine_num, std::vector<User_Entry> &users, const u64 known_hash, u64 *phash)
 {
     Zkt_Packet snd, rcv;
+    std::vector<User_Entry> fetched;
+    u64 hash{0};
+    int ret{0};
 
     // the meaining of these values have not yet been deciphered ...
     u8 dat[11]{0x01, 0x09, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
     
-    Disable_Device(machine_num);
-    u16 rnum = rq[machine_num].reply_num;
+    u16 rnum = Dev(machine_num).reply_num;
 
     snd.payload.data = dat;
-    ACT(machine_num, snd, rcv, CMD_DATA_WRRQ, rq[machine_num].session_id, 
+    ACT(machine_num, snd, rcv, CMD_DATA_WRRQ, Dev(machine_num).session_id, 
         rnum, Checksum(&snd.payload, (u16*)&dat, 5), 11);
     
-    ++rq[machine_num].reply_num;
-    switch (rcv.payload.command_id) 
+    ++Dev(machine_num).reply_num;
+    switch (RNTOHS(rcv.payload.command_id)) 
     {
         case CMD_DATA:      // data has been appeneded to this response
         {
             // the first four bytes of data tell us the length of the entire payload
-            //  junk in bytes, thus let's take in that info and convert it to counts
-            //  by dividing with a user_entry struct size.
-            
-            u32 len = *((u32*)rcv.payload.data) / sizeof(User_Entry);
-            User_Entry_Ptr pusr = (User_Entry_Ptr)(rcv.payload.data + 4);
-            u32 i = 0;
-            while (i++ < len) 
-            {
-                User_Entry user = *pusr;
-                users.push_back(user);
-                pusr = (User_Entry_Ptr)((rcv.payload.data + 4) + (i * sizeof(User_Entry)));
-            } // end while
+            //  junk in bytes; fingerprint the lot before parsing
+            hash = Hash_Block(rcv.payload.data, 4 + *((u32*)rcv.payload.data));
+            if (known_hash && hash == known_hash)
+                ret = 1;
+            else
+                Parse_Users(rcv.payload.data, fetched);
         } break;
 
         case CMD_ACK_OK:    // our data is large, we require a few added steps
@@ -560,47 +975,153 @@ int Read_All_UserIDs(const int machine_num, std::vector<User_Entry> &users)
             // a structure containing the size of the packet data that soon arrives is sent to
             //  pc from our device, let's parse the duplicated, God knows why size...
             u32 l = *((u32*)(rcv.payload.data + 1));
-            if (!Data_Ready(machine_num, l))
+            FREE_BUF(rcv.payload.data);
+
+            if ( (ret = Data_Ready(machine_num, l)) < 0)
             {
-                // at this point machine should respond with CMD_DATA and 
-                //  the logs, followed by CMD_ACK_OK to terminate transmission
-                FREE_BUF(rcv.payload.data);
-                if (Get_Response(machine_num, rq[machine_num].reply_num, rcv) < 0)
-                    return -1;
-                
-                if (RNTOHS(rcv.payload.command_id) == CMD_DATA)
-                {
-                    u32 len = *((u32*)rcv.payload.data) / sizeof(Attendance_Entry);
-                    User_Entry_Ptr pusr = (User_Entry_Ptr)(rcv.payload.data + 4);
-                    u32 i = 0;
-                    while (i++ < len) 
-                    {
-                        User_Entry user = *pusr;
-                        users.push_back(user);
-                        pusr = (User_Entry_Ptr)((rcv.payload.data + 4) + (i * sizeof(User_Entry)));
-                    } // end while
-                } // end if Deja vu
+                Refresh(machine_num, CMD_FREE_DATA);
+                return ret;
+            } // end if
 
+            // at this point machine should respond with CMD_DATA and 
+            //  the logs, followed by CMD_ACK_OK to terminate transmission
+            if (Get_Response(machine_num, Dev(machine_num).reply_num, rcv) < 0)
+                return -1;
+            
+            if (RNTOHS(rcv.payload.command_id) != CMD_DATA)
+            {
+                Dev(machine_num).err = "Device sent " + std::to_string(RNTOHS(rcv.payload.command_id)) + 
+                    " in place of the user table";
                 FREE_BUF(rcv.payload.data);
-                if (Get_Response(machine_num, rq[machine_num].reply_num, rcv) < 0)
-                    return -1;
-
-                RSP_OK(rcv.payload.command_id, machine_num);
-                if (Refresh(machine_num, CMD_FREE_DATA) < 0)
-                    return -1;
+                Refresh(machine_num, CMD_FREE_DATA);
+                return -2;
             } // end if
+
+            hash = Hash_Block(rcv.payload.data, 4 + *((u32*)rcv.payload.data));
+            if (known_hash && hash == known_hash)
+                ret = 1;
+            else
+                Parse_Users(rcv.payload.data, fetched);
+
+            FREE_BUF(rcv.payload.data);
+            if (Get_Response(machine_num, Dev(machine_num).reply_num, rcv) < 0)
+                return -1;
+
+            RSP_OK(rcv.payload.command_id, machine_num);
+            if (Refresh(machine_num, CMD_FREE_DATA) < 0)
+                return -1;
         } break;
 
         default:
-            rq[machine_num].err = "Device returned error code: " + std::to_string(RNTOHS(rcv.payload.command_id));
+            Dev(machine_num).err = "Device returned error code: " + std::to_string(RNTOHS(rcv.payload.command_id));
+            FREE_BUF(rcv.payload.data);
             return -2;
     } // end switch
 
     FREE_BUF(rcv.payload.data);
-    return Enable_Device(machine_num);
+
+    // the table came whole; only now is it let out
+    Dev(machine_num).users_hash = hash;
+    if (phash)
+        *phash = hash;
+
+    if (users.empty())
+        users.swap(fetched);
+    else
+        users.insert(users.end(), fetched.begin(), fetched.end());
+
+    return ret;
+} // end Fetch_Users
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Returns the entire she-bang of users stored in the device.
+ * 
+ * @param [machine_num] the device identifer 
+ * @param [users] vector of user infos
+ *  
+ * @return int 
+ *  0 on success alas -1 on fail
+ */
+int Read_All_UserIDs(const int machine_num, std::vector<User_Entry> &users)
+{
+    int ret;
+
+    std::unique_ptr<Adm_Ticket> ticket;
+    if ( (ret = Admit_Transfer(machine_num, true, ticket)) < 0)
+        return ret;
+
+    if (Hold_Device(machine_num) < 0)
+        return -1;
+
+    if ( (ret = Fetch_Users(machine_num, users, 0, nullptr)) < 0)
+    {
+        Release_Device(machine_num);
+        return ret;
+    } // end if
+
+    return Release_Device(machine_num);
 } // end Read_All_UserIDs
 
 
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Like Read_All_UserIDs but only parses the table when it has changed; hash is the fingerprint the caller got
+ *  the last time around (0 the first time) and is updated to the one just downloaded. When the two agree the
+ *  table is the same byte for byte, users is left untouched and the caller can skip whatever diffing it does
+ *  downstream. Catches the edits (renames, permissions, ...) the counters of Get_Device_Status miss.
+ * 
+ * @param [machine_num] the device identifer 
+ * @param [users] gets the user infos when changed
+ * @param [hash] in the last known fingerprint, out the current one
+ *  
+ * @return int 
+ *  0 when changed and parsed, 1 when unchanged alas -ve on fail
+ */
+int Read_Changed_UserIDs(const int machine_num, std::vector<User_Entry> &users, u64 &hash)
+{
+    int ret;
+
+    std::unique_ptr<Adm_Ticket> ticket;
+    if ( (ret = Admit_Transfer(machine_num, true, ticket)) < 0)
+        return ret;
+
+    if (Hold_Device(machine_num) < 0)
+        return -1;
+
+    if ( (ret = Fetch_Users(machine_num, users, hash, &hash)) < 0)
+    {
+        Release_Device(machine_num);
+        return ret;
+    } // end if
+
+    if (Release_Device(machine_num) < 0)
+        return -1;
+
+    return ret;
+} // end Read_Changed_UserIDs
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Returns the fingerprint of the user table as of the last download (see Read_Changed_UserIDs); 0 if the table
+ *  was never downloaded on this connection.
+ * 
+ * @param [machine_num] the device identifer 
+ *  
+ * @return u64 
+ *  the fingerprint
+ */
+u64 User_Table_Hash(const int machine_num)
+{
+    return Dev(machine_num).users_hash;
+} // end User_Table_Hash
+
+
 //==============================================================================================================|
 /**
  * @brief 
@@ -614,6 +1135,7 @@ int Read_All_UserIDs(const int machine_num, std::vector<User_Entry> &users)
  */
 int Data_Ready(const int machine_num, const u32 dlen)
 {
+    DEVICE_LOCK(machine_num);
     struct rdy_struct 
     {
         u32 pad{0};
@@ -622,14 +1144,14 @@ int Data_Ready(const int machine_num, const u32 dlen)
 
     rdy_struct rdy{0, dlen};
     Zkt_Packet snd, rcv;
-    u16 rpnum = rq[machine_num].reply_num;
+    u16 rpnum = Dev(machine_num).reply_num;
     snd.payload.data = (u8*)&rdy;
-    ACT(machine_num, snd, rcv, CMD_DATA_RDY, rq[machine_num].session_id, rpnum,
+    ACT(machine_num, snd, rcv, CMD_DATA_RDY, Dev(machine_num).session_id, rpnum,
         Checksum(&snd.payload, (u16*)&rdy, sizeof(rdy) >> 1), sizeof(rdy));
 
     if (RNTOHS(rcv.payload.command_id) != CMD_PREPARE_DATA)
     {
-        rq[machine_num].err = "Device not ready to send data, returned: " + std::to_string(RNTOHS(rcv.payload.command_id));
+        Dev(machine_num).err = "Device not ready to send data, returned: " + std::to_string(RNTOHS(rcv.payload.command_id));
         FREE_BUF(rcv.payload.data);
         return -2;
     } // end if
@@ -642,7 +1164,8 @@ int Data_Ready(const int machine_num, const u32 dlen)
 //==============================================================================================================|
 /**
  * @brief 
- *  Returns the entire shebang of attendance record stored in the machine since time
+ *  Downloads the attendance log into entry; this is the body of Read_Attendance_Record minus admission and the
+ *  disabling and enabling of device, so that callers can bracket more work within the same disabled window.
  * 
  * @param [machine_num] the machine identifier
  * @param [entry] a vector of attendance entries
@@ -650,7 +1173,7 @@ int Data_Ready(const int machine_num, const u32 dlen)
  * @return int 
  *  a success 0 or -ve on fail
  */
-int Read_Attendance_Record(const int machine_num, std::vector<Attendance_Entry> &entry)
+static int Fetch_Attendance(const int machine_num, std::vector<Attendance_Entry> &entry)
 {
     // this a copy pasted version of the Read_User_Info (real programmers plz don't kill me!)
     Zkt_Packet snd, rcv;
@@ -658,14 +1181,13 @@ int Read_Attendance_Record(const int machine_num, std::vector<Attendance_Entry>
     // the meaining of these values have not yet been deciphered ...
     u8 dat[11]{0x01, 0x0d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
     
-    Disable_Device(machine_num);
-    u16 rnum = rq[machine_num].reply_num;
+    u16 rnum = Dev(machine_num).reply_num;
 
     snd.payload.data = dat;
-    ACT(machine_num, snd, rcv, CMD_DATA_WRRQ, rq[machine_num].session_id, 
+    ACT(machine_num, snd, rcv, CMD_DATA_WRRQ, Dev(machine_num).session_id, 
         rnum, Checksum(&snd.payload, (u16*)&dat, 5), 11);
     
-    ++rq[machine_num].reply_num;
+    ++Dev(machine_num).reply_num;
     switch (RHTONS(rcv.payload.command_id)) 
     {
         case CMD_DATA:      // data has been appeneded to this response
@@ -690,51 +1212,187 @@ int Read_Attendance_Record(const int machine_num, std::vector<Attendance_Entry>
             // a structure containing the size of the packet data that soon arrives is sent to
             //  pc from our device, let's parse the duplicated, God knows why size...
             u32 l = *((u32*)(rcv.payload.data + 1));
-            if (!Data_Ready(machine_num, l))
+            FREE_BUF(rcv.payload.data);
+
+            // a log that never came is not an empty log; the caller must not take it for one
+            int ret;
+            if ( (ret = Data_Ready(machine_num, l)) < 0)
+            {
+                Refresh(machine_num, CMD_FREE_DATA);
+                return ret;
+            } // end if
+
+            // at this point machine should respond with CMD_DATA and 
+            //  the logs, followed by CMD_ACK_OK to terminate transmission
+            if (Get_Response(machine_num, Dev(machine_num).reply_num, rcv) < 0)
+                return -1;
+            
+            if (RNTOHS(rcv.payload.command_id) != CMD_DATA)
             {
-                // at this point machine should respond with CMD_DATA and 
-                //  the logs, followed by CMD_ACK_OK to terminate transmission
+                Dev(machine_num).err = "Device sent " + std::to_string(RNTOHS(rcv.payload.command_id)) + 
+                    " in place of the attendance log";
                 FREE_BUF(rcv.payload.data);
-                if (Get_Response(machine_num, rq[machine_num].reply_num, rcv) < 0)
-                    return -1;
-                
-                if (RNTOHS(rcv.payload.command_id) == CMD_DATA)
-                {
-                    u32 len = *((u32*)rcv.payload.data) / sizeof(Attendance_Entry);
-                    Attendance_Entry_Ptr patt = (Attendance_Entry_Ptr)(rcv.payload.data + 4);
-                    u32 i = 0;
-                    while (i++ < len) 
-                    {
-                        if (patt->att_time == 0)
-                            continue;
+                Refresh(machine_num, CMD_FREE_DATA);
+                return -2;
+            } // end if
 
-                        Attendance_Entry att = *patt;
-                        entry.push_back(att);
-                        patt = (Attendance_Entry_Ptr)((rcv.payload.data + 4) + (i * sizeof(Attendance_Entry)));
+            u32 len = *((u32*)rcv.payload.data) / sizeof(Attendance_Entry);
+            u32 i;
+            for (i = 0; i < len; i++) 
+            {
+                // blank slots are skipped; the pointer is recomputed on every pass so
+                //  that skipping one does not stall the walk on the same entry
+                Attendance_Entry_Ptr patt = (Attendance_Entry_Ptr)((rcv.payload.data + 4) + 
+                    (i * sizeof(Attendance_Entry)));
+                if (patt->att_time == 0)
+                    continue;
 
-                    } // end while
-                } // end if Deja vu
+                Attendance_Entry att = *patt;
+                entry.push_back(att);
+            } // end for
 
-                FREE_BUF(rcv.payload.data);
-                if (Get_Response(machine_num, rq[machine_num].reply_num, rcv) < 0)
-                    return -1;
+            FREE_BUF(rcv.payload.data);
+            if (Get_Response(machine_num, Dev(machine_num).reply_num, rcv) < 0)
+                return -1;
 
-                RSP_OK(rcv.payload.command_id, machine_num);
-                if (Refresh(machine_num, CMD_FREE_DATA) < 0)
-                    return -1;
-            } // end if
+            RSP_OK(rcv.payload.command_id, machine_num);
+            if (Refresh(machine_num, CMD_FREE_DATA) < 0)
+                return -1;
         } break;
 
         default:
-            rq[machine_num].err = "Device returned error code: " + std::to_string(RNTOHS(rcv.payload.command_id));
+            Dev(machine_num).err = "Device returned error code: " + std::to_string(RNTOHS(rcv.payload.command_id));
+            FREE_BUF(rcv.payload.data);
             return -2;
     } // end switch
 
     FREE_BUF(rcv.payload.data);
-    return Enable_Device(machine_num);
+    return 0;
+} // end Fetch_Attendance
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Returns the entire shebang of attendance record stored in the machine since time
+ * 
+ * @param [machine_num] the machine identifier
+ * @param [entry] a vector of attendance entries
+ *  
+ * @return int 
+ *  a success 0 or -ve on fail
+ */
+int Read_Attendance_Record(const int machine_num, std::vector<Attendance_Entry> &entry)
+{
+    int ret;
+
+    std::unique_ptr<Adm_Ticket> ticket;
+    if ( (ret = Admit_Transfer(machine_num, false, ticket)) < 0)
+        return ret;
+
+    if (Hold_Device(machine_num) < 0)
+        return -1;
+
+    if ( (ret = Fetch_Attendance(machine_num, entry)) < 0)
+    {
+        Release_Device(machine_num);
+        return ret;
+    } // end if
+
+    return Release_Device(machine_num);
 } // end Read_Attendance_Record
 
 
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Downloads the attendance log, hands it over to the commit callback for durable storage and then clears the
+ *  log on the device; this keeps the device log (and thus every download after) bounded in size. The whole
+ *  sequence runs while the device is disabled, so no punch can be recorded between the download and the clear,
+ *  i.e. nothing that arrives mid-sync is ever wiped without having been downloaded first. The log is cleared only
+ *  when the count and checksum reported by the callback match the downloaded records.
+ * 
+ * @param [machine_num] the machine identifier
+ * @param [entry] gets the downloaded attendance entries
+ * @param [commit] callback that persists the entries and reports back what it stored
+ * @param [arg] user argument passed along to the callback
+ *  
+ * @return int 
+ *  a 0 on success, -1 on fail, -2 on device error and -3 if the callback's report does not match; in which case
+ *  the device log is left as is
+ */
+int Read_Clear_Attendance(const int machine_num, std::vector<Attendance_Entry> &entry, pfn_Att_Commit commit, 
+    void *arg)
+{
+    u32 count{0}, checksum{0};
+    int ret;
+
+    if (!commit)
+        return -1;
+
+    std::unique_ptr<Adm_Ticket> ticket;
+    if ( (ret = Admit_Transfer(machine_num, false, ticket)) < 0)
+        return ret;
+
+    if (Hold_Device(machine_num) < 0)
+        return -1;
+
+    if ( (ret = Fetch_Attendance(machine_num, entry)) < 0)
+    {
+        Release_Device(machine_num);
+        return ret;
+    } // end if
+
+    // nothing to store nothing to clear
+    if (entry.empty())
+        return Release_Device(machine_num);
+
+    if ( (ret = commit(machine_num, entry, &count, &checksum, arg)) < 0)
+    {
+        Dev(machine_num).err = "Attendance commit failed, device log kept";
+        Release_Device(machine_num);
+        return ret;
+    } // end if
+
+    if (count != entry.size() || checksum != Att_Checksum(entry.data(), entry.size()))
+    {
+        Dev(machine_num).err = "Attendance commit mismatch; stored " + std::to_string(count) + " of " + 
+            std::to_string(entry.size()) + " records, device log kept";
+        Release_Device(machine_num);
+        return -3;
+    } // end if
+
+    if ( (ret = Clear_Attendance_Log(machine_num)) < 0)
+    {
+        Release_Device(machine_num);
+        return ret;
+    } // end if
+
+    return Release_Device(machine_num);
+} // end Read_Clear_Attendance
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Clears all attendance records stored on the device; see Read_Clear_Attendance for the safe way of doing it.
+ * 
+ * @param [machine_num] the machine identifier
+ *  
+ * @return int 
+ *  0 on success alas -ve on fail
+ */
+int Clear_Attendance_Log(const int machine_num)
+{
+    DEVICE_LOCK(machine_num);
+    ACT_NODATA(machine_num, CMD_CLEAR_ATTLOG);
+    if (Refresh(machine_num) < 0)
+        return -1;
+
+    return 0;
+} // end Clear_Attendance_Log
+
+
 //==============================================================================================================|
 /**
  * @brief 
@@ -748,7 +1406,9 @@ int Read_Attendance_Record(const int machine_num, std::vector<Attendance_Entry>
  */
 int Delete_User(const int machine_num, const u16 user_sn)
 {
+    DEVICE_LOCK(machine_num);
     ACT_INDATA(machine_num, CMD_DELETE_USER, &user_sn, sizeof(user_sn));  
+    Cache_Drop_User(machine_num, user_sn);
     if (Refresh(machine_num) < 0)
         return -1;
 
@@ -759,18 +1419,20 @@ int Delete_User(const int machine_num, const u16 user_sn)
 //==============================================================================================================|
 /**
  * @brief 
- *  Register's the system for reception of real time signals that originate from the device; right now I'm only
- *  interested in the attendance transaction.
+ *  Register's the system for reception of real time signals that originate from the device; the device only
+ *  pushes the events in mask, so pass what's actually consumed (Event_Wanted_Mask() tells what the event bus
+ *  subscribers are after).
  * 
  * @param [machine_num] machine descriptor 
- * @param [options] regstration options default we listen only AttendanceTransaction 0x0000ffff}; 
- *      0x0000ffff = all, 1 = Attendance transaction
+ * @param [mask] the events to register for; default we listen only to attendance transactions
  * 
  * @return int 
  *  0 on success -1 on fail
  */
-int Init_Realtime(const int machine_num, const u32 options)
+int Init_Realtime(const int machine_num, const Realtime_Mask mask)
 {  
+    DEVICE_LOCK(machine_num);
+    u32 options{mask};
     ACT_INDATA(machine_num, CMD_REG_EVENT, &options, sizeof(options));
     return 0;
 } // end Start_Realtime
@@ -789,16 +1451,120 @@ int Init_Realtime(const int machine_num, const u32 options)
  */
 int Set_User_Info(const int machine_num, User_Entry_Ptr puser)
 {
-    if (Disable_Device(machine_num) < 0)
+    std::vector<int> status;
+
+    // a batch of one; saves us from keeping two copies of the same dance
+    int ret = Set_User_Info_Batch(machine_num, std::vector<User_Entry>{*puser}, status);
+    if (ret > 0)
+        return -2;      // device said no
+
+    return ret;
+} // end Set_User_Info
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Writes a whole batch of users; the device is disabled once, the writes are streamed back to back (see
+ *  Send_Pipelined) and a single refresh closes off the batch, so the time taken goes with the bytes sent rather
+ *  than the round trips. Users the device accepted are put into the user cache.
+ * 
+ * @param [machine_num] the machine identifier
+ * @param [users] the users to write
+ * @param [status] gets per user 0 for written or -ve if the device refused it
+ * @param [brefresh] false leaves the refresh to the caller, e.g. when more writes follow
+ * 
+ * @return int 
+ *  the number of users the device refused, -1 on fail
+ */
+int Set_User_Info_Batch(const int machine_num, const std::vector<User_Entry> &users, std::vector<int> &status,
+    const bool brefresh)
+{
+    int failed;
+
+    status.assign(users.size(), -1);
+    if (users.empty())
+        return 0;
+
+    if (Hold_Device(machine_num) < 0)
         return -1;
 
-    ACT_INDATA(machine_num, CMD_USER_WRQ, puser, sizeof(User_Entry));
+    if ( (failed = Send_Pipelined(machine_num, CMD_USER_WRQ, users.data(), sizeof(User_Entry), 
+        (u32)users.size(), status)) < 0)
+    {
+        Release_Device(machine_num);
+        return -1;
+    } // end if
 
-    if (Refresh(machine_num) < 0)
+    for (size_t i = 0; i < users.size(); i++)
+    {
+        if (!status[i])
+            Cache_Put_User(machine_num, users[i]);
+    } // end for
+
+    if (brefresh && Refresh(machine_num) < 0)
+    {
+        Release_Device(machine_num);
         return -1;
+    } // end if
 
-    return Enable_Device(machine_num);
-} // end Set_User_Info
+    if (Release_Device(machine_num) < 0)
+        return -1;
+
+    return failed;
+} // end Set_User_Info_Batch
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Deletes a whole batch of users by serial; the device is disabled once, the deletes are streamed back to back
+ *  and a single refresh closes off the batch. Users the device deleted are dropped from the user cache.
+ * 
+ * @param [machine_num] the machine identifier
+ * @param [serials] the user serial numbers
+ * @param [status] gets per serial 0 for deleted or -ve if the device refused it
+ * @param [brefresh] false leaves the refresh to the caller
+ * 
+ * @return int 
+ *  the number of deletes the device refused, -1 on fail
+ */
+int Delete_User_Batch(const int machine_num, const std::vector<u16> &serials, std::vector<int> &status,
+    const bool brefresh)
+{
+    int failed;
+
+    status.assign(serials.size(), -1);
+    if (serials.empty())
+        return 0;
+
+    if (Hold_Device(machine_num) < 0)
+        return -1;
+
+    if ( (failed = Send_Pipelined(machine_num, CMD_DELETE_USER, serials.data(), sizeof(u16), 
+        (u32)serials.size(), status)) < 0)
+    {
+        Release_Device(machine_num);
+        return -1;
+    } // end if
+
+    for (size_t i = 0; i < serials.size(); i++)
+    {
+        if (!status[i])
+            Cache_Drop_User(machine_num, serials[i]);
+    } // end for
+
+    if (brefresh && Refresh(machine_num) < 0)
+    {
+        Release_Device(machine_num);
+        return -1;
+    } // end if
+
+    if (Release_Device(machine_num) < 0)
+        return -1;
+
+    return failed;
+} // end Delete_User_Batch
 
 
 //==============================================================================================================|
@@ -813,6 +1579,7 @@ int Set_User_Info(const int machine_num, User_Entry_Ptr puser)
  */
 int Restart_Device(const int machine_num)
 {
+    DEVICE_LOCK(machine_num);
     ACT_NODATA(machine_num, CMD_RESTART);
     Disconnect_Net(machine_num);
 
@@ -834,6 +1601,7 @@ int Restart_Device(const int machine_num)
  */
 int Enroll_User(const int machine_num, const Enroll_Data &enroll)
 {
+    DEVICE_LOCK(machine_num);
     std::string query[]{{"~PIN2Width\x00"}, {"~IsABCPinEnable\x00"}};
     std::string result{""};
 
@@ -850,7 +1618,7 @@ int Enroll_User(const int machine_num, const Enroll_Data &enroll)
         if (ret == -1)
             return -1;
         else if (ret == -2) {
-            rq[machine_num].err = "Device does not support alphanumeric keys. Digits only allowed";
+            Dev(machine_num).err = "Device does not support alphanumeric keys. Digits only allowed";
         } // end else if
     } // end if
 
@@ -877,6 +1645,7 @@ int Enroll_User(const int machine_num, const Enroll_Data &enroll)
  */
 int Enable_Device(const int machine_num)
 {
+    DEVICE_LOCK(machine_num);
     ACT_NODATA(machine_num, CMD_ENABLE_DEVICE);
     return 0;
 } // end Enable_Device
@@ -894,11 +1663,71 @@ int Enable_Device(const int machine_num)
  */
 int Disable_Device(const int machine_num)
 {
+    DEVICE_LOCK(machine_num);
     ACT_NODATA(machine_num, CMD_DISABLE_DEVICE);
     return 0;
 } // end Enable_Device
 
 
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Takes hold of the device for a bulk operation; the device is only disabled on the first hold, so operations
+ *  run within a Maintenance_Session (or one another) don't toggle it over and over. The hold also keeps the
+ *  device's command lock, thus commands from other threads wait until the last hold is let go; release from
+ *  the thread that took the hold.
+ * 
+ * @param [machine_num] the machine identifier
+ *  
+ * @return int 
+ *  0 on success alas -ve on fail
+ */
+int Hold_Device(const int machine_num)
+{
+    Driver_Info &dev = Dev(machine_num);
+
+    dev.pop_lock->lock();       // kept till the matching Release_Device
+    if (dev.hold_count++ > 0)
+        return 0;
+
+    int ret = Disable_Device(machine_num);
+    if (ret < 0)
+    {
+        --dev.hold_count;
+        dev.pop_lock->unlock();
+    } // end if
+
+    return ret;
+} // end Hold_Device
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Lets go of a hold taken with Hold_Device; the device is enabled back when the last hold is let go.
+ * 
+ * @param [machine_num] the machine identifier
+ *  
+ * @return int 
+ *  0 on success alas -ve on fail
+ */
+int Release_Device(const int machine_num)
+{
+    Driver_Info &dev = Dev(machine_num);
+    DEVICE_LOCK(machine_num);
+
+    if (!dev.hold_count)
+        return 0;
+
+    int ret{0};
+    if (--dev.hold_count == 0)
+        ret = Enable_Device(machine_num);
+
+    dev.pop_lock->unlock();     // the one Hold_Device took
+    return ret;
+} // end Release_Device
+
+
 //==============================================================================================================|
 /**
  * @brief 
@@ -911,6 +1740,7 @@ int Disable_Device(const int machine_num)
  */
 int Clear_Admins(const int machine_num)
 {
+    DEVICE_LOCK(machine_num);
     ACT_NODATA(machine_num, CMD_CLEAR_ADMIN);
     return 0;
 } // end Clear_Admins
@@ -928,6 +1758,7 @@ int Clear_Admins(const int machine_num)
  */
 int Enable_Clock(const int machine_num)
 {
+    DEVICE_LOCK(machine_num);
     ACT_NODATA(machine_num, CMD_ENABLE_CLOCK);
     return 0;
 } // end Enable_Clock
@@ -945,6 +1776,7 @@ int Enable_Clock(const int machine_num)
  */
 int Start_Identify(const int machine_num)
 {
+    DEVICE_LOCK(machine_num);
     ACT_NODATA(machine_num, CMD_STARTVERIFY);
     return 0;
 } // end Start_Identify
@@ -962,6 +1794,7 @@ int Start_Identify(const int machine_num)
  */
 int Cancel_Operation(const int machine_num)
 {
+    DEVICE_LOCK(machine_num);
     ACT_NODATA(machine_num, CMD_CANCELCAPTURE);
     return 0;
 } // end Cancel_Operation
@@ -979,6 +1812,7 @@ int Cancel_Operation(const int machine_num)
  */
 int Power_Off(const int machine_num)
 {
+    DEVICE_LOCK(machine_num);
     ACT_NODATA(machine_num, CMD_POWEROFF);
     Disconnect_Net(machine_num);
     return 0;
@@ -999,13 +1833,14 @@ int Power_Off(const int machine_num)
  */
 int Read_Machine_Config(const int machine_num, const std::string &query, std::string &result)
 {
+    DEVICE_LOCK(machine_num);
     Zkt_Packet snd, rcv;
-    u16 rnum = rq[machine_num].reply_num;
+    u16 rnum = Dev(machine_num).reply_num;
 
-    ACT(machine_num, snd, rcv, CMD_OPTIONS_RRQ, rq[machine_num].session_id, 
+    ACT(machine_num, snd, rcv, CMD_OPTIONS_RRQ, Dev(machine_num).session_id, 
         rnum, Checksum(&snd.payload, (u16*)query.c_str(), query.length() / 2), query.length());
 
-    ++rq[machine_num].reply_num;
+    ++Dev(machine_num).reply_num;
     if (rcv.payload.command_id == CMD_ACK_ERROR)
         return -2;      // whatever is requested not supported
 
@@ -1107,6 +1942,57 @@ inline bool Alphanumeric_Support(const std::string &str)
 } // end Alphanumeric_Support
 
 
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Computes a 32-bit FNV-1a checksum over the raw attendance entries; used to confirm that what got stored
+ *  locally is byte for byte what was downloaded from the device.
+ * 
+ * @param [patt] pointer to the first attendance entry
+ * @param [count] number of entries
+ * 
+ * @return u32
+ *  the checksum
+ */
+u32 Att_Checksum(const Attendance_Entry *patt, const size_t count)
+{
+    const u8 *p = (const u8 *)patt;
+    size_t len = count * sizeof(Attendance_Entry);
+    u32 hash = 0x811C9DC5;
+
+    while (len--) 
+    {
+        hash ^= *p++;
+        hash *= 0x01000193;
+    } // end while
+
+    return hash;
+} // end Att_Checksum
+
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Encodes a date and time the way the device keeps them (see DECODE_DATE); every month counts 31 days and
+ *  every year 12 such months, which makes the result grow with time even if it's not a count of seconds.
+ * 
+ * @param [yr] the year in full, 2000 onwards
+ * @param [mon] the month 1 - 12
+ * @param [day] the day 1 - 31
+ * @param [hr] the hour 0 - 23
+ * @param [min] the minute 0 - 59
+ * @param [sec] the second 0 - 59
+ * 
+ * @return u32
+ *  the encoded time, good for Set_Time
+ */
+u32 Encode_Time(const u32 yr, const u32 mon, const u32 day, const u32 hr, const u32 min, const u32 sec)
+{
+    u32 days = ((yr - 2000) * 12 + (mon - 1)) * 31 + (day - 1);
+    return ((days * 24 + hr) * 60 + min) * 60 + sec;
+} // end Encode_Time
+
+
 //==============================================================================================================|
 /**
  * @brief 
@@ -21,6 +21,7 @@
 #include "utils.h"
 #include "global-errors.h"
 #include "zkteco-driver.h"
+#include "event-bus.h"
 
 
 using namespace std;
@@ -37,6 +38,34 @@ APP_CONFIG config;          // an application configuration info
 
 //==============================================================================================================|
 // FUNCTIONS
+//==============================================================================================================|
+/**
+ * @brief 
+ *  Event bus handler; prints the punches the device streams in realtime.
+ * 
+ * @param [precs] a batch of events
+ * @param [count] the number of events in the batch
+ * @param [arg] not used
+ */
+static void Print_Punches(const Event_Record *precs, const size_t count, void *arg)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (precs[i].event != EF_ATTLOG || !precs[i].bdecoded)
+            continue;
+
+        const Event_Att *patt = (const Event_Att*)precs[i].data;
+        u32 t = patt->att_time;
+
+        cout << "Realtime punch on " << precs[i].machine_num
+            << "\nUser Id: " << patt->user_id
+            << "\nRecord time: " << (t / 86400 / 31 % 12 + 1) << "/" << (t / 86400 % 31 + 1) << "/"
+            << (t / 86400 / 31 / 12 + 2000) << " " << (t / 3600 % 24) << ":" << (t / 60 % 60) << ":" << (t % 60)
+            << "\n---------------------------------" << endl;
+    } // end for
+} // end Print_Punches
+
+
 //==============================================================================================================|
 /**
  * @brief 
@@ -77,6 +106,7 @@ int main(int argc, char **argv)
         Fatal("ZKT eco connection error");
         
     cout << "Return of the Jedi" << endl;
+    Event_Subscribe(Print_Punches, nullptr, RT_ATTLOG);
     Init_Realtime(0);
 
     //Delete_User(0, 1);
@@ -49,7 +49,7 @@ pfn_Recv fn_Recv;
  */
 Client::Client(const int protocol)
     : fds{-1}, paddr{nullptr}, ss_len{0},
-      delaytcp{0}, keep_alive{0}
+      delaytcp{0}, keep_alive{0}, recv_timeout{0}
 {
     FD_ZERO(&rset); // clear
 
@@ -151,7 +151,11 @@ int Client::Disconnect()
  */
 int Client::Set_Recv_Timeout(int sec)
 {
-    return Set_RecvTimeout(fds, sec);
+    if (Set_RecvTimeout(fds, sec) < 0)
+        return -1;
+
+    recv_timeout = sec;
+    return 0;
 } // end Set_Recv_Timeout
 
 
@@ -198,6 +202,19 @@ int Client::Get_Socket()
 } // end Get_Socket
 
 
+//==============================================================================================================|
+/**
+ * @brief 
+ *  return's the receive timeout in seconds as set by Set_Recv_Timeout; 0 if never set
+ * 
+ * @return int 
+ */
+int Client::Get_Recv_Timeout()
+{
+    return recv_timeout;
+} // end Get_Recv_Timeout
+
+
 //==============================================================================================================|
 /**
  * @brief 
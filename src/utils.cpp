@@ -207,6 +207,157 @@ void Dump_Hex(const char *p_buf, const size_t len)
     printf("\n");
 } // end Dump_Hex
 
+//==============================================================================================================|
+/**
+ * @brief 
+ *  A fast 64-bit hash over a block of memory; good for telling whether a large blob has changed, not for
+ *  anything cryptographic. The block is eaten 32 bytes at a time by four independent lanes that never depend
+ *  on each other, so the CPU keeps all four multiplies in flight at once; the lanes get folded at the end and
+ *  the tail is mixed in 8 and then 1 byte at a time.
+ * 
+ * @param p_buf 
+ *  the block to hash
+ * @param len 
+ *  length of the block in bytes
+ * @param seed 
+ *  starting value; different seeds give unrelated hashes
+ * 
+ * @return u64 
+ *  the hash
+ */
+u64 Hash_Block(const void *p_buf, const size_t len, const u64 seed)
+{
+    const u64 p1 = 0x9E3779B185EBCA87ULL;
+    const u64 p2 = 0xC2B2AE3D27D4EB4FULL;
+    const u64 p3 = 0x165667B19E3779F9ULL;
+
+    const u8 *p = (const u8 *)p_buf;
+    const u8 *end = p + len;
+    u64 h, w;
+
+#define ROTL64(x, r)    (((x) << (r)) | ((x) >> (64 - (r))))
+#define LANE(acc, in)   { acc += (in) * p2; acc = ROTL64(acc, 31); acc *= p1; }
+
+    if (len >= 32)
+    {
+        u64 v1 = seed + p1 + p2, v2 = seed + p2, v3 = seed, v4 = seed - p1;
+        u64 in[4];
+
+        do {
+            iCpy(in, p, sizeof(in));
+            LANE(v1, RNTOHLL(in[0]));
+            LANE(v2, RNTOHLL(in[1]));
+            LANE(v3, RNTOHLL(in[2]));
+            LANE(v4, RNTOHLL(in[3]));
+            p += 32;
+        } while (p + 32 <= end);
+
+        h = ROTL64(v1, 1) + ROTL64(v2, 7) + ROTL64(v3, 12) + ROTL64(v4, 18);
+        LANE(v1, 0); h ^= v1; h = h * p1 + p3;
+        LANE(v2, 0); h ^= v2; h = h * p1 + p3;
+        LANE(v3, 0); h ^= v3; h = h * p1 + p3;
+        LANE(v4, 0); h ^= v4; h = h * p1 + p3;
+    } // end if
+    else
+        h = seed + p3;
+
+    h += (u64)len;
+    while (p + 8 <= end)
+    {
+        iCpy(&w, p, 8);
+        u64 k = 0;
+        LANE(k, RNTOHLL(w));
+        h ^= k;
+        h = ROTL64(h, 27) * p1 + p3;
+        p += 8;
+    } // end while
+
+    while (p < end)
+    {
+        h ^= (*p++) * p3;
+        h = ROTL64(h, 11) * p1;
+    } // end while
+
+#undef LANE
+#undef ROTL64
+
+    // final avalanche
+    h ^= h >> 33;
+    h *= p2;
+    h ^= h >> 29;
+    h *= p3;
+    h ^= h >> 32;
+
+    return h;
+} // end Hash_Block
+
+//==============================================================================================================|
+/**
+ * @brief 
+ *  The standard (IEEE, reflected) CRC-32 over a block of memory, sliced by 8: eight lookup tables let each
+ *  round eat 8 bytes with independent loads instead of one byte per dependent step. Pass the CRC of the blocks
+ *  before to carry on over several of them.
+ * 
+ * @param p_buf 
+ *  the block to check
+ * @param len 
+ *  length of the block in bytes
+ * @param crc 
+ *  the CRC so far; 0 to start
+ * 
+ * @return u32 
+ *  the CRC
+ */
+u32 Crc32(const void *p_buf, const size_t len, const u32 crc)
+{
+    struct Tables
+    {
+        u32 t[8][256];
+
+        Tables()
+        {
+            for (u32 i = 0; i < 256; i++)
+            {
+                u32 c = i;
+                for (int k = 0; k < 8; k++)
+                    c = (c & 1) ? (c >> 1) ^ 0xEDB88320U : c >> 1;
+                t[0][i] = c;
+            } // end for
+
+            for (u32 i = 0; i < 256; i++)
+            {
+                for (int k = 1; k < 8; k++)
+                    t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xff];
+            } // end for
+        } // end Tables
+    };
+
+    static const Tables tables;
+    const u32 (*t)[256] = tables.t;
+    const u8 *p = (const u8 *)p_buf;
+    size_t n = len;
+    u32 c = ~crc;
+
+    while (n >= 8)
+    {
+        u32 lo, hi;
+        iCpy(&lo, p, 4);
+        iCpy(&hi, p + 4, 4);
+        lo = RNTOHL(lo) ^ c;
+        hi = RNTOHL(hi);
+
+        c = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+            t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+        p += 8;
+        n -= 8;
+    } // end while
+
+    while (n--)
+        c = (c >> 8) ^ t[0][(c ^ *p++) & 0xff];
+
+    return ~c;
+} // end Crc32
+
 //==============================================================================================================|
 //          THE END
 //==============================================================================================================|
\ No newline at end of file